@@ -0,0 +1,79 @@
+#include "Benchmark.hpp"
+#include "../src/Misc/Base64.hpp"
+
+#include <vector>
+
+
+namespace Real { namespace Bench {
+
+	/// Bytes per block: one small token, a line of PEM, blocks of text output.
+	static std::vector<uint64> Base64BlockSizes() { return { 48, 4096, 65536, 1 << 20 }; }
+
+	/// Random-looking bytes, so no digit is favored.
+	static std::vector<BYTE> MakeBase64Payload(uint64 size)
+	{
+		std::vector<BYTE> bytes(size);
+		uint32 state = 0x9E3779B9u;
+
+		for (BYTE& byte : bytes)
+		{
+			state = state * 1664525u + 1013904223u;
+			byte = static_cast<BYTE>(state >> 24);
+		}
+
+		return bytes;
+	}
+
+	/// Encoding to one line of Base64 ("--output-format=base64"), or to lines of PEM when the line length is given.
+	static void RunBase64Encode(BenchmarkState& state, SIZE_T line_length)
+	{
+		const std::vector<BYTE> bytes = MakeBase64Payload(state.GetArgument());
+		std::vector<BYTE> text(Base64::Encoder::GetMaxEncodedSize(bytes.size() + 2, line_length));
+
+		while (state.KeepRunning())
+		{
+			Base64::Encoder encoder(line_length);
+			const SIZE_T size = encoder.Encode(text.data(), bytes.data(), bytes.size());
+
+			DoNotOptimize(encoder.Finish(text.data() + size));
+			DoNotOptimize(text.data());
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * bytes.size());
+	}
+
+	/// Decoding of the same text ("--input-format=base64" and "--input-format=pem").
+	static void RunBase64Decode(BenchmarkState& state, SIZE_T line_length)
+	{
+		const std::vector<BYTE> bytes = MakeBase64Payload(state.GetArgument());
+		std::vector<BYTE> text(Base64::Encoder::GetMaxEncodedSize(bytes.size() + 2, line_length));
+		std::vector<BYTE> decoded(text.size());
+
+		Base64::Encoder encoder(line_length);
+		SIZE_T text_size = encoder.Encode(text.data(), bytes.data(), bytes.size());
+		text_size += encoder.Finish(text.data() + text_size);
+
+		while (state.KeepRunning())
+		{
+			Base64::Decoder decoder;
+			SIZE_T written;
+
+			DoNotOptimize(decoder.Decode(decoded.data(), text.data(), text_size, written));
+			DoNotOptimize(decoder.Finish(decoded.data() + written, written));
+			DoNotOptimize(decoded.data());
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * bytes.size());
+	}
+
+	static void BM_Base64Encode(BenchmarkState& state) { RunBase64Encode(state, 0); }
+	static void BM_Base64EncodePem(BenchmarkState& state) { RunBase64Encode(state, Base64::PemLineLength); }
+	static void BM_Base64Decode(BenchmarkState& state) { RunBase64Decode(state, 0); }
+	static void BM_Base64DecodePem(BenchmarkState& state) { RunBase64Decode(state, Base64::PemLineLength); }
+
+	REAL_BENCHMARK(BM_Base64Encode, Base64BlockSizes());
+	REAL_BENCHMARK(BM_Base64EncodePem, Base64BlockSizes());
+	REAL_BENCHMARK(BM_Base64Decode, Base64BlockSizes());
+	REAL_BENCHMARK(BM_Base64DecodePem, Base64BlockSizes());
+
+} }
@@ -0,0 +1,85 @@
+#include "Benchmark.hpp"
+#include "../src/Codecs/ASN1_Codec.h"
+
+#include <vector>
+
+
+namespace Real { namespace Bench {
+
+	using namespace Real::Codecs;
+	using namespace Real::Codecs::ASN1CodecOptions;
+
+	/// Payload size of every message in batch benchmarks.
+	constexpr uint64 BatchMessageSize = 64;
+
+	/// Messages per batch.
+	static std::vector<uint64> BatchSizes() { return { 1, 16, 256, 4096, 65536 }; }
+
+
+	/// One EncodeToken call (and its allocations) per message.
+	static void BM_EncodeTokenPerMessage(BenchmarkState& state)
+	{
+		const uint64 count = state.GetArgument();
+		std::vector<BYTE> payload(count * BatchMessageSize, 0x5a);
+
+		while (state.KeepRunning())
+		{
+			for (uint64 i = 0; i < count; ++i)
+			{
+				auto token = ASN1_Codec::EncodeToken(EASN1ValueType::OctetString, EASN1ClassTagType::UNIVERSAL, EASN1PCType::PRIMITIVE, payload.data() + i * BatchMessageSize, BatchMessageSize);
+				DoNotOptimize(token.GetContentBytes());
+			}
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * count * BatchMessageSize);
+		state.SetItemsProcessed(state.GetIterations() * count);
+	}
+
+	/// The same tokens taken from an arena that is reset after every batch, as a long-running worker would do.
+	static void BM_EncodeTokenArenaPerBatch(BenchmarkState& state)
+	{
+		const uint64 count = state.GetArgument();
+		std::vector<BYTE> payload(count * BatchMessageSize, 0x5a);
+		System::MonotonicArena arena;
+
+		while (state.KeepRunning())
+		{
+			for (uint64 i = 0; i < count; ++i)
+			{
+				auto token = ASN1_Codec::EncodeToken(EASN1ValueType::OctetString, EASN1ClassTagType::UNIVERSAL, EASN1PCType::PRIMITIVE, payload.data() + i * BatchMessageSize, BatchMessageSize, &arena);
+				DoNotOptimize(token.GetContentBytes());
+			}
+
+			arena.Reset();
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * count * BatchMessageSize);
+		state.SetItemsProcessed(state.GetIterations() * count);
+	}
+
+	/// Two-pass batch encoding into one reused buffer.
+	static void BM_EncodeOctetStringBatch(BenchmarkState& state)
+	{
+		const uint64 count = state.GetArgument();
+		std::vector<BYTE> payload(count * BatchMessageSize, 0x5a);
+		std::vector<ASN1_Codec::ConstBuffer> inputs(count);
+		std::vector<BYTE> output;
+
+		for (uint64 i = 0; i < count; ++i)
+			inputs[i] = { payload.data() + i * BatchMessageSize, BatchMessageSize };
+
+		while (state.KeepRunning())
+		{
+			ASN1_Codec::EncodeOctetStringBatch(inputs, EASN1ClassTagType::UNIVERSAL, output);
+			DoNotOptimize(output.data());
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * count * BatchMessageSize);
+		state.SetItemsProcessed(state.GetIterations() * count);
+	}
+
+	REAL_BENCHMARK(BM_EncodeTokenPerMessage, BatchSizes());
+	REAL_BENCHMARK(BM_EncodeTokenArenaPerBatch, BatchSizes());
+	REAL_BENCHMARK(BM_EncodeOctetStringBatch, BatchSizes());
+
+} }
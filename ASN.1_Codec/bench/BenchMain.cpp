@@ -0,0 +1,247 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <string>
+#include <cstdlib>
+#include <cstdio>
+#include <filesystem>
+#include <new>
+
+#include "Benchmark.hpp"
+#include "../src/Misc/CommandLine.h"
+
+#if defined(REAL_PLATFORM_WINDOWS)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+
+// every allocation of the process is counted, benchmarks report the difference per iteration
+
+void* operator new(std::size_t size)
+{
+	Real::Bench::GetAllocationCounter().fetch_add(1, std::memory_order_relaxed);
+
+	if (void* pointer = std::malloc(size ? size : 1))
+		return pointer;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+
+namespace Real { namespace Bench {
+
+	/// Output formats of the results.
+	enum class EOutputFormat : uint8
+	{
+		TABLE,
+		CSV,
+		JSON,
+	};
+
+	/// Forgets the peak resident set size of the process, so the next run reports its own peak (Linux only).
+	static void ResetPeakMemory()
+	{
+#if defined(REAL_PLATFORM_LINUX)
+		if (std::FILE* file = std::fopen("/proc/self/clear_refs", "w"))
+		{
+			std::fputs("5", file);
+			std::fclose(file);
+		}
+#endif
+	}
+
+	/// Returns peak resident set size in bytes of the process and of the executables it has run, whichever is larger.
+	static uint64 GetPeakMemory()
+	{
+#if defined(REAL_PLATFORM_WINDOWS)
+		PROCESS_MEMORY_COUNTERS counters;
+		return ::GetProcessMemoryInfo(::GetCurrentProcess(), &counters, sizeof(counters)) ? counters.PeakWorkingSetSize : 0;
+#else
+		struct rusage self_usage, children_usage;
+		::getrusage(RUSAGE_SELF, &self_usage);
+		::getrusage(RUSAGE_CHILDREN, &children_usage);
+
+		const uint64 peak = std::max(self_usage.ru_maxrss, children_usage.ru_maxrss);
+#if defined(REAL_PLATFORM_MAC)
+		return peak;
+#else
+		return peak * 1024;
+#endif
+#endif
+	}
+
+	/// Escapes a string for a JSON value. Names of benchmarks only contain plain characters, so quotes and backslashes are enough.
+	static std::string EscapeJson(const std::string& text)
+	{
+		std::string escaped;
+
+		for (const TCHAR c : text)
+		{
+			if (c == '"' || c == '\\')
+				escaped += '\\';
+			escaped += c;
+		}
+
+		return escaped;
+	}
+
+} }
+
+
+/**
+ * Runs registered benchmarks.
+ * Options:
+ *	--filter=text			run only benchmarks which names contain text
+ *	--max-size=bytes		skip arguments greater than given value (1 GiB by default)
+ *	--min-time=seconds		minimal time spent on each argument (0.5 by default)
+ *	--format=table|csv|json	output format, csv and json are meant for scripts comparing releases
+ *	--asn1=path				asn1 executable for end-to-end benchmarks (a relative path, the one next to this executable by default)
+ */
+int main(int32 argc, TCHAR** argv)
+{
+	using namespace Real;
+	using namespace Real::Bench;
+
+	CommandLine::BuildFromArgc(argc, argv);
+
+	ParsedArguments parsed = CommandLine::Parse(CommandLine::GetOriginal(), EOptionType::DOUBLE_HYPHEN);
+
+	const std::string filter = parsed.Exists("--filter") ? parsed.Get("--filter").Get() : "";
+	const uint64 max_size = parsed.Exists("--max-size") ? std::strtoull(parsed.Get("--max-size").Get(), nullptr, 10) : (1ull << 30);
+	const double min_time = parsed.Exists("--min-time") ? std::strtod(parsed.Get("--min-time").Get(), nullptr) : 0.5;
+	const std::string format_name = parsed.Exists("--format") ? parsed.Get("--format").Get() : "table";
+
+	EOutputFormat format;
+
+	if (format_name == "table")
+		format = EOutputFormat::TABLE;
+	else if (format_name == "csv")
+		format = EOutputFormat::CSV;
+	else if (format_name == "json")
+		format = EOutputFormat::JSON;
+	else
+	{
+		std::cerr << "Unknown format " << format_name << ", use table, csv or json.\n";
+		return 1;
+	}
+
+	if (parsed.Exists("--asn1"))
+		GetCodecExecutable() = parsed.Get("--asn1").Get();
+	else
+	{
+		std::error_code error;
+		const std::filesystem::path sibling = std::filesystem::path(argv[0]).replace_filename(std::filesystem::path("asn1").replace_extension(std::filesystem::path(argv[0]).extension()));
+
+		if (std::filesystem::is_regular_file(sibling, error))
+			GetCodecExecutable() = sibling.string();
+	}
+
+	std::ostringstream results;
+	bool bIsFirstResult = true;
+
+	if (format == EOutputFormat::TABLE)
+		results << std::left << std::setw(40) << "benchmark" << std::right
+			<< std::setw(14) << "iterations" << std::setw(16) << "ns/op" << std::setw(14) << "MB/s" << std::setw(16) << "items/s"
+			<< std::setw(12) << "allocs/op" << std::setw(14) << "peak RSS MB" << '\n';
+	else if (format == EOutputFormat::CSV)
+		results << "name,argument,iterations,ns_per_op,bytes_per_second,items_per_second,allocs_per_op,peak_rss_bytes\n";
+	else
+		results << "{\n  \"benchmarks\": [";
+
+	// table rows are printed as soon as they are ready, machine readable output at once
+	const auto flush = [&results, format]()
+	{
+		if (format == EOutputFormat::TABLE)
+		{
+			std::cout << results.str() << std::flush;
+			results.str("");
+		}
+	};
+
+	flush();
+
+	for (const BenchmarkEntry& entry : GetRegistry())
+	{
+		if (!filter.empty() && entry.Name.find(filter) == std::string::npos)
+			continue;
+
+		for (uint64 argument : entry.Arguments)
+		{
+			if (argument > max_size)
+				continue;
+
+			ResetPeakMemory();
+
+			BenchmarkState state(argument, min_time);
+			entry.Function(state);
+
+			const std::string name = entry.Name + "/" + std::to_string(argument);
+
+			if (state.IsSkipped())
+			{
+				std::cerr << name << " skipped: " << state.GetSkipReason() << '\n';
+				continue;
+			}
+
+			const double iterations = static_cast<double>(state.GetIterations() ? state.GetIterations() : 1);
+			const double seconds = state.GetSeconds();
+			const double ns_per_op = seconds * 1e9 / iterations;
+			const double bytes_per_second = state.GetBytesProcessed() / seconds;
+			const double items_per_second = state.GetItemsProcessed() / seconds;
+			const double allocs_per_op = state.GetAllocations() / iterations;
+			const uint64 peak_memory = GetPeakMemory();
+
+			switch (format)
+			{
+			case EOutputFormat::TABLE:
+				results << std::left << std::setw(40) << name << std::right
+					<< std::setw(14) << state.GetIterations()
+					<< std::setw(16) << std::fixed << std::setprecision(1) << ns_per_op
+					<< std::setw(14) << std::setprecision(1) << bytes_per_second / 1e6
+					<< std::setw(16) << std::setprecision(0) << items_per_second
+					<< std::setw(12) << std::setprecision(2) << allocs_per_op
+					<< std::setw(14) << std::setprecision(1) << peak_memory / 1e6 << '\n';
+				break;
+
+			case EOutputFormat::CSV:
+				results << entry.Name << ',' << argument << ',' << state.GetIterations() << std::fixed << std::setprecision(1)
+					<< ',' << ns_per_op << ',' << bytes_per_second << ',' << items_per_second
+					<< ',' << std::setprecision(3) << allocs_per_op << ',' << peak_memory << '\n';
+				break;
+
+			case EOutputFormat::JSON:
+				results << (bIsFirstResult ? "\n" : ",\n") << std::fixed << std::setprecision(1)
+					<< "    { \"name\": \"" << EscapeJson(entry.Name) << "\", \"argument\": " << argument << ", \"iterations\": " << state.GetIterations()
+					<< ", \"ns_per_op\": " << ns_per_op << ", \"bytes_per_second\": " << bytes_per_second << ", \"items_per_second\": " << items_per_second
+					<< ", \"allocs_per_op\": " << std::setprecision(3) << allocs_per_op << ", \"peak_rss_bytes\": " << peak_memory << " }";
+				break;
+			}
+
+			bIsFirstResult = false;
+			flush();
+		}
+	}
+
+	if (format == EOutputFormat::JSON)
+		results << "\n  ]\n}\n";
+
+	std::cout << results.str();
+
+	return 0;
+}
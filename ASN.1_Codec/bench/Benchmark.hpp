@@ -0,0 +1,179 @@
+#ifndef __REAL_BENCHMARK__
+#define __REAL_BENCHMARK__
+
+#include "../src/Core.h"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+
+/**
+ * Minimal benchmarking helpers for ASN.1 codec.
+ * Benchmarks are compiled together with codec sources (without src/Main.cpp) and bench/BenchMain.cpp.
+ */
+namespace Real { namespace Bench {
+
+
+	/// Number of operator new calls of the whole process. Counted by the replacement operators of BenchMain.cpp.
+	inline std::atomic<uint64>& GetAllocationCounter()
+	{
+		static std::atomic<uint64> counter(0);
+		return counter;
+	}
+
+	/// Path of the asn1 executable run by end-to-end benchmarks (--asn1=path), empty if there is none.
+	inline std::string& GetCodecExecutable()
+	{
+		static std::string path;
+		return path;
+	}
+
+
+	/**
+	 * State of a single benchmark run. A benchmark function loops while KeepRunning() returns true
+	 * and reports how much data it has processed.
+	 */
+	class BenchmarkState
+	{
+	public:
+
+		typedef std::chrono::steady_clock clock_type;
+
+	public:
+
+		BenchmarkState(uint64 argument, double min_seconds)
+			: Argument(argument), MinSeconds(min_seconds), Iterations(0), NextCheck(1), BytesProcessed(0), ItemsProcessed(0), Seconds(0.0),
+			  AllocationsAtStart(0), Allocations(0), bIsSkipped(false)
+		{
+			Start = clock_type::now();
+		}
+
+		/// Returns benchmark argument (payload size for most of the benchmarks).
+		FORCEINLINE uint64 GetArgument() const { return Argument; }
+
+		/**
+		 * Counts one more iteration. The clock is checked on powers of two only,
+		 * so tiny operations are not dominated by the timer itself.
+		 * Time and allocations are counted from the first call, so the setup before the loop is not measured.
+		 */
+		FORCEINLINE bool KeepRunning()
+		{
+			if (++Iterations < NextCheck)
+				return true;
+
+			if (Iterations == 1)
+			{
+				Start = clock_type::now();
+				AllocationsAtStart = GetAllocationCounter().load(std::memory_order_relaxed);
+				NextCheck = 2;
+				return true;
+			}
+
+			Seconds = std::chrono::duration<double>(clock_type::now() - Start).count();
+			if (Seconds >= MinSeconds)
+			{
+				Allocations = GetAllocationCounter().load(std::memory_order_relaxed) - AllocationsAtStart;
+				--Iterations;
+				return false;
+			}
+
+			NextCheck *= 2;
+			return true;
+		}
+
+		/// Sets total number of bytes processed by all the iterations.
+		FORCEINLINE void SetBytesProcessed(uint64 bytes) { BytesProcessed = bytes; }
+
+		/// Sets total number of items (messages, values) processed by all the iterations.
+		FORCEINLINE void SetItemsProcessed(uint64 items) { ItemsProcessed = items; }
+
+		/// Marks the run as not measured, e.g. when a required file or executable is missing.
+		FORCEINLINE void Skip(const std::string& reason) { bIsSkipped = true; SkipReason = reason; }
+
+		FORCEINLINE uint64 GetIterations() const { return Iterations; }
+		FORCEINLINE uint64 GetBytesProcessed() const { return BytesProcessed; }
+		FORCEINLINE uint64 GetItemsProcessed() const { return ItemsProcessed; }
+		FORCEINLINE double GetSeconds() const { return Seconds; }
+		FORCEINLINE uint64 GetAllocations() const { return Allocations; }
+		FORCEINLINE bool IsSkipped() const { return bIsSkipped; }
+		FORCEINLINE const std::string& GetSkipReason() const { return SkipReason; }
+
+	private:
+
+		uint64 Argument;
+		double MinSeconds;
+
+		uint64 Iterations;
+		uint64 NextCheck;
+
+		uint64 BytesProcessed;
+		uint64 ItemsProcessed;
+
+		clock_type::time_point Start;
+		double Seconds;
+
+		uint64 AllocationsAtStart;
+		uint64 Allocations;
+
+		bool bIsSkipped;
+		std::string SkipReason;
+
+	};
+
+	typedef void (*BenchmarkFunction)(BenchmarkState&);
+
+	/// Registered benchmark.
+	struct BenchmarkEntry
+	{
+		std::string Name;
+		BenchmarkFunction Function;
+		std::vector<uint64> Arguments;
+	};
+
+	/// Returns all registered benchmarks.
+	inline std::vector<BenchmarkEntry>& GetRegistry()
+	{
+		static std::vector<BenchmarkEntry> registry;
+		return registry;
+	}
+
+	/// Adds a benchmark to the registry. Used by REAL_BENCHMARK macro.
+	inline bool Register(const TCHAR* name, BenchmarkFunction function, std::vector<uint64> arguments)
+	{
+		GetRegistry().push_back({ name, function, std::move(arguments) });
+		return true;
+	}
+
+	/// Prevents the compiler from optimizing away a computed value.
+	template<typename _Ty>
+	FORCEINLINE void DoNotOptimize(const _Ty& value)
+	{
+#if defined(REAL_MSVC_COMPILER)
+		static volatile const void* sink;
+		sink = &value;
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+
+	/// Payload sizes from 0 bytes to 4 gigabytes, multiplied by 16 each step. Sizes above --max-size (1 GiB by default) are skipped.
+	inline std::vector<uint64> PayloadSizes()
+	{
+		std::vector<uint64> sizes = { 0 };
+		for (uint64 size = 16; size <= (1ull << 30); size *= 16)
+			sizes.push_back(size);
+		sizes.push_back(1ull << 30);
+		sizes.push_back(1ull << 32);
+		return sizes;
+	}
+
+} }
+
+
+/// Registers a benchmark function with a list of arguments.
+#define REAL_BENCHMARK(__function__, ...) \
+		static const bool __function__##_registered = Real::Bench::Register(#__function__, __function__, __VA_ARGS__)
+
+
+#endif
@@ -0,0 +1,116 @@
+#include "Benchmark.hpp"
+#include "../src/Codecs/ASN1_Codec.h"
+
+#include <cstring>
+#include <vector>
+
+
+namespace Real { namespace Bench {
+
+	using namespace Real::Codecs;
+
+	/// Flags per bitmap: a register, a page of statuses, a large status export.
+	static std::vector<uint64> FlagCounts() { return { 64, 4096, 65536, 1 << 20 }; }
+
+	/// Status bitmap with roughly one flag in three set.
+	static std::vector<uint8> MakeFlags(uint64 count)
+	{
+		std::vector<uint8> flags(count);
+		uint64 seed = 0x9E3779B97F4A7C15ull;
+
+		for (uint64 i = 0; i < count; ++i)
+		{
+			seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+			flags[i] = (seed % 3) == 0;
+		}
+
+		return flags;
+	}
+
+	/// Bit at a time reference: what a straightforward encoder does.
+	static SIZE_T ReferenceWriteContent(BYTE* destination, const std::vector<uint8>& flags)
+	{
+		const SIZE_T size = 1 + (flags.size() + 7) / 8;
+
+		std::memset(destination, 0, size);
+		destination[0] = static_cast<BYTE>((8 - flags.size() % 8) % 8);
+
+		for (SIZE_T i = 0; i < flags.size(); ++i)
+			if (flags[i])
+				destination[1 + i / 8] |= static_cast<BYTE>(0x80 >> (i % 8));
+
+		return size;
+	}
+
+	/// Bit at a time reference decoder.
+	static bool ReferenceReadContent(const BYTE* content, SIZE_T length, uint8* flags)
+	{
+		const SIZE_T count = (length - 1) * 8 - static_cast<uint8>(content[0]);
+
+		for (SIZE_T i = 0; i < count; ++i)
+			flags[i] = (static_cast<uint8>(content[1 + i / 8]) >> (7 - i % 8)) & 1;
+
+		return true;
+	}
+
+	/// Content writer of the codec.
+	static SIZE_T WriteContent(BYTE* destination, const std::vector<uint8>& flags)
+	{
+		return ASN1_Codec::WriteBitStringContent(destination, flags);
+	}
+
+	/// Content reader of the codec.
+	static bool ReadContent(const BYTE* content, SIZE_T length, uint8* flags)
+	{
+		ASN1_Codec::SIZE_TYPE bit_count;
+		return ASN1_Codec::ReadBitStringContent(content, length, flags, bit_count);
+	}
+
+	/// Packs the bitmap, writer is one of the content writers above.
+	template<typename _Writer>
+	static void PackFlags(BenchmarkState& state, _Writer writer)
+	{
+		const std::vector<uint8> flags = MakeFlags(state.GetArgument());
+		std::vector<BYTE> output(ASN1_Codec::GetBitStringContentSize(flags.size()));
+
+		while (state.KeepRunning())
+		{
+			DoNotOptimize(writer(output.data(), flags));
+			DoNotOptimize(output.data());
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * flags.size());
+		state.SetItemsProcessed(state.GetIterations());
+	}
+
+	/// Unpacks the bitmap, reader is one of the content readers above.
+	template<typename _Reader>
+	static void UnpackFlags(BenchmarkState& state, _Reader reader)
+	{
+		const std::vector<uint8> flags = MakeFlags(state.GetArgument());
+		std::vector<BYTE> content(ASN1_Codec::GetBitStringContentSize(flags.size()));
+		ASN1_Codec::WriteBitStringContent(content.data(), flags);
+
+		std::vector<uint8> output(flags.size());
+
+		while (state.KeepRunning())
+		{
+			DoNotOptimize(reader(content.data(), content.size(), output.data()));
+			DoNotOptimize(output.data());
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * flags.size());
+		state.SetItemsProcessed(state.GetIterations());
+	}
+
+	static void BM_PackBitStringReference(BenchmarkState& state) { PackFlags(state, ReferenceWriteContent); }
+	static void BM_PackBitString(BenchmarkState& state) { PackFlags(state, WriteContent); }
+	static void BM_UnpackBitStringReference(BenchmarkState& state) { UnpackFlags(state, ReferenceReadContent); }
+	static void BM_UnpackBitString(BenchmarkState& state) { UnpackFlags(state, ReadContent); }
+
+	REAL_BENCHMARK(BM_PackBitStringReference, FlagCounts());
+	REAL_BENCHMARK(BM_PackBitString, FlagCounts());
+	REAL_BENCHMARK(BM_UnpackBitStringReference, FlagCounts());
+	REAL_BENCHMARK(BM_UnpackBitString, FlagCounts());
+
+} }
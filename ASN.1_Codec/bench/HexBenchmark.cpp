@@ -0,0 +1,73 @@
+#include "Benchmark.hpp"
+#include "../src/Misc/Hex.hpp"
+
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+
+namespace Real { namespace Bench {
+
+	/// Bytes per block: one segment header, a terminal line, a stdin block.
+	static std::vector<uint64> HexBlockSizes() { return { 16, 256, 4096, 65536, 1 << 20 }; }
+
+	/// Previous output of the standard input mode: iostream formatting of every byte.
+	static void BM_HexIostream(BenchmarkState& state)
+	{
+		const std::vector<BYTE> bytes(state.GetArgument(), 0x5a);
+		std::ostringstream stream;
+
+		while (state.KeepRunning())
+		{
+			stream.str("");
+
+			for (const BYTE byte : bytes)
+				stream << std::setw(2) << std::setfill('0') << std::hex << (int)(uint8)byte << " ";
+
+			DoNotOptimize(stream.tellp());
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * bytes.size());
+	}
+
+	/// Block conversion into a reused buffer.
+	static void BM_HexEncodeSpaced(BenchmarkState& state)
+	{
+		const std::vector<BYTE> bytes(state.GetArgument(), 0x5a);
+		std::vector<BYTE> text(bytes.size() * Hex::SpacedCharsPerByte);
+
+		while (state.KeepRunning())
+		{
+			DoNotOptimize(Hex::EncodeSpaced(text.data(), bytes.data(), bytes.size()));
+			DoNotOptimize(text.data());
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * bytes.size());
+	}
+
+	/// Decoding of EncodeSpaced output, as given by "--input-format=hex".
+	static void BM_HexDecode(BenchmarkState& state)
+	{
+		const std::vector<BYTE> bytes(state.GetArgument(), 0x5a);
+		std::vector<BYTE> text(bytes.size() * Hex::SpacedCharsPerByte);
+		std::vector<BYTE> decoded(bytes.size());
+
+		Hex::EncodeSpaced(text.data(), bytes.data(), bytes.size());
+
+		while (state.KeepRunning())
+		{
+			Hex::Decoder decoder;
+			SIZE_T written;
+
+			DoNotOptimize(decoder.Decode(decoded.data(), text.data(), text.size(), written));
+			DoNotOptimize(decoded.data());
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * bytes.size());
+	}
+
+	REAL_BENCHMARK(BM_HexIostream, HexBlockSizes());
+	REAL_BENCHMARK(BM_HexEncodeSpaced, HexBlockSizes());
+	REAL_BENCHMARK(BM_HexDecode, HexBlockSizes());
+
+} }
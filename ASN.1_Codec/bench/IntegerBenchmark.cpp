@@ -0,0 +1,90 @@
+#include "Benchmark.hpp"
+#include "../src/Codecs/ASN1_Codec.h"
+
+#include <vector>
+#include <memory>
+
+
+namespace Real { namespace Bench {
+
+	using namespace Real::Codecs;
+	using namespace Real::Codecs::ASN1CodecOptions;
+
+	/// Values per batch.
+	static std::vector<uint64> IntegerCounts() { return { 16, 256, 4096, 65536 }; }
+
+	/// Values of mixed sign and width, so minimal lengths vary from 1 to 8 bytes.
+	static std::vector<int64> MakeIntegers(uint64 count)
+	{
+		std::vector<int64> values(count);
+		uint64 seed = 0x9E3779B97F4A7C15ull;
+
+		for (uint64 i = 0; i < count; ++i)
+		{
+			seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+			values[i] = static_cast<int64>(seed) >> (seed % 64);
+		}
+
+		return values;
+	}
+
+
+	/// One EncodeToken call (and its allocations) per value.
+	static void BM_EncodeIntegerToken(BenchmarkState& state)
+	{
+		const std::vector<int64> values = MakeIntegers(state.GetArgument());
+
+		while (state.KeepRunning())
+		{
+			for (const int64 value : values)
+			{
+				auto token = ASN1_Codec::EncodeToken(EASN1ValueType::Integer, EASN1ClassTagType::UNIVERSAL, EASN1PCType::PRIMITIVE, &value, sizeof(value));
+				DoNotOptimize(token.GetContentBytes());
+			}
+		}
+
+		state.SetItemsProcessed(state.GetIterations() * values.size());
+	}
+
+	/// Branchless kernel writing into one preallocated buffer.
+	static void BM_EncodeIntegerBatch(BenchmarkState& state)
+	{
+		const std::vector<int64> values = MakeIntegers(state.GetArgument());
+		std::vector<BYTE> output(values.size() * ASN1_Codec::MaxIntegerTokenSize);
+		uint64 written = 0;
+
+		while (state.KeepRunning())
+		{
+			written = ASN1_Codec::EncodeIntegerBatch(values, output.data());
+			DoNotOptimize(output.data());
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * written);
+		state.SetItemsProcessed(state.GetIterations() * values.size());
+	}
+
+	/// Boolean kernel, one 3-byte token per value.
+	static void BM_EncodeBooleanBatch(BenchmarkState& state)
+	{
+		const uint64 count = state.GetArgument();
+		std::unique_ptr<bool[]> values(new bool[count]);
+		std::vector<BYTE> output(count * 3);
+
+		for (uint64 i = 0; i < count; ++i)
+			values[i] = (i * 7) % 3 == 0;
+
+		while (state.KeepRunning())
+		{
+			ASN1_Codec::EncodeBooleanBatch(Span<const bool>(values.get(), count), output.data());
+			DoNotOptimize(output.data());
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * count * 3);
+		state.SetItemsProcessed(state.GetIterations() * count);
+	}
+
+	REAL_BENCHMARK(BM_EncodeIntegerToken, IntegerCounts());
+	REAL_BENCHMARK(BM_EncodeIntegerBatch, IntegerCounts());
+	REAL_BENCHMARK(BM_EncodeBooleanBatch, IntegerCounts());
+
+} }
@@ -0,0 +1,69 @@
+#include "Benchmark.hpp"
+#include "../src/Codecs/ASN1_Codec.h"
+
+#include <vector>
+
+
+namespace Real { namespace Bench {
+
+	using namespace Real::Codecs;
+	using namespace Real::Codecs::ASN1CodecOptions;
+
+	/// Lengths per iteration.
+	constexpr uint64 LengthCount = 4096;
+
+	/// Number of significant bytes of benchmarked lengths, 0 means short form.
+	static std::vector<uint64> LengthBytes() { return { 0, 1, 2, 3, 4, 8 }; }
+
+	/// Lengths with exactly the given number of significant bytes, or short form lengths (less than 128) for 0.
+	static std::vector<uint64> MakeLengths(uint64 bytes)
+	{
+		std::vector<uint64> lengths(LengthCount);
+		uint64 seed = 0x9E3779B97F4A7C15ull;
+
+		for (uint64& length : lengths)
+		{
+			seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+
+			if (bytes == 0)
+			{
+				length = seed & 0x7F;
+				continue;
+			}
+
+			const uint64 mask = (bytes == 8) ? ~0ull : (1ull << (8 * bytes)) - 1;
+			length = (seed & mask) | (1ull << (8 * bytes - 1));
+		}
+
+		return lengths;
+	}
+
+	template<EASN1LengthForm _Form>
+	static void WriteLengths(BenchmarkState& state)
+	{
+		const std::vector<uint64> lengths = MakeLengths(state.GetArgument());
+		std::vector<BYTE> output(lengths.size() * 9);
+
+		while (state.KeepRunning())
+		{
+			BYTE* current = output.data();
+
+			for (const uint64 length : lengths)
+				current += ASN1_Codec::WriteLengthField(current, length, _Form);
+
+			DoNotOptimize(current);
+		}
+
+		state.SetItemsProcessed(state.GetIterations() * lengths.size());
+	}
+
+	/// Previous 1/3/5/9 byte layout.
+	static void BM_WriteLengthBucketed(BenchmarkState& state) { WriteLengths<EASN1LengthForm::BUCKETED>(state); }
+
+	/// Minimal DER layout sized with count leading zeros.
+	static void BM_WriteLengthDER(BenchmarkState& state) { WriteLengths<EASN1LengthForm::DER>(state); }
+
+	REAL_BENCHMARK(BM_WriteLengthBucketed, LengthBytes());
+	REAL_BENCHMARK(BM_WriteLengthDER, LengthBytes());
+
+} }
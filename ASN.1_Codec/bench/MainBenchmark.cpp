@@ -0,0 +1,241 @@
+#include "Benchmark.hpp"
+#include "../src/Codecs/ASN1_Codec.h"
+#include "../src/Platform/PlatformFile.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace Real { namespace Bench {
+
+	using namespace Real::Codecs;
+
+
+	/// Input and output files of file benchmarks. Relative, since asn1 takes arguments starting with '/' for switches.
+	constexpr const TCHAR* BenchInputFileName = "asn1_bench_input.bin";
+	constexpr const TCHAR* BenchOutputFileName = "asn1_bench_output.bin";
+
+#if defined(REAL_PLATFORM_WINDOWS)
+	constexpr const TCHAR* NullDevice = "NUL";
+#else
+	constexpr const TCHAR* NullDevice = "/dev/null";
+#endif
+
+
+	/**
+	 * Input file of given size that lives while the benchmark runs.
+	 * Filled with one byte value and no line breaks, so the line based standard input mode reads all of it.
+	 */
+	class BenchInputFile
+	{
+	public:
+
+		explicit BenchInputFile(uint64 size)
+		{
+			System::PlatformFile file;
+			bIsCreated = file.OpenWrite(BenchInputFileName);
+
+			std::unique_ptr<BYTE[]> chunk(new BYTE[System::PlatformFile::CopyBufferSize]);
+			std::memset(chunk.get(), 0x5a, System::PlatformFile::CopyBufferSize);
+
+			for (uint64 written = 0; bIsCreated && written < size; written += System::PlatformFile::CopyBufferSize)
+				bIsCreated = file.WriteAll(chunk.get(), std::min<uint64>(size - written, System::PlatformFile::CopyBufferSize));
+		}
+
+		~BenchInputFile()
+		{
+			std::error_code error;
+			std::filesystem::remove(BenchInputFileName, error);
+			std::filesystem::remove(BenchOutputFileName, error);
+		}
+
+		FORCEINLINE bool IsCreated() const { return bIsCreated; }
+
+	private:
+
+		bool bIsCreated;
+
+	};
+
+
+	/// File mode of the application without the process: header and kernel-side copy.
+	static void BM_EncodeFile(BenchmarkState& state)
+	{
+		const uint64 size = state.GetArgument();
+		BenchInputFile file(size);
+
+		if (!file.IsCreated())
+			return state.Skip("cannot create the input file");
+
+		while (state.KeepRunning())
+		{
+			System::PlatformFile input, output;
+
+			const bool bSucceeded = input.OpenRead(BenchInputFileName) && output.OpenWrite(BenchOutputFileName) && ASN1_Codec::EncodeFile(input, output);
+			DoNotOptimize(bSucceeded);
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * size);
+		state.SetItemsProcessed(state.GetIterations());
+	}
+
+	/// Streaming standard input mode without the process: the file takes place of the standard input, the sink drops the output.
+	static void BM_EncodeStream(BenchmarkState& state)
+	{
+		const uint64 size = state.GetArgument();
+		BenchInputFile file(size);
+
+		if (!file.IsCreated())
+			return state.Skip("cannot create the input file");
+
+		const ASN1_Codec::SINK_TYPE sink = [](const BYTE* bytes, ASN1_Codec::SIZE_TYPE count) { DoNotOptimize(bytes); DoNotOptimize(count); return true; };
+
+		while (state.KeepRunning())
+		{
+			System::PlatformFile input;
+
+			const bool bSucceeded = input.OpenRead(BenchInputFileName) && ASN1_Codec::EncodeStream(input, 64 * 1024, sink);
+			DoNotOptimize(bSucceeded);
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * size);
+		state.SetItemsProcessed(state.GetIterations());
+	}
+
+
+	/// Sizes of the short reads benchmark: empty, below, at and above one chunk, and many chunks.
+	static std::vector<uint64> ShortReadSizes() { return { 0, 1, 65535, 65536, 65537, 300 * 1000, 4 << 20 }; }
+
+	/**
+	 * Streaming mode over a source that gives 1 to 4097 bytes per call, as a pipe does. Every segment but the last one
+	 * must still be exactly one chunk, the run is skipped with the reason if the output does not follow that.
+	 */
+	static void BM_EncodeStreamShortReads(BenchmarkState& state)
+	{
+		constexpr ASN1_Codec::SIZE_TYPE chunk_size = 64 * 1024;
+
+		const std::vector<BYTE> bytes(state.GetArgument(), 0x5a);
+		std::vector<uint64> segment_sizes;
+
+		// the sink gets the stream header, then one call per segment and end-of-contents octets
+		const ASN1_Codec::SINK_TYPE sink = [&segment_sizes](const BYTE* segment, ASN1_Codec::SIZE_TYPE count)
+		{
+			const uint8 length_octet = static_cast<uint8>(segment[1]);
+
+			if (static_cast<uint8>(segment[0]) != 0x04 || count < 2)
+				return true;
+
+			uint64 size = length_octet;
+
+			if (length_octet & 0x80)
+			{
+				size = 0;
+
+				for (uint8 i = 0; i < (length_octet & 0x7F); ++i)
+					size = (size << 8) | static_cast<uint8>(segment[2 + i]);
+			}
+
+			segment_sizes.push_back(size);
+			return true;
+		};
+
+		while (state.KeepRunning())
+		{
+			SIZE_T position = 0;
+			uint32 seed = 0x9E3779B9u;
+
+			segment_sizes.clear();
+
+			const auto source = [&](BYTE* destination, ASN1_Codec::SIZE_TYPE count) -> int64
+			{
+				seed = seed * 1664525u + 1013904223u;
+
+				const SIZE_T received = std::min<SIZE_T>({ count, bytes.size() - position, 1 + (seed >> 20) });
+				std::memcpy(destination, bytes.data() + position, received);
+				position += received;
+
+				return static_cast<int64>(received);
+			};
+
+			DoNotOptimize(ASN1_Codec::EncodeStream(source, chunk_size, sink));
+		}
+
+		uint64 total = 0;
+
+		for (SIZE_T i = 0; i < segment_sizes.size(); ++i)
+		{
+			total += segment_sizes[i];
+
+			if (segment_sizes[i] == 0 || (i + 1 < segment_sizes.size() && segment_sizes[i] != chunk_size))
+				return state.Skip("segment " + std::to_string(i) + " has " + std::to_string(segment_sizes[i]) + " bytes, not one chunk");
+		}
+
+		if (total != bytes.size())
+			return state.Skip("segments hold " + std::to_string(total) + " of " + std::to_string(bytes.size()) + " bytes");
+
+		state.SetBytesProcessed(state.GetIterations() * bytes.size());
+		state.SetItemsProcessed(state.GetIterations());
+	}
+
+	/**
+	 * Runs the asn1 executable once per iteration, so process start, argument parsing and the real input and output are measured.
+	 * Placeholders "{input}" and "{output}" of the arguments are replaced, "{null}" is the null device.
+	 */
+	static void RunApplication(BenchmarkState& state, std::string arguments)
+	{
+		if (GetCodecExecutable().empty())
+			return state.Skip("no asn1 executable, build it next to the benchmark or pass --asn1=path");
+
+		const uint64 size = state.GetArgument();
+		BenchInputFile file(size);
+
+		if (!file.IsCreated())
+			return state.Skip("cannot create the input file");
+
+		const auto replace = [&arguments](const std::string& placeholder, const std::string& value)
+		{
+			for (SIZE_T position; (position = arguments.find(placeholder)) != std::string::npos; )
+				arguments.replace(position, placeholder.size(), value);
+		};
+
+		replace("{input}", BenchInputFileName);
+		replace("{output}", BenchOutputFileName);
+		replace("{null}", NullDevice);
+
+		const std::string command = "\"" + GetCodecExecutable() + "\" " + arguments;
+
+		if (std::system(command.c_str()) != 0)
+			return state.Skip("asn1 failed: " + command);
+
+		while (state.KeepRunning())
+			DoNotOptimize(std::system(command.c_str()));
+
+		state.SetBytesProcessed(state.GetIterations() * size);
+		state.SetItemsProcessed(state.GetIterations());
+	}
+
+	static void BM_MainFile(BenchmarkState& state) { RunApplication(state, "{input} {output}"); }
+	static void BM_MainMappedFile(BenchmarkState& state) { RunApplication(state, "--input=mmap {input} {output}"); }
+	static void BM_MainMappedFilePopulate(BenchmarkState& state) { RunApplication(state, "--input=mmap-populate {input} {output}"); }
+	static void BM_MainParallelFile(BenchmarkState& state) { RunApplication(state, "--parallel {input} {output}"); }
+	static void BM_MainFilePem(BenchmarkState& state) { RunApplication(state, "--output-format=pem {input} {output}"); }
+	static void BM_MainStdin(BenchmarkState& state) { RunApplication(state, "- < {input} > {null}"); }
+	static void BM_MainStdinStream(BenchmarkState& state) { RunApplication(state, "--stream - < {input} > {null}"); }
+
+	REAL_BENCHMARK(BM_EncodeFile, PayloadSizes());
+	REAL_BENCHMARK(BM_EncodeStream, PayloadSizes());
+	REAL_BENCHMARK(BM_EncodeStreamShortReads, ShortReadSizes());
+	REAL_BENCHMARK(BM_MainFile, PayloadSizes());
+	REAL_BENCHMARK(BM_MainMappedFile, PayloadSizes());
+	REAL_BENCHMARK(BM_MainMappedFilePopulate, PayloadSizes());
+	REAL_BENCHMARK(BM_MainParallelFile, PayloadSizes());
+	REAL_BENCHMARK(BM_MainFilePem, PayloadSizes());
+	REAL_BENCHMARK(BM_MainStdin, PayloadSizes());
+	REAL_BENCHMARK(BM_MainStdinStream, PayloadSizes());
+
+} }
@@ -0,0 +1,81 @@
+#include "Benchmark.hpp"
+#include "../src/Codecs/ASN1_Codec.h"
+#include "../src/Codecs/ASN1_ReverseWriter.h"
+
+#include <vector>
+
+
+namespace Real { namespace Bench {
+
+	using namespace Real::Codecs;
+	using namespace Real::Codecs::ASN1CodecOptions;
+
+	/// Nesting depth of benchmarked structures.
+	static std::vector<uint64> NestingDepths() { return { 1, 4, 16, 64 }; }
+
+	/// Payload of the innermost OCTET STRING.
+	constexpr uint64 NestedPayloadSize = 256;
+
+
+	/// Serializes children, measures them and copies them under every parent header.
+	static void EncodeForward(std::vector<BYTE>& output, const std::vector<BYTE>& payload, uint64 depth)
+	{
+		output.resize(ASN1_Codec::MaxHeaderSize + payload.size());
+		output.resize(ASN1_Codec::WriteHeader(output.data(), EASN1ValueType::OctetString, EASN1ClassTagType::UNIVERSAL, EASN1PCType::PRIMITIVE, payload.size()));
+		output.insert(output.end(), payload.begin(), payload.end());
+
+		for (uint64 level = 0; level < depth; ++level)
+		{
+			std::vector<BYTE> parent(ASN1_Codec::MaxHeaderSize + output.size());
+			parent.resize(ASN1_Codec::WriteHeader(parent.data(), EASN1ValueType::Sequence, EASN1ClassTagType::UNIVERSAL, EASN1PCType::CONSTRUCTED, output.size()));
+			parent.insert(parent.end(), output.begin(), output.end());
+			output.swap(parent);
+		}
+	}
+
+	static void BM_NestedForwardCopy(BenchmarkState& state)
+	{
+		const uint64 depth = state.GetArgument();
+		const std::vector<BYTE> payload(NestedPayloadSize, 0x5a);
+		std::vector<BYTE> output;
+
+		while (state.KeepRunning())
+		{
+			EncodeForward(output, payload, depth);
+			DoNotOptimize(output.data());
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * output.size());
+	}
+
+	static void BM_NestedReverseWriter(BenchmarkState& state)
+	{
+		const uint64 depth = state.GetArgument();
+		const std::vector<BYTE> payload(NestedPayloadSize, 0x5a);
+		std::vector<BYTE> buffer(NestedPayloadSize + (depth + 1) * ASN1_Codec::MaxHeaderSize);
+		std::vector<ASN1ReverseWriter::SIZE_TYPE> marks(depth);
+
+		ASN1ReverseWriter writer(buffer.data(), buffer.size());
+
+		while (state.KeepRunning())
+		{
+			writer.Reset();
+
+			for (uint64 level = 0; level < depth; ++level)
+				marks[level] = writer.Mark();
+
+			writer.PrependOctetString(payload.data(), payload.size());
+
+			for (uint64 level = depth; level > 0; --level)
+				writer.CloseSequence(marks[level - 1]);
+
+			DoNotOptimize(writer.GetData());
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * writer.GetSize());
+	}
+
+	REAL_BENCHMARK(BM_NestedForwardCopy, NestingDepths());
+	REAL_BENCHMARK(BM_NestedReverseWriter, NestingDepths());
+
+} }
@@ -0,0 +1,183 @@
+#include "Benchmark.hpp"
+#include "../src/Codecs/ASN1_Codec.h"
+
+#include <vector>
+
+
+namespace Real { namespace Bench {
+
+	using namespace Real::Codecs;
+
+	/// Identifiers per batch.
+	static std::vector<uint64> OidCounts() { return { 16, 256, 4096, 65536 }; }
+
+	/// Certificate and MIB-like identifiers: short arcs under a long enterprise prefix, sometimes a large arc.
+	static std::vector<std::vector<uint64>> MakeIdentifiers(uint64 count)
+	{
+		std::vector<std::vector<uint64>> identifiers(count);
+		uint64 seed = 0x9E3779B97F4A7C15ull;
+
+		for (uint64 i = 0; i < count; ++i)
+		{
+			seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+
+			identifiers[i] = { 1, 3, 6, 1, 4, 1, 311 + seed % 50000, 21, seed % 128 };
+
+			for (uint64 extra = seed % 6; extra > 0; --extra)
+				identifiers[i].push_back((seed >> (extra * 9)) % ((extra == 5) ? (1ull << 40) : 1000));
+		}
+
+		return identifiers;
+	}
+
+	/// SNMP-like identifiers: a short prefix followed by counters and addresses of any width.
+	static std::vector<std::vector<uint64>> MakeWideIdentifiers(uint64 count)
+	{
+		std::vector<std::vector<uint64>> identifiers(count);
+		uint64 seed = 0x9E3779B97F4A7C15ull;
+
+		for (uint64 i = 0; i < count; ++i)
+		{
+			identifiers[i] = { 1, 3, 6, 1, 2, 1 };
+
+			for (uint32 arc = 0; arc < 6; ++arc)
+			{
+				seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+				identifiers[i].push_back(seed >> (seed % 64));
+			}
+		}
+
+		return identifiers;
+	}
+
+	/// Byte per group reference: what a straightforward encoder does.
+	static BYTE* ReferenceWriteSubidentifier(BYTE* destination, uint64 value)
+	{
+		uint32 groups = 1;
+		while (groups < 10 && (value >> (7 * groups)) != 0)
+			++groups;
+
+		for (uint32 group = groups; group-- > 0; )
+			*destination++ = static_cast<BYTE>(((value >> (7 * group)) & 0x7F) | (group ? 0x80 : 0));
+
+		return destination;
+	}
+
+	static SIZE_T ReferenceWriteContent(BYTE* destination, const std::vector<uint64>& arcs)
+	{
+		BYTE* current = ReferenceWriteSubidentifier(destination, arcs[0] * 40 + arcs[1]);
+
+		for (SIZE_T i = 2; i < arcs.size(); ++i)
+			current = ReferenceWriteSubidentifier(current, arcs[i]);
+
+		return current - destination;
+	}
+
+	/// Byte per group reference decoder.
+	static SIZE_T ReferenceReadContent(const BYTE* content, SIZE_T length, uint64* arcs)
+	{
+		uint64* current = arcs + 1;
+		uint64 value = 0;
+
+		for (SIZE_T i = 0; i < length; ++i)
+		{
+			value = (value << 7) | (content[i] & 0x7F);
+
+			if ((content[i] & 0x80) == 0)
+			{
+				*current++ = value;
+				value = 0;
+			}
+		}
+
+		arcs[0] = (arcs[1] < 80) ? arcs[1] / 40 : 2;
+		arcs[1] -= 40 * arcs[0];
+
+		return current - arcs;
+	}
+
+	/// Encodes every identifier into one buffer, writer is one of the content writers above.
+	template<typename _Writer>
+	static void EncodeIdentifiers(BenchmarkState& state, const std::vector<std::vector<uint64>>& identifiers, _Writer writer)
+	{
+		std::vector<BYTE> output(identifiers.size() * 128);
+		uint64 written = 0;
+
+		while (state.KeepRunning())
+		{
+			BYTE* current = output.data();
+
+			for (const auto& arcs : identifiers)
+				current += writer(current, arcs);
+
+			written = current - output.data();
+			DoNotOptimize(output.data());
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * written);
+		state.SetItemsProcessed(state.GetIterations() * identifiers.size());
+	}
+
+	/// Decodes every identifier from one buffer, reader is one of the content readers above.
+	template<typename _Reader>
+	static void DecodeIdentifiers(BenchmarkState& state, const std::vector<std::vector<uint64>>& identifiers, _Reader reader)
+	{
+		std::vector<BYTE> input(identifiers.size() * 128);
+		std::vector<SIZE_T> sizes;
+		BYTE* current = input.data();
+
+		for (const auto& arcs : identifiers)
+		{
+			sizes.push_back(ASN1_Codec::WriteObjectIdentifierContent(current, arcs));
+			current += sizes.back();
+		}
+
+		std::vector<uint64> arcs(128 + 1);
+
+		while (state.KeepRunning())
+		{
+			const BYTE* content = input.data();
+
+			for (const SIZE_T size : sizes)
+			{
+				DoNotOptimize(reader(content, size, arcs.data()));
+				content += size;
+			}
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * (current - input.data()));
+		state.SetItemsProcessed(state.GetIterations() * identifiers.size());
+	}
+
+	/// Content writer of the codec.
+	static SIZE_T WriteContent(BYTE* destination, const std::vector<uint64>& arcs)
+	{
+		return ASN1_Codec::WriteObjectIdentifierContent(destination, arcs);
+	}
+
+	/// Content reader of the codec.
+	static SIZE_T ReadContent(const BYTE* content, SIZE_T length, uint64* arcs)
+	{
+		return ASN1_Codec::ReadObjectIdentifierContent(content, length, arcs);
+	}
+
+	static void BM_EncodeOidReference(BenchmarkState& state) { EncodeIdentifiers(state, MakeIdentifiers(state.GetArgument()), ReferenceWriteContent); }
+	static void BM_EncodeOidContent(BenchmarkState& state) { EncodeIdentifiers(state, MakeIdentifiers(state.GetArgument()), WriteContent); }
+	static void BM_EncodeWideOidReference(BenchmarkState& state) { EncodeIdentifiers(state, MakeWideIdentifiers(state.GetArgument()), ReferenceWriteContent); }
+	static void BM_EncodeWideOidContent(BenchmarkState& state) { EncodeIdentifiers(state, MakeWideIdentifiers(state.GetArgument()), WriteContent); }
+
+	static void BM_DecodeOidReference(BenchmarkState& state) { DecodeIdentifiers(state, MakeIdentifiers(state.GetArgument()), ReferenceReadContent); }
+	static void BM_DecodeOidContent(BenchmarkState& state) { DecodeIdentifiers(state, MakeIdentifiers(state.GetArgument()), ReadContent); }
+	static void BM_DecodeWideOidReference(BenchmarkState& state) { DecodeIdentifiers(state, MakeWideIdentifiers(state.GetArgument()), ReferenceReadContent); }
+	static void BM_DecodeWideOidContent(BenchmarkState& state) { DecodeIdentifiers(state, MakeWideIdentifiers(state.GetArgument()), ReadContent); }
+
+	REAL_BENCHMARK(BM_EncodeOidReference, OidCounts());
+	REAL_BENCHMARK(BM_EncodeOidContent, OidCounts());
+	REAL_BENCHMARK(BM_EncodeWideOidReference, OidCounts());
+	REAL_BENCHMARK(BM_EncodeWideOidContent, OidCounts());
+	REAL_BENCHMARK(BM_DecodeOidReference, OidCounts());
+	REAL_BENCHMARK(BM_DecodeOidContent, OidCounts());
+	REAL_BENCHMARK(BM_DecodeWideOidReference, OidCounts());
+	REAL_BENCHMARK(BM_DecodeWideOidContent, OidCounts());
+
+} }
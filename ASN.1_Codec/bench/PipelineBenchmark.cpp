@@ -0,0 +1,111 @@
+#include "Benchmark.hpp"
+#include "../src/Codecs/CodecStages.hpp"
+
+#include <memory>
+#include <vector>
+
+
+namespace Real { namespace Bench {
+
+	using namespace Real::Codecs;
+	using namespace Real::Codecs::ASN1CodecOptions;
+
+	/// Bytes per run: one block of the pipeline, sizes that fit L2 and L3 cache, and one far beyond them.
+	static std::vector<uint64> PipelineSizes() { return { 4096, 65536, 1 << 20, 64 << 20 }; }
+
+	static std::vector<BYTE> MakePipelinePayload(uint64 size)
+	{
+		std::vector<BYTE> bytes(size);
+		uint32 state = 0x9E3779B9u;
+
+		for (BYTE& byte : bytes)
+		{
+			state = state * 1664525u + 1013904223u;
+			byte = static_cast<BYTE>(state >> 24);
+		}
+
+		return bytes;
+	}
+
+	/// CRC-32C alone.
+	static void BM_Crc32(BenchmarkState& state)
+	{
+		const std::vector<BYTE> bytes = MakePipelinePayload(state.GetArgument());
+
+		while (state.KeepRunning())
+			DoNotOptimize(Crc32::Compute(bytes.data(), bytes.size()));
+
+		state.SetBytesProcessed(state.GetIterations() * bytes.size());
+	}
+
+	/// ASN.1 wrap, Base64 and checksum as separate passes over whole buffers: every pass reads what the previous one wrote to memory.
+	static void BM_WrapBase64Crc32Passes(BenchmarkState& state)
+	{
+		const std::vector<BYTE> bytes = MakePipelinePayload(state.GetArgument());
+		std::vector<BYTE> token(ASN1_Codec::MaxHeaderSize + bytes.size());
+		std::vector<BYTE> text(Base64::Encoder::GetMaxEncodedSize(token.size() + 2, 0));
+
+		while (state.KeepRunning())
+		{
+			SIZE_T token_size = ASN1_Codec::WriteHeader(token.data(), EASN1ValueType::OctetString, EASN1ClassTagType::UNIVERSAL, EASN1PCType::PRIMITIVE, bytes.size());
+			std::memcpy(token.data() + token_size, bytes.data(), bytes.size());
+			token_size += bytes.size();
+
+			Base64::Encoder encoder;
+			SIZE_T text_size = encoder.Encode(text.data(), token.data(), token_size);
+			text_size += encoder.Finish(text.data() + text_size);
+
+			DoNotOptimize(Crc32::Compute(text.data(), text_size));
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * bytes.size());
+	}
+
+	/// The same stages fused by CodecPipeline: every block goes through all of them while it is in cache.
+	static void BM_WrapBase64Crc32Pipeline(BenchmarkState& state)
+	{
+		const std::vector<BYTE> bytes = MakePipelinePayload(state.GetArgument());
+
+		CodecPipeline<ASN1OctetStringStage, Base64EncodeStage, Crc32Stage> pipeline{ ASN1OctetStringStage(), Base64EncodeStage(), Crc32Stage() };
+		auto sink = [](const BYTE* text, SIZE_T) { DoNotOptimize(text); return true; };
+
+		while (state.KeepRunning())
+		{
+			pipeline.Reset(bytes.size());
+			pipeline.Write(bytes, sink);
+			pipeline.Finish(sink);
+
+			DoNotOptimize(pipeline.GetStage<2>().GetChecksum());
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * bytes.size());
+	}
+
+	/// The pipeline behind the Codec interface: one virtual call per buffer, output into memory.
+	static void BM_PipelineCodecEncode(BenchmarkState& state)
+	{
+		std::vector<BYTE> bytes = MakePipelinePayload(state.GetArgument());
+
+		typedef CodecPipeline<ASN1OctetStringStage, Base64EncodeStage> EncodePipeline;
+		typedef CodecPipeline<Base64DecodeStage> DecodePipeline;
+
+		PipelineCodec<EncodePipeline, DecodePipeline> pipeline_codec(EncodePipeline(ASN1OctetStringStage(), Base64EncodeStage()), DecodePipeline(Base64DecodeStage()), "ASN.1 Base64 Codec");
+		Codec* codec = &pipeline_codec;
+
+		std::vector<BYTE> text(codec->GetMaxEncodedSize(bytes.size()));
+
+		while (state.KeepRunning())
+		{
+			codec->Encode(bytes.data(), text.data(), static_cast<int32>(bytes.size()));
+			DoNotOptimize(codec->GetLastSize());
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * bytes.size());
+	}
+
+	REAL_BENCHMARK(BM_Crc32, PipelineSizes());
+	REAL_BENCHMARK(BM_WrapBase64Crc32Passes, PipelineSizes());
+	REAL_BENCHMARK(BM_WrapBase64Crc32Pipeline, PipelineSizes());
+	REAL_BENCHMARK(BM_PipelineCodecEncode, PipelineSizes());
+
+} }
@@ -0,0 +1,129 @@
+#include "Benchmark.hpp"
+#include "../src/Codecs/ASN1_Codec.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+
+namespace Real { namespace Bench {
+
+	using namespace Real::Codecs;
+
+	/// Values per batch.
+	static std::vector<uint64> RealCounts() { return { 16, 256, 4096, 65536 }; }
+
+	/// Sensor-like readings: a smooth signal with noise, so mantissas are mostly full width.
+	static std::vector<double> MakeReadings(uint64 count)
+	{
+		std::vector<double> values(count);
+		uint64 seed = 0x9E3779B97F4A7C15ull;
+
+		for (uint64 i = 0; i < count; ++i)
+		{
+			seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+			values[i] = 20.0 + (i % 1000) * 0.01 + static_cast<double>(seed % 100000) * 1e-6;
+		}
+
+		return values;
+	}
+
+	/// Decimal NR3 reference: every value printed with round trip precision.
+	static void BM_EncodeRealDecimal(BenchmarkState& state)
+	{
+		const std::vector<double> values = MakeReadings(state.GetArgument());
+		std::vector<BYTE> output(values.size() * 32);
+		uint64 written = 0;
+
+		while (state.KeepRunning())
+		{
+			BYTE* current = output.data();
+
+			for (const double value : values)
+			{
+				// form octet 0x03 (NR3) and the text
+				*current = 0x03;
+				current += 1 + std::snprintf(current + 1, 31, "%.17E", value);
+			}
+
+			written = current - output.data();
+			DoNotOptimize(output.data());
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * written);
+		state.SetItemsProcessed(state.GetIterations() * values.size());
+	}
+
+	/// Binary kernel writing whole tokens into one preallocated buffer.
+	static void BM_EncodeRealBatch(BenchmarkState& state)
+	{
+		const std::vector<double> values = MakeReadings(state.GetArgument());
+		std::vector<BYTE> output(values.size() * ASN1_Codec::MaxRealTokenSize);
+		uint64 written = 0;
+
+		while (state.KeepRunning())
+		{
+			written = ASN1_Codec::EncodeRealBatch(values, output.data());
+			DoNotOptimize(output.data());
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * written);
+		state.SetItemsProcessed(state.GetIterations() * values.size());
+	}
+
+	/// Decimal NR3 reference decoder.
+	static void BM_DecodeRealDecimal(BenchmarkState& state)
+	{
+		const std::vector<double> values = MakeReadings(state.GetArgument());
+		std::vector<ANSICHAR> text(values.size() * 32);
+
+		for (SIZE_T i = 0; i < values.size(); ++i)
+			std::snprintf(text.data() + i * 32, 32, "%.17E", values[i]);
+
+		while (state.KeepRunning())
+		{
+			double sum = 0;
+
+			for (SIZE_T i = 0; i < values.size(); ++i)
+				sum += std::strtod(text.data() + i * 32, nullptr);
+
+			DoNotOptimize(sum);
+		}
+
+		state.SetItemsProcessed(state.GetIterations() * values.size());
+	}
+
+	/// Binary kernel reading the tokens written by EncodeRealBatch.
+	static void BM_DecodeRealContent(BenchmarkState& state)
+	{
+		const std::vector<double> values = MakeReadings(state.GetArgument());
+		std::vector<BYTE> input(values.size() * ASN1_Codec::MaxRealTokenSize);
+		const uint64 size = ASN1_Codec::EncodeRealBatch(values, input.data());
+
+		while (state.KeepRunning())
+		{
+			const BYTE* current = input.data();
+			double sum = 0;
+
+			for (SIZE_T i = 0; i < values.size(); ++i)
+			{
+				double value;
+				ASN1_Codec::ReadRealContent(current + 2, static_cast<uint8>(current[1]), value);
+
+				sum += value;
+				current += 2 + static_cast<uint8>(current[1]);
+			}
+
+			DoNotOptimize(sum);
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * size);
+		state.SetItemsProcessed(state.GetIterations() * values.size());
+	}
+
+	REAL_BENCHMARK(BM_EncodeRealDecimal, RealCounts());
+	REAL_BENCHMARK(BM_EncodeRealBatch, RealCounts());
+	REAL_BENCHMARK(BM_DecodeRealDecimal, RealCounts());
+	REAL_BENCHMARK(BM_DecodeRealContent, RealCounts());
+
+} }
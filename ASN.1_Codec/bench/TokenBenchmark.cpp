@@ -0,0 +1,146 @@
+#include "Benchmark.hpp"
+#include "../src/Codecs/ASN1_Codec.h"
+
+#include <memory>
+#include <cstring>
+#include <ostream>
+#include <streambuf>
+
+
+namespace Real { namespace Bench {
+
+	using namespace Real::Codecs;
+	using namespace Real::Codecs::ASN1CodecOptions;
+
+
+	/// Owning token: header plus a heap copy of the whole payload.
+	static void BM_EncodeOctetStringOwning(BenchmarkState& state)
+	{
+		const uint64 size = state.GetArgument();
+		std::unique_ptr<BYTE[]> payload(new BYTE[size]);
+		std::memset(payload.get(), 0x5a, size);
+
+		while (state.KeepRunning())
+		{
+			auto token = ASN1_Codec::EncodeToken(EASN1ValueType::OctetString, EASN1ClassTagType::UNIVERSAL, EASN1PCType::PRIMITIVE, payload.get(), size);
+			DoNotOptimize(token.GetContentBytes());
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * size);
+		state.SetItemsProcessed(state.GetIterations());
+	}
+
+	/// View token: header only, content refers to the payload.
+	static void BM_EncodeOctetStringView(BenchmarkState& state)
+	{
+		const uint64 size = state.GetArgument();
+		std::unique_ptr<BYTE[]> payload(new BYTE[size]);
+		std::memset(payload.get(), 0x5a, size);
+
+		while (state.KeepRunning())
+		{
+			auto token = ASN1_Codec::EncodeOctetStringView(EASN1ClassTagType::UNIVERSAL, payload.get(), size);
+			DoNotOptimize(token.GetContentBytes());
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * size);
+		state.SetItemsProcessed(state.GetIterations());
+	}
+
+	/// Significant bytes of benchmarked lengths, 0 means short form.
+	static std::vector<uint64> LengthFieldBytes() { return { 0, 1, 2, 4, 8 }; }
+
+	/// Exposes the protected step of EncodeToken.
+	struct LengthFieldCodec : public ASN1_Codec
+	{
+		using ASN1_Codec::ConstructLengthField;
+	};
+
+	/// Length field of a token as EncodeToken builds it: sized and written in front of the content.
+	static void BM_ConstructLengthField(BenchmarkState& state)
+	{
+		const uint64 bytes = state.GetArgument();
+		const uint64 length = bytes ? 1ull << (8 * bytes - 1) : 100;
+
+		while (state.KeepRunning())
+		{
+			ASN1_Codec::ASN1EncodedToken token(EASN1ValueType::OctetString, length);
+			LengthFieldCodec::ConstructLengthField(token, length);
+			DoNotOptimize(token.GetLengthBytes());
+		}
+
+		state.SetItemsProcessed(state.GetIterations());
+	}
+
+	/// Stream buffer over preallocated memory, rewound before every write, so operator << is measured without file or string growth.
+	class FixedStreamBuffer : public std::streambuf
+	{
+	public:
+
+		explicit FixedStreamBuffer(SIZE_T size) : Memory(new BYTE[size ? size : 1]), Size(size) { Rewind(); }
+
+		FORCEINLINE void Rewind() { setp(Memory.get(), Memory.get() + Size); }
+
+		FORCEINLINE const BYTE* GetData() const { return Memory.get(); }
+
+	private:
+
+		std::unique_ptr<BYTE[]> Memory;
+
+		SIZE_T Size;
+
+	};
+
+	/// View token written with operator << as the standard input mode of the application does: header and content are two writes.
+	static void BM_WriteTokenToStream(BenchmarkState& state)
+	{
+		const uint64 size = state.GetArgument();
+		std::unique_ptr<BYTE[]> payload(new BYTE[size]);
+		std::memset(payload.get(), 0x5a, size);
+
+		const auto token = ASN1_Codec::EncodeOctetStringView(EASN1ClassTagType::UNIVERSAL, payload.get(), size);
+
+		FixedStreamBuffer buffer(ASN1_Codec::MaxHeaderSize + size);
+		std::ostream stream(&buffer);
+
+		while (state.KeepRunning())
+		{
+			buffer.Rewind();
+			stream << token;
+			DoNotOptimize(buffer.GetData());
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * size);
+		state.SetItemsProcessed(state.GetIterations());
+	}
+
+	/// Owning token written with operator <<: header is stored right in front of the content, so it is one write.
+	static void BM_WriteOwningTokenToStream(BenchmarkState& state)
+	{
+		const uint64 size = state.GetArgument();
+		std::unique_ptr<BYTE[]> payload(new BYTE[size]);
+		std::memset(payload.get(), 0x5a, size);
+
+		const auto token = ASN1_Codec::EncodeToken(EASN1ValueType::OctetString, EASN1ClassTagType::UNIVERSAL, EASN1PCType::PRIMITIVE, payload.get(), size);
+
+		FixedStreamBuffer buffer(ASN1_Codec::MaxHeaderSize + size);
+		std::ostream stream(&buffer);
+
+		while (state.KeepRunning())
+		{
+			buffer.Rewind();
+			stream << token;
+			DoNotOptimize(buffer.GetData());
+		}
+
+		state.SetBytesProcessed(state.GetIterations() * size);
+		state.SetItemsProcessed(state.GetIterations());
+	}
+
+	REAL_BENCHMARK(BM_EncodeOctetStringOwning, PayloadSizes());
+	REAL_BENCHMARK(BM_EncodeOctetStringView, PayloadSizes());
+	REAL_BENCHMARK(BM_ConstructLengthField, LengthFieldBytes());
+	REAL_BENCHMARK(BM_WriteTokenToStream, PayloadSizes());
+	REAL_BENCHMARK(BM_WriteOwningTokenToStream, PayloadSizes());
+
+} }
@@ -0,0 +1,329 @@
+#include "ASN1_Codec.h"
+#include <cstring>
+#include "../Platform/Limits.h"
+#include "../Misc/Endian.hpp"
+#include "../Misc/Bits.hpp"
+#include "../Misc/Simd.hpp"
+
+
+
+namespace Real { namespace Codecs {
+
+	using namespace ASN1CodecOptions;
+
+	namespace Private
+	{
+		/**
+		 * Packs flags into bytes, the first flag becomes the high bit of the first byte.
+		 * Writes exactly (count + 7) / 8 bytes, unused bits of the last one are zero.
+		 */
+		void PackFlags(BYTE* destination, const BYTE* flags, SIZE_T count)
+		{
+			SIZE_T i = 0;
+
+			for (; i + 16 <= count; i += 16, destination += 2)
+				Simd::PackFlags16(destination, flags + i);
+
+			for (; i + 8 <= count; i += 8)
+				*destination++ = static_cast<BYTE>(Simd::PackFlags8(flags + i));
+
+			if (i < count)
+			{
+				// zero padding keeps unused bits clear
+				BYTE tail[8] = { };
+				std::memcpy(tail, flags + i, count - i);
+
+				*destination = static_cast<BYTE>(Simd::PackFlags8(tail));
+			}
+		}
+
+		/// Expands exactly count bits into flags of 0 or 1, the high bit of the first byte becomes the first flag.
+		void UnpackFlags(BYTE* flags, const BYTE* bits, SIZE_T count)
+		{
+			SIZE_T i = 0;
+
+			for (; i + 16 <= count; i += 16, bits += 2)
+				Simd::UnpackFlags16(flags + i, bits);
+
+			for (; i + 8 <= count; i += 8)
+				Simd::UnpackFlags8(flags + i, static_cast<uint8>(*bits++));
+
+			if (i < count)
+			{
+				BYTE tail[8];
+				Simd::UnpackFlags8(tail, static_cast<uint8>(*bits));
+
+				std::memcpy(flags + i, tail, count - i);
+			}
+		}
+
+		/// Writes the identifier, length and unused bits octets of a BIT STRING token, returns the position of the bits.
+		FORCEINLINE BYTE* WriteBitStringHeader(BYTE* destination, SIZE_T bit_count, SIZE_T& token_size)
+		{
+			const ASN1_Codec::SIZE_TYPE content_size = ASN1_Codec::GetBitStringContentSize(bit_count);
+
+			destination[0] = static_cast<BYTE>(ASN1_Codec::GetIdentifierOctet(EASN1ValueType::BitString, EASN1ClassTagType::UNIVERSAL, EASN1PCType::PRIMITIVE));
+			const ASN1_Codec::SIZE_TYPE header_size = 1 + ASN1_Codec::WriteLengthField(destination + 1, content_size);
+
+			token_size = header_size + content_size;
+			destination[header_size] = static_cast<BYTE>((8 - bit_count % 8) % 8);
+
+			return destination + header_size + 1;
+		}
+	}
+
+	/**
+	 * Returns number of BIT STRING content bytes: the unused bits octet and one byte per started 8 bits.
+	 *
+	 * \param bit_count number of bits
+	 */
+	ASN1_Codec::SIZE_TYPE ASN1_Codec::GetBitStringContentSize(SIZE_TYPE bit_count)
+	{
+		return 1 + (bit_count + 7) / 8;
+	}
+
+	/**
+	 * Writes BIT STRING content of flags, the first flag becomes the high bit of the first byte.
+	 * Flags are packed 16 at a time with a vector compare and movemask, unused bits are zero as DER requires.
+	 *
+	 * \param destination	buffer of at least GetBitStringContentSize(flags.Size()) bytes
+	 * \param flags			one flag per bool
+	 *
+	 * \return number of written bytes
+	 */
+	ASN1_Codec::SIZE_TYPE ASN1_Codec::WriteBitStringContent(BYTE* destination, Span<const bool> flags)
+	{
+		destination[0] = static_cast<BYTE>((8 - flags.Size() % 8) % 8);
+		Private::PackFlags(destination + 1, reinterpret_cast<const BYTE*>(flags.Data()), flags.Size());
+
+		return GetBitStringContentSize(flags.Size());
+	}
+
+	/**
+	 * Writes BIT STRING content of byte flags, any non-zero byte is a set bit. Same layout as the bool overload.
+	 *
+	 * \param destination	buffer of at least GetBitStringContentSize(flags.Size()) bytes
+	 * \param flags			one flag per byte
+	 *
+	 * \return number of written bytes
+	 */
+	ASN1_Codec::SIZE_TYPE ASN1_Codec::WriteBitStringContent(BYTE* destination, Span<const uint8> flags)
+	{
+		destination[0] = static_cast<BYTE>((8 - flags.Size() % 8) % 8);
+		Private::PackFlags(destination + 1, reinterpret_cast<const BYTE*>(flags.Data()), flags.Size());
+
+		return GetBitStringContentSize(flags.Size());
+	}
+
+	/**
+	 * Writes BIT STRING content of a bitset stored in 64-bit words: bit i of the string is bit i % 64 of word i / 64,
+	 * as std::bitset and dynamic bitsets number their bits. Bits of the last word past bit_count are ignored.
+	 *
+	 * \param destination	buffer of at least GetBitStringContentSize(bit_count) bytes
+	 * \param words			at least (bit_count + 63) / 64 words
+	 * \param bit_count		number of bits
+	 *
+	 * \return number of written bytes
+	 */
+	ASN1_Codec::SIZE_TYPE ASN1_Codec::WriteBitStringContent(BYTE* destination, Span<const uint64> words, SIZE_TYPE bit_count)
+	{
+		destination[0] = static_cast<BYTE>((8 - bit_count % 8) % 8);
+		BYTE* current = destination + 1;
+
+		// low bit of a word is the first one, so every byte is bit reversed and the word is stored little endian
+		const SIZE_TYPE full_words = bit_count / 64;
+
+		for (SIZE_TYPE i = 0; i < full_words; ++i, current += sizeof(uint64))
+		{
+			const uint64 packed = Endian::native_to_little(Bits::ReverseBitsInBytes(words[i]));
+			std::memcpy(current, &packed, sizeof(packed));
+		}
+
+		if (const SIZE_TYPE tail_bits = bit_count % 64)
+		{
+			const uint64 packed = Endian::native_to_little(Bits::ReverseBitsInBytes(words[full_words] & (MAX_UINT64 >> (64 - tail_bits))));
+			std::memcpy(current, &packed, (tail_bits + 7) / 8);
+		}
+
+		return GetBitStringContentSize(bit_count);
+	}
+
+	/**
+	 * Writes a whole BIT STRING token with universal tag.
+	 *
+	 * \param destination	buffer of at least MaxHeaderSize + GetBitStringContentSize(flags.Size()) bytes
+	 * \param flags			one flag per bool
+	 *
+	 * \return number of written bytes
+	 */
+	ASN1_Codec::SIZE_TYPE ASN1_Codec::WriteBitString(BYTE* destination, Span<const bool> flags)
+	{
+		SIZE_T size;
+		BYTE* bits = Private::WriteBitStringHeader(destination, flags.Size(), size);
+		Private::PackFlags(bits, reinterpret_cast<const BYTE*>(flags.Data()), flags.Size());
+
+		return size;
+	}
+
+	/**
+	 * Writes a whole BIT STRING token with universal tag, any non-zero byte is a set bit.
+	 *
+	 * \param destination	buffer of at least MaxHeaderSize + GetBitStringContentSize(flags.Size()) bytes
+	 * \param flags			one flag per byte
+	 *
+	 * \return number of written bytes
+	 */
+	ASN1_Codec::SIZE_TYPE ASN1_Codec::WriteBitString(BYTE* destination, Span<const uint8> flags)
+	{
+		SIZE_T size;
+		BYTE* bits = Private::WriteBitStringHeader(destination, flags.Size(), size);
+		Private::PackFlags(bits, reinterpret_cast<const BYTE*>(flags.Data()), flags.Size());
+
+		return size;
+	}
+
+	/**
+	 * Checks BIT STRING content and returns the number of bits it holds.
+	 *
+	 * \param content			content bytes
+	 * \param length			number of content bytes
+	 * \param[out] bit_count	number of bits
+	 *
+	 * \return false if the content is empty, the unused bits octet is above 7 (or not 0 for an empty string)
+	 *		   or unused bits are not zero
+	 */
+	bool ASN1_Codec::GetBitStringBitCount(const BYTE* content, SIZE_TYPE length, SIZE_TYPE& bit_count)
+	{
+		if (length == 0)
+			return false;
+
+		const uint8 unused = static_cast<uint8>(content[0]);
+
+		if (unused > 7 || (length == 1 && unused != 0))
+			return false;
+
+		if (length > 1 && (static_cast<uint8>(content[length - 1]) & ((1u << unused) - 1)) != 0)
+			return false;
+
+		bit_count = (length - 1) * 8 - unused;
+		return true;
+	}
+
+	/**
+	 * Reads BIT STRING content into flags of 0 or 1. Bytes are expanded 16 bits at a time.
+	 *
+	 * \param content			content bytes
+	 * \param length			number of content bytes
+	 * \param[out] flags		buffer of at least GetBitStringBitCount flags, exactly that many are written
+	 * \param[out] bit_count	number of bits
+	 *
+	 * \return false if the content is malformed, see GetBitStringBitCount
+	 */
+	bool ASN1_Codec::ReadBitStringContent(const BYTE* content, SIZE_TYPE length, bool* flags, SIZE_TYPE& bit_count)
+	{
+		if (!GetBitStringBitCount(content, length, bit_count))
+			return false;
+
+		Private::UnpackFlags(reinterpret_cast<BYTE*>(flags), content + 1, bit_count);
+		return true;
+	}
+
+	/**
+	 * Reads BIT STRING content into byte flags of 0 or 1.
+	 *
+	 * \param content			content bytes
+	 * \param length			number of content bytes
+	 * \param[out] flags		buffer of at least GetBitStringBitCount flags, exactly that many are written
+	 * \param[out] bit_count	number of bits
+	 *
+	 * \return false if the content is malformed, see GetBitStringBitCount
+	 */
+	bool ASN1_Codec::ReadBitStringContent(const BYTE* content, SIZE_TYPE length, uint8* flags, SIZE_TYPE& bit_count)
+	{
+		if (!GetBitStringBitCount(content, length, bit_count))
+			return false;
+
+		Private::UnpackFlags(reinterpret_cast<BYTE*>(flags), content + 1, bit_count);
+		return true;
+	}
+
+	/**
+	 * Reads BIT STRING content into a bitset stored in 64-bit words, numbered as WriteBitStringContent does.
+	 * Bits of the last word past bit_count are zero.
+	 *
+	 * \param content			content bytes
+	 * \param length			number of content bytes
+	 * \param[out] words		buffer of at least (bit_count + 63) / 64 words
+	 * \param[out] bit_count	number of bits
+	 *
+	 * \return false if the content is malformed, see GetBitStringBitCount
+	 */
+	bool ASN1_Codec::ReadBitStringContent(const BYTE* content, SIZE_TYPE length, uint64* words, SIZE_TYPE& bit_count)
+	{
+		if (!GetBitStringBitCount(content, length, bit_count))
+			return false;
+
+		const BYTE* bits = content + 1;
+		const SIZE_TYPE byte_count = length - 1;
+		const SIZE_TYPE full_words = byte_count / sizeof(uint64);
+
+		for (SIZE_TYPE i = 0; i < full_words; ++i, bits += sizeof(uint64))
+		{
+			uint64 packed;
+			std::memcpy(&packed, bits, sizeof(packed));
+
+			words[i] = Bits::ReverseBitsInBytes(Endian::little_to_native(packed));
+		}
+
+		if (const SIZE_TYPE tail_bytes = byte_count % sizeof(uint64))
+		{
+			// unused bits are zero already, so is the padding
+			uint64 packed = 0;
+			std::memcpy(&packed, bits, tail_bytes);
+
+			words[full_words] = Bits::ReverseBitsInBytes(Endian::little_to_native(packed));
+		}
+
+		return true;
+	}
+
+	/**
+	 * Reads BIT STRING content into a vector of byte flags.
+	 *
+	 * \param content		content bytes
+	 * \param length		number of content bytes
+	 * \param[out] flags	decoded flags of 0 or 1
+	 *
+	 * \return false if the content is malformed
+	 */
+	bool ASN1_Codec::ReadBitStringContent(const BYTE* content, SIZE_TYPE length, std::vector<uint8>& flags)
+	{
+		SIZE_TYPE bit_count;
+
+		if (!GetBitStringBitCount(content, length, bit_count))
+			return false;
+
+		flags.resize(bit_count);
+		Private::UnpackFlags(reinterpret_cast<BYTE*>(flags.data()), content + 1, bit_count);
+
+		return true;
+	}
+
+	/**
+	 * Takes a token and packs flags (one byte each, any non-zero byte is set) into BIT STRING content.
+	 *
+	 * \param goal		token structure that contains token data
+	 * \param source	flags
+	 * \param length	number of flags
+	 */
+	void ASN1_Codec::EncodeBitString(ASN1EncodedToken& goal, const void* source, SIZE_TYPE length)
+	{
+		const SIZE_TYPE size = GetBitStringContentSize(length);
+		BYTE* content = goal.AllocateContent(size);
+		WriteBitStringContent(content, Span<const uint8>(static_cast<const uint8*>(source), length));
+
+		goal.ContentSize = size;
+	}
+
+
+} }
@@ -1,6 +1,13 @@
 #include "ASN1_Codec.h"
+#include "ASN1_Reader.h"
+#include "ASN1_Header.hpp"
+#include <cstring>
+#include <memory>
+#include <algorithm>
+#include <array>
 #include "../Platform/Limits.h"
 #include "../Misc/Endian.hpp"
+#include "../Misc/Bits.hpp"
 
 
 
@@ -8,6 +15,35 @@ namespace Real { namespace Codecs {
 
 	using namespace ASN1CodecOptions;
 
+	namespace Private
+	{
+		/// Encoded identifier of one tag number without class and pc bits. Always copied as a whole.
+		struct IdentifierTableEntry
+		{
+			BYTE	Bytes[3];	///< leading octet tag bits followed by base-128 groups
+			uint8	Size;		///< number of meaningful bytes
+		};
+
+		/// Tag numbers below this bound take at most two base-128 groups and are served from the table.
+		constexpr uint64 IdentifierTableSize = 1 << 14;
+
+		constexpr std::array<IdentifierTableEntry, IdentifierTableSize> BuildIdentifierTable()
+		{
+			std::array<IdentifierTableEntry, IdentifierTableSize> table{};
+
+			for (uint64 tag = 0; tag < IdentifierTableSize; ++tag)
+			{
+				table[tag].Size = ASN1Rules::IdentifierSize(tag);
+				ASN1Rules::WriteIdentifier(table[tag].Bytes, 0, tag);
+			}
+
+			return table;
+		}
+
+		/// Identifier sequences for all the tag numbers below IdentifierTableSize, built at compile time
+		constexpr std::array<IdentifierTableEntry, IdentifierTableSize> IdentifierTable = BuildIdentifierTable();
+	}
+
 	/// Returns string representation of a token value type
 	std::string GetASN1ValueTypeString(EASN1ValueType type)
 	{
@@ -27,6 +63,12 @@ namespace Real { namespace Codecs {
 			return std::string("OCTET_STRING");
 		case EASN1ValueType::Null:
 			return std::string("NULL");
+		case EASN1ValueType::ObjectIdentifier:
+			return std::string("OBJECT_IDENTIFIER");
+		case EASN1ValueType::Sequence:
+			return std::string("SEQUENCE");
+		case EASN1ValueType::Set:
+			return std::string("SET");
 		default:
 			return std::string("MaxASN1Values");
 		}
@@ -41,20 +83,15 @@ namespace Real { namespace Codecs {
 	 * \param pc_type	 primitive/constructed
 	 * \param source	 content stream
 	 * \param length	 length of the content
+	 * \param arena		 storage of the token bytes, nullptr takes them from the heap
 	 *
 	 * \return ASN1_Codec::ASN1EncodedToken structure that represents the token
 	 */
-	ASN1_Codec::ASN1EncodedToken ASN1_Codec::EncodeToken(EASN1ValueType value_type, EASN1ClassTagType class_type, EASN1PCType pc_type, const void* source, SIZE_TYPE length)
+	ASN1_Codec::ASN1EncodedToken ASN1_Codec::EncodeToken(EASN1ValueType value_type, EASN1ClassTagType class_type, EASN1PCType pc_type, const void* source, SIZE_TYPE length, System::MonotonicArena* arena)
 	{
-		ASN1EncodedToken goal(value_type, length);
+		ASN1EncodedToken goal(value_type, length, arena);
 
-		// constructing identifier octet, other data became valid in constructor
-		ConstructIdentifierOctet(goal, value_type, class_type, pc_type);
-
-		// constructing length field
-		ConstructLengthField(goal, length);
-		
-		// saving the content
+		// saving the content first, so the header is written once right in front of it
 		switch (value_type)
 		{
 
@@ -62,14 +99,233 @@ namespace Real { namespace Codecs {
 			EncodeOctetString(goal, source, length);
 			break;
 
+		case EASN1ValueType::Integer:
+		case EASN1ValueType::Enumerated:
+			EncodeInteger(goal, source, length);
+			break;
+
+		case EASN1ValueType::Boolean:
+			EncodeBoolean(goal, source, length);
+			break;
+
+		case EASN1ValueType::Null:
+			break;
+
+		case EASN1ValueType::ObjectIdentifier:
+			EncodeObjectIdentifier(goal, source, length);
+			break;
+
+		case EASN1ValueType::BitString:
+			EncodeBitString(goal, source, length);
+			break;
+
+		case EASN1ValueType::Real:
+			EncodeReal(goal, source, length);
+			break;
+
 		default:
 			throw asn1_unsupported_token{};
 		}
 
+		// header is built from its end: length octets, then identifier octet in front of them
+		ConstructLengthField(goal, goal.ContentSize);
+		ConstructIdentifierOctet(goal, value_type, class_type, pc_type);
+
+		goal.bIsEncoded = true;
 
 		return goal;
 	}
 
+	namespace Private
+	{
+		/// Copies content of all the primitive tokens in the range, entering constructed ones.
+		EASN1DecodeStatus UnwrapContent(ASN1Reader& reader, BYTE*& destination, uint32 depth)
+		{
+			if (depth >= ASN1Reader::MaxDepth)
+				return EASN1DecodeStatus::TOO_DEEP;
+
+			ASN1DecodedToken token;
+
+			while (reader.Next(token))
+			{
+				if (token.bIsConstructed)
+				{
+					ASN1Reader nested(token);
+					const EASN1DecodeStatus status = UnwrapContent(nested, destination, depth + 1);
+
+					if (status != EASN1DecodeStatus::END)
+						return status;
+				}
+				else
+				{
+					std::memcpy(destination, token.Content, token.ContentLength);
+					destination += token.ContentLength;
+				}
+			}
+
+			return reader.GetStatus();
+		}
+	}
+
+	/**
+	 * Unwraps a sequence of encoded tokens: content of every primitive token is copied to the destination,
+	 * constructed tokens are entered. Destination of length bytes is always large enough.
+	 * Throws bad_sequence if the sequence is malformed.
+	 *
+	 * \param[in]  from		encoded tokens
+	 * \param[out] to		destination to write content bytes to
+	 * \param[in]  length	number of encoded bytes
+	 */
+	void ASN1_Codec::Decode(void* from, void* to, int32 length)
+	{
+		if (length < 0)
+			throw asn1_bad_sequence{};
+
+		LastSize = UnwrapContent(from, static_cast<SIZE_TYPE>(length), to);
+	}
+
+	/**
+	 * Same as Decode, but for 64-bit lengths.
+	 * Throws bad_sequence if the sequence is malformed.
+	 *
+	 * \param source		encoded tokens
+	 * \param length		number of encoded bytes
+	 * \param destination	buffer of at least length bytes
+	 *
+	 * \return number of content bytes written to the destination
+	 */
+	ASN1_Codec::SIZE_TYPE ASN1_Codec::UnwrapContent(const void* source, SIZE_TYPE length, void* destination)
+	{
+		ASN1Reader reader(source, length);
+		BYTE* current = static_cast<BYTE*>(destination);
+
+		if (Private::UnwrapContent(reader, current, 0) != EASN1DecodeStatus::END)
+			throw asn1_bad_sequence{};
+
+		return current - static_cast<BYTE*>(destination);
+	}
+
+	/**
+	 * Encodes an octet string token that does not copy the content.
+	 * Only identifier and length octets are built, content pointer refers to the source,
+	 * so the source must outlive the returned token.
+	 *
+	 * \param class_type class type
+	 * \param source	 content stream
+	 * \param length	 length of the content
+	 * \param arena		 storage of the header bytes, nullptr takes them from the heap
+	 *
+	 * \return ASN1_Codec::ASN1EncodedToken structure that views the source
+	 */
+	ASN1_Codec::ASN1EncodedToken ASN1_Codec::EncodeOctetStringView(EASN1ClassTagType class_type, const void* source, SIZE_TYPE length, System::MonotonicArena* arena)
+	{
+		ASN1EncodedToken goal = EncodeHeader(EASN1ValueType::OctetString, class_type, EASN1PCType::PRIMITIVE, length, arena);
+
+		goal.Content = static_cast<const BYTE*>(source);
+		goal.ContentSize = length;
+
+		return goal;
+	}
+
+	/**
+	 * Encodes only identifier and length octets of a token. Content is left empty,
+	 * so it can be written by the caller right after the header.
+	 *
+	 * \param value_type type of value the token stores
+	 * \param class_type class type
+	 * \param pc_type	 primitive/constructed
+	 * \param length	 length of the content that will follow the header
+	 * \param arena		 storage of the header bytes, nullptr takes them from the heap
+	 *
+	 * \return ASN1_Codec::ASN1EncodedToken structure without content
+	 */
+	ASN1_Codec::ASN1EncodedToken ASN1_Codec::EncodeHeader(EASN1ValueType value_type, EASN1ClassTagType class_type, EASN1PCType pc_type, SIZE_TYPE length, System::MonotonicArena* arena)
+	{
+		ASN1EncodedToken goal(value_type, length, arena);
+
+		ConstructLengthField(goal, length);
+		ConstructIdentifierOctet(goal, value_type, class_type, pc_type);
+
+		return goal;
+	}
+
+	/**
+	 * Encodes the whole content of a regular file as a primitive octet string with universal tag.
+	 * Only the header is built in user space, the content is moved from file to file by the kernel
+	 * (see System::TransferFileContent).
+	 *
+	 * \param input	regular file opened for reading, its size is taken from fstat
+	 * \param output	file opened for writing
+	 *
+	 * \return false if input size is unknown or not all the bytes could be written
+	 */
+	bool ASN1_Codec::EncodeFile(System::PlatformFile& input, System::PlatformFile& output)
+	{
+		const int64 size = input.Size();
+
+		if (size < 0)
+			return false;
+
+		const auto header = EncodeHeader(EASN1ValueType::OctetString, EASN1ClassTagType::UNIVERSAL, EASN1PCType::PRIMITIVE, size);
+
+		BYTE header_bytes[MaxHeaderSize];
+		const SIZE_TYPE header_size = header.CopyHeaderTo(header_bytes);
+
+		if (!output.WriteAll(header_bytes, header_size))
+			return false;
+
+		return System::TransferFileContent(input, output, size) == static_cast<uint64>(size);
+	}
+
+	/**
+	 * Same as EncodeFile, but nothing is allocated: a file that fits in the buffer together with the header
+	 * is read once and written with its header in one call, larger files are moved by the kernel
+	 * and the buffer is only used if kernel-side copying is not supported.
+	 *
+	 * \param input	regular file opened for reading, its size is taken from fstat
+	 * \param output	file opened for writing
+	 * \param buffer	scratch memory of the calling thread
+	 *
+	 * \return false if input size is unknown, the file is shorter than its size or not all the bytes could be written
+	 */
+	bool ASN1_Codec::EncodeFile(System::PlatformFile& input, System::PlatformFile& output, Span<BYTE> buffer)
+	{
+		const int64 size = input.Size();
+
+		if (size < 0)
+			return false;
+
+		BYTE header_bytes[MaxHeaderSize];
+		header_bytes[0] = static_cast<BYTE>(GetIdentifierOctet(EASN1ValueType::OctetString, EASN1ClassTagType::UNIVERSAL, EASN1PCType::PRIMITIVE));
+		const SIZE_TYPE header_size = 1 + WriteLengthField(header_bytes + 1, size);
+
+		if (static_cast<uint64>(size) + MaxHeaderSize > buffer.Size())
+		{
+			if (!output.WriteAll(header_bytes, header_size))
+				return false;
+
+			return System::TransferFileContent(input, output, size, buffer.Data(), buffer.Size()) == static_cast<uint64>(size);
+		}
+
+		// content is read right after the space for the longest header, the real header goes just before it
+		BYTE* content = buffer.Data() + MaxHeaderSize;
+		uint64 received = 0;
+
+		while (received < static_cast<uint64>(size))
+		{
+			const int64 chunk = input.Read(content + received, size - received);
+
+			if (chunk <= 0)
+				return false;
+
+			received += chunk;
+		}
+
+		std::memcpy(content - header_size, header_bytes, header_size);
+
+		return output.WriteAll(content - header_size, header_size + size);
+	}
+
 	/**
 	 * Takes a token, encode the source sequence of bytes and sets corresponding token field.
 	 * To get fully encoded token should also construct identifier and length field.
@@ -80,57 +336,721 @@ namespace Real { namespace Codecs {
 	 */
 	void ASN1_Codec::EncodeOctetString(ASN1EncodedToken& goal, const void* source, SIZE_TYPE length)
 	{
-		goal.Content.NumberOfEncodedBytes = length;
-		goal.Content.Value = new BYTE[length];
-		std::memcpy(goal.Content.Value, source, length);
+		BYTE* content = goal.AllocateContent(length);
+		std::memcpy(content, source, length);
+
+		goal.ContentSize = length;
+	}
+
+	/**
+	 * Takes a token and encodes a native signed integer of 1, 2, 4 or 8 bytes
+	 * as minimal two's complement content.
+	 *
+	 * \param goal		token structure that contains token data
+	 * \param source	native integer
+	 * \param length	size of the integer in bytes
+	 */
+	void ASN1_Codec::EncodeInteger(ASN1EncodedToken& goal, const void* source, SIZE_TYPE length)
+	{
+		int64 value;
+
+		switch (length)
+		{
+		case 1: { int8 v; std::memcpy(&v, source, 1); value = v; break; }
+		case 2: { int16 v; std::memcpy(&v, source, 2); value = v; break; }
+		case 4: { int32 v; std::memcpy(&v, source, 4); value = v; break; }
+		case 8: { std::memcpy(&value, source, 8); break; }
+		default:
+			throw asn1_bad_sequence{};
+		}
+
+		const uint8 size = GetIntegerContentSize(value);
+		BYTE* content = goal.AllocateContent(sizeof(uint64));
+		WriteIntegerContent(content, value);
+
+		goal.ContentSize = size;
+	}
+
+	/**
+	 * Takes a token and encodes a boolean (any non-zero byte is TRUE) as DER does: 0xFF or 0x00.
+	 *
+	 * \param goal		token structure that contains token data
+	 * \param source	one byte
+	 * \param length	has to be 1
+	 */
+	void ASN1_Codec::EncodeBoolean(ASN1EncodedToken& goal, const void* source, SIZE_TYPE length)
+	{
+		if (length != 1)
+			throw asn1_bad_sequence{};
+
+		BYTE* content = goal.AllocateContent(1);
+		content[0] = *static_cast<const BYTE*>(source) ? static_cast<BYTE>(0xFF) : 0;
+
+		goal.ContentSize = 1;
+	}
+
+	/**
+	 * Returns number of bytes of minimal two's complement representation of the value (1 to 8).
+	 * Branchless: the width of the value without its sign bits plus one sign bit, rounded up to bytes.
+	 *
+	 * \param value any value
+	 */
+	uint8 ASN1_Codec::GetIntegerContentSize(int64 value)
+	{
+		// positive values keep their bits, negative values are inverted, so leading sign bits become zeros
+		const uint64 magnitude = static_cast<uint64>(value ^ (value >> 63));
+
+		// | 1 keeps clz defined for 0 and -1, both take one byte anyway
+		return static_cast<uint8>((64 - Bits::CountLeadingZeros(magnitude | 1) + 1 + 7) / 8);
+	}
+
+	/**
+	 * Writes minimal two's complement content of the value.
+	 * Always stores 8 bytes, only the first GetIntegerContentSize(value) of them are meaningful.
+	 *
+	 * \param destination	buffer of at least 8 bytes
+	 * \param value			any value
+	 *
+	 * \return number of meaningful bytes
+	 */
+	uint8 ASN1_Codec::WriteIntegerContent(BYTE* destination, int64 value)
+	{
+		const uint8 size = GetIntegerContentSize(value);
+
+		// move meaningful bytes to the top and store big endian, the tail is garbage
+		const uint64 big_endian_value = Endian::native_to_big<uint64>(static_cast<uint64>(value) << (64 - 8 * size));
+		std::memcpy(destination, &big_endian_value, sizeof(big_endian_value));
+
+		return size;
+	}
+
+	/**
+	 * Writes a whole INTEGER token (identifier, length and content) with universal tag.
+	 * Always touches MaxIntegerTokenSize bytes.
+	 *
+	 * \param destination	buffer of at least MaxIntegerTokenSize bytes
+	 * \param value			any value
+	 *
+	 * \return number of meaningful bytes
+	 */
+	uint8 ASN1_Codec::WriteInteger(BYTE* destination, int64 value)
+	{
+		const uint8 size = WriteIntegerContent(destination + 2, value);
+
+		destination[0] = static_cast<BYTE>(EASN1ValueType::Integer);
+		destination[1] = static_cast<BYTE>(size);
+
+		return 2 + size;
+	}
+
+	/**
+	 * Writes a whole ENUMERATED token with universal tag. Same layout as WriteInteger.
+	 *
+	 * \param destination	buffer of at least MaxIntegerTokenSize bytes
+	 * \param value			any value
+	 *
+	 * \return number of meaningful bytes
+	 */
+	uint8 ASN1_Codec::WriteEnumerated(BYTE* destination, int64 value)
+	{
+		const uint8 size = WriteIntegerContent(destination + 2, value);
+
+		destination[0] = static_cast<BYTE>(EASN1ValueType::Enumerated);
+		destination[1] = static_cast<BYTE>(size);
+
+		return 2 + size;
+	}
+
+	/// Writes a whole BOOLEAN token with universal tag (3 bytes). Returns number of written bytes.
+	uint8 ASN1_Codec::WriteBoolean(BYTE* destination, bool value)
+	{
+		destination[0] = static_cast<BYTE>(EASN1ValueType::Boolean);
+		destination[1] = 1;
+		destination[2] = static_cast<BYTE>(-static_cast<int8>(value));
+
+		return 3;
+	}
+
+	/// Writes a whole NULL token with universal tag (2 bytes). Returns number of written bytes.
+	uint8 ASN1_Codec::WriteNull(BYTE* destination)
+	{
+		destination[0] = static_cast<BYTE>(EASN1ValueType::Null);
+		destination[1] = 0;
+
+		return 2;
+	}
+
+	/**
+	 * Writes INTEGER tokens for all the values one after another.
+	 * Every token is written as a fixed MaxIntegerTokenSize store and the cursor moves only
+	 * by its real size, so there are no per-value branches or byte loops.
+	 *
+	 * \param values		values to encode
+	 * \param destination	buffer of at least values.Size() * MaxIntegerTokenSize bytes
+	 *
+	 * \return number of written bytes
+	 */
+	ASN1_Codec::SIZE_TYPE ASN1_Codec::EncodeIntegerBatch(Span<const int64> values, BYTE* destination)
+	{
+		BYTE* current = destination;
+
+		for (const int64 value : values)
+			current += WriteInteger(current, value);
+
+		return current - destination;
+	}
+
+	/**
+	 * Writes ENUMERATED tokens for all the values one after another. Same rules as EncodeIntegerBatch.
+	 *
+	 * \param values		values to encode
+	 * \param destination	buffer of at least values.Size() * MaxIntegerTokenSize bytes
+	 *
+	 * \return number of written bytes
+	 */
+	ASN1_Codec::SIZE_TYPE ASN1_Codec::EncodeEnumeratedBatch(Span<const int64> values, BYTE* destination)
+	{
+		BYTE* current = destination;
+
+		for (const int64 value : values)
+			current += WriteEnumerated(current, value);
+
+		return current - destination;
+	}
+
+	/**
+	 * Writes BOOLEAN tokens for all the values one after another.
+	 *
+	 * \param values		values to encode
+	 * \param destination	buffer of at least values.Size() * 3 bytes
+	 *
+	 * \return number of written bytes
+	 */
+	ASN1_Codec::SIZE_TYPE ASN1_Codec::EncodeBooleanBatch(Span<const bool> values, BYTE* destination)
+	{
+		BYTE* current = destination;
+
+		for (const bool value : values)
+			current += WriteBoolean(current, value);
+
+		return current - destination;
+	}
+
+	/**
+	 * Reads two's complement INTEGER/ENUMERATED content.
+	 *
+	 * \param content		content bytes
+	 * \param length		number of content bytes
+	 * \param[out] value	decoded value
+	 *
+	 * \return false if the content is empty or does not fit in 64 bits
+	 */
+	bool ASN1_Codec::ReadIntegerContent(const BYTE* content, SIZE_TYPE length, int64& value)
+	{
+		if (length == 0 || length > sizeof(int64))
+			return false;
+
+		// the first byte is sign extended, the rest are shifted in
+		uint64 result = static_cast<uint64>(static_cast<int64>(static_cast<int8>(content[0])));
+
+		for (SIZE_TYPE i = 1; i < length; ++i)
+			result = (result << 8) | static_cast<uint8>(content[i]);
+
+		value = static_cast<int64>(result);
+		return true;
+	}
+
+	/**
+	 * Checks INTEGER/ENUMERATED content is minimal as DER requires: the first nine bits are neither all zeros nor all ones.
+	 *
+	 * \param content		content bytes
+	 * \param length		number of content bytes
+	 *
+	 * \return false if the first byte only repeats the sign of the second one
+	 */
+	bool ASN1_Codec::IsMinimalIntegerContent(const BYTE* content, SIZE_TYPE length)
+	{
+		if (length < 2)
+			return true;
+
+		const uint8 first = static_cast<uint8>(content[0]);
+		const bool bIsNegative = (static_cast<uint8>(content[1]) & 0x80) != 0;
+
+		// 00 0xxxxxxx and FF 1xxxxxxx only sign extend the second byte
+		const bool bIsRedundantZero = first == 0x00 && !bIsNegative;
+		const bool bIsRedundantOnes = first == 0xFF && bIsNegative;
+
+		return !bIsRedundantZero && !bIsRedundantOnes;
+	}
+
+	/**
+	 * Reads BOOLEAN content. Any non-zero octet is TRUE.
+	 *
+	 * \param content		content bytes
+	 * \param length		number of content bytes
+	 * \param[out] value	decoded value
+	 *
+	 * \return false if the content is not exactly one byte
+	 */
+	bool ASN1_Codec::ReadBooleanContent(const BYTE* content, SIZE_TYPE length, bool& value)
+	{
+		if (length != 1)
+			return false;
+
+		value = content[0] != 0;
+		return true;
 	}
 
 	/**
-	 * Takes a token and sets length field.
+	 * Takes a token and sets length field right in front of the content.
 	 * To get fully encoded token should also construct identifier octet and encode value content.
+	 * Identifier octets written before are moved to stay in front of the length.
 	 *
 	 * \param goal		token structure that contains token data
 	 * \param length	length of the content in bytes
 	 */
 	void ASN1_Codec::ConstructLengthField(ASN1EncodedToken& goal, SIZE_TYPE length) 
 	{
-		goal.Length.Value = length;
-		// 7 bits max unsigned int value
-		if (length <= MAX_INT8)
+		const uint8 size = GetLengthFieldSize(length);
+		BYTE* const end = goal.GetHeaderEnd();
+
+		if (goal.IdentifierSize > 0 && size != goal.LengthSize)
+			std::memmove(end - size - goal.IdentifierSize, end - goal.LengthSize - goal.IdentifierSize, goal.IdentifierSize);
+
+		goal.LengthValue = length;
+		goal.LengthSize = size;
+
+		WriteLengthField(end - size, length);
+	}
+
+	/**
+	 * Returns number of bytes ConstructLengthField/WriteLengthField use for the length.
+	 * DER form is branchless: 1 for short form, otherwise 1 + number of significant bytes of the length.
+	 *
+	 * \param length	length of the content in bytes
+	 * \param form		how long form is sized
+	 */
+	uint8 ASN1_Codec::GetLengthFieldSize(SIZE_TYPE length, EASN1LengthForm form)
+	{
+		if (form == EASN1LengthForm::BUCKETED)
+			return (length < 128) ? 1 : (length <= 0xFFFFull) ? 3 : (length <= 0xFFFFFFFFull) ? 5 : 9;
+
+		// | 1 keeps clz defined for 0, long form bytes are added only for lengths above 127
+		const uint8 significant_bytes = static_cast<uint8>((64 - Bits::CountLeadingZeros(static_cast<uint64>(length) | 1) + 7) / 8);
+
+		return 1 + (length >= 128) * significant_bytes;
+	}
+
+	/**
+	 * Writes length field without allocating anything.
+	 * Short form if length is less than 128, otherwise long form: 0x80 | number of length bytes
+	 * followed by big endian length.
+	 *
+	 * \param destination	buffer of at least GetLengthFieldSize(length, form) bytes
+	 * \param length		length of the content in bytes
+	 * \param form			how long form is sized
+	 *
+	 * \return number of written bytes
+	 */
+	uint8 ASN1_Codec::WriteLengthField(BYTE* destination, SIZE_TYPE length, EASN1LengthForm form)
+	{
+		const uint8 size = GetLengthFieldSize(length, form);
+
+		if (size == 1)
 		{
-			goal.Length.NumberOfEncodedBytes = 1;
-			goal.Length.EncodedLengthSequence = new BYTE();
 			// safe casting because length fits in 1 byte
-			*goal.Length.EncodedLengthSequence = static_cast<uint8>(length);
+			destination[0] = static_cast<uint8>(length);
+			return size;
 		}
-		else if (length <= MAX_UINT16)
+
+		destination[0] = static_cast<BYTE>(0b10000000 | (size - 1));
+
+		// the last size - 1 bytes of the big endian value are the length bytes
+		const uint64 big_endian_length = Endian::native_to_big<uint64>(static_cast<uint64>(length));
+		std::memcpy(destination + 1, reinterpret_cast<const BYTE*>(&big_endian_length) + sizeof(uint64) - (size - 1), size - 1);
+
+		return size;
+	}
+
+	/**
+	 * Returns identifier octet for a tag number that fits in 5 bits.
+	 *
+	 * \param value_type	type of token value
+	 * \param class_type	type of identifier octet class
+	 * \param pc_type		type of pc field (primitive / constructed)
+	 */
+	uint8 ASN1_Codec::GetIdentifierOctet(EASN1ValueType value_type, EASN1ClassTagType class_type, EASN1PCType pc_type)
+	{
+		uint8 tag_number = static_cast<uint8>(value_type);
+
+		// if size >= 31 last 5 bits should be equal to 1
+		tag_number = (tag_number >= 31) ? 0b00011111 : static_cast<uint8>(tag_number);
+
+		return static_cast<uint8>(class_type) | static_cast<uint8>(pc_type) | tag_number;
+	}
+
+	/**
+	 * Writes identifier and length octets without allocating anything.
+	 *
+	 * \param destination	buffer of at least MaxHeaderSize bytes
+	 * \param value_type	type of token value
+	 * \param class_type	type of identifier octet class
+	 * \param pc_type		type of pc field (primitive / constructed)
+	 * \param length		length of the content in bytes
+	 *
+	 * \return number of written bytes
+	 */
+	uint8 ASN1_Codec::WriteHeader(BYTE* destination, EASN1ValueType value_type, EASN1ClassTagType class_type, EASN1PCType pc_type, SIZE_TYPE length)
+	{
+		destination[0] = GetIdentifierOctet(value_type, class_type, pc_type);
+
+		return 1 + WriteLengthField(destination + 1, length);
+	}
+
+	/**
+	 * Writes identifier and length octets of a constructed token with indefinite length.
+	 * Content has to be finished with WriteEndOfContents.
+	 *
+	 * \param destination	buffer of at least MaxHeaderSize bytes
+	 * \param value_type	type of token value
+	 * \param class_type	type of identifier octet class
+	 *
+	 * \return number of written bytes
+	 */
+	uint8 ASN1_Codec::WriteIndefiniteHeader(BYTE* destination, EASN1ValueType value_type, EASN1ClassTagType class_type)
+	{
+		destination[0] = GetIdentifierOctet(value_type, class_type, EASN1PCType::CONSTRUCTED);
+		destination[1] = static_cast<BYTE>(0b10000000);
+
+		return 2;
+	}
+
+	/// Writes end-of-contents octets (two zero bytes). Returns number of written bytes.
+	uint8 ASN1_Codec::WriteEndOfContents(BYTE* destination)
+	{
+		destination[0] = 0;
+		destination[1] = 0;
+
+		return 2;
+	}
+
+	/**
+	 * Encodes input of unknown size as a constructed octet string with indefinite length.
+	 * Input is gathered into chunks of chunk_size bytes and every chunk becomes one primitive octet string segment,
+	 * only the last one may be shorter. The stream ends with end-of-contents octets. Memory use is one chunk,
+	 * the first segment is passed to the sink as soon as the first chunk is full.
+	 *
+	 * \param input			input file (pipe, terminal or regular file)
+	 * \param chunk_size	size of every segment but the last one
+	 * \param sink			receives the header, every segment and end-of-contents octets
+	 *
+	 * \return false if reading failed or the sink stopped encoding
+	 */
+	bool ASN1_Codec::EncodeStream(System::PlatformFile& input, SIZE_TYPE chunk_size, const SINK_TYPE& sink)
+	{
+		return EncodeStream([&input](BYTE* destination, SIZE_TYPE count) { return input.Read(destination, count); }, chunk_size, sink);
+	}
+
+	/**
+	 * EncodeStream reading from a source, e.g. a decoder of text input.
+	 *
+	 * \param source		gives the input piece by piece
+	 * \param chunk_size	size of every segment but the last one
+	 * \param sink			receives the header, every segment and end-of-contents octets
+	 *
+	 * \return false if the source failed or the sink stopped encoding
+	 */
+	bool ASN1_Codec::EncodeStream(const SOURCE_TYPE& source, SIZE_TYPE chunk_size, const SINK_TYPE& sink)
+	{
+		// room for the segment header is reserved in front of the chunk, so the chunk is never moved
+		std::unique_ptr<BYTE[]> buffer(new BYTE[MaxHeaderSize + chunk_size]);
+		BYTE* const chunk = buffer.get() + MaxHeaderSize;
+
+		BYTE header[MaxHeaderSize];
+		if (!sink(header, WriteIndefiniteHeader(header, EASN1ValueType::OctetString, EASN1ClassTagType::UNIVERSAL)))
+			return false;
+
+		int64 received = 1;
+		while (received > 0)
 		{
-			goal.Length.NumberOfEncodedBytes = 3;
-			goal.Length.EncodedLengthSequence = new BYTE[3];
-			goal.Length.EncodedLengthSequence[0] = 0b10000010;
+			// short reads of a pipe are gathered until the chunk is full, so only the last segment is shorter
+			SIZE_TYPE filled = 0;
+			while (filled < chunk_size && (received = source(chunk + filled, chunk_size - filled)) > 0)
+				filled += received;
+
+			if (received < 0)
+				return false;
+
+			if (filled == 0)
+				break;
+
+			const uint8 header_size = 1 + GetLengthFieldSize(filled);
+			BYTE* const segment = chunk - header_size;
 
-			uint16 big_endian_length = Endian::native_to_big<uint16>(length);
-			std::memcpy(goal.Length.EncodedLengthSequence + 1, &big_endian_length, goal.Length.NumberOfEncodedBytes - 1);
+			WriteHeader(segment, EASN1ValueType::OctetString, EASN1ClassTagType::UNIVERSAL, EASN1PCType::PRIMITIVE, filled);
+
+			if (!sink(segment, header_size + filled))
+				return false;
 		}
-		else if (length <= MAX_UINT32)
+
+		return sink(header, WriteEndOfContents(header));
+	}
+
+	/**
+	 * Encodes the whole input as one primitive octet string of definite length. Binary safe: the input is read
+	 * in large blocks until the end of file. Size of a regular file is known up front, so the header goes first
+	 * and one block is reused; any other input is kept block by block (never moved) until its end fixes the length.
+	 *
+	 * \param input	input file (pipe, terminal or regular file)
+	 * \param sink	receives the header and then the content block by block
+	 *
+	 * \return false if reading failed, a regular file is shorter than its size or the sink stopped encoding
+	 */
+	bool ASN1_Codec::EncodeStreamDefinite(System::PlatformFile& input, const SINK_TYPE& sink)
+	{
+		constexpr SIZE_TYPE block_size = System::PlatformFile::CopyBufferSize;
+
+		BYTE header[MaxHeaderSize];
+		const int64 size = input.Size();
+
+		if (size >= 0)
+		{
+			if (!sink(header, WriteHeader(header, EASN1ValueType::OctetString, EASN1ClassTagType::UNIVERSAL, EASN1PCType::PRIMITIVE, size)))
+				return false;
+
+			std::unique_ptr<BYTE[]> block(new BYTE[std::min<uint64>(block_size, size)]);
+
+			for (uint64 remaining = size; remaining > 0; )
+			{
+				const int64 received = input.Read(block.get(), std::min<uint64>(remaining, block_size));
+
+				if (received <= 0 || !sink(block.get(), received))
+					return false;
+
+				remaining -= received;
+			}
+
+			return true;
+		}
+
+		// pipes and terminals: the length is known only at the end of input
+		return EncodeStreamDefinite([&input](BYTE* destination, SIZE_TYPE count) { return input.Read(destination, count); }, sink);
+	}
+
+	/**
+	 * EncodeStreamDefinite reading from a source of unknown size: the input is kept block by block until its end.
+	 *
+	 * \param source	gives the input piece by piece
+	 * \param sink		receives the header and then the content block by block
+	 *
+	 * \return false if the source failed or the sink stopped encoding
+	 */
+	bool ASN1_Codec::EncodeStreamDefinite(const SOURCE_TYPE& source, const SINK_TYPE& sink)
+	{
+		constexpr SIZE_TYPE block_size = System::PlatformFile::CopyBufferSize;
+
+		BYTE header[MaxHeaderSize];
+		std::vector<std::unique_ptr<BYTE[]>> blocks;
+		SIZE_TYPE last_block_size = block_size;
+		uint64 total_size = 0;
+		int64 received;
+
+		for (;;)
+		{
+			if (last_block_size == block_size)
+			{
+				blocks.emplace_back(new BYTE[block_size]);
+				last_block_size = 0;
+			}
+
+			if ((received = source(blocks.back().get() + last_block_size, block_size - last_block_size)) <= 0)
+				break;
+
+			last_block_size += received;
+			total_size += received;
+		}
+
+		if (received < 0 || !sink(header, WriteHeader(header, EASN1ValueType::OctetString, EASN1ClassTagType::UNIVERSAL, EASN1PCType::PRIMITIVE, total_size)))
+			return false;
+
+		for (SIZE_T i = 0; i < blocks.size(); ++i)
+		{
+			const SIZE_TYPE filled = (i + 1 == blocks.size()) ? last_block_size : block_size;
+
+			if (filled > 0 && !sink(blocks[i].get(), filled))
+				return false;
+		}
+
+		return true;
+	}
+
+	/**
+	 * Sizing pass of batch encoding. Returns number of bytes all the inputs take
+	 * when encoded as octet strings one after another.
+	 *
+	 * \param inputs content of every token
+	 */
+	ASN1_Codec::SIZE_TYPE ASN1_Codec::GetOctetStringBatchSize(Span<const ConstBuffer> inputs)
+	{
+		SIZE_TYPE total = 0;
+
+		for (const ConstBuffer& input : inputs)
+			total += 1 + GetLengthFieldSize(input.Size) + input.Size;
+
+		return total;
+	}
+
+	/**
+	 * Filling pass of batch encoding. Writes all the inputs as primitive octet strings
+	 * one after another. Nothing is allocated.
+	 *
+	 * \param inputs		content of every token
+	 * \param class_type	class type of every token
+	 * \param destination	buffer of at least GetOctetStringBatchSize(inputs) bytes
+	 * \param offsets		optional array of inputs.Size() elements that receives offset of every token
+	 *
+	 * \return number of written bytes
+	 */
+	ASN1_Codec::SIZE_TYPE ASN1_Codec::EncodeOctetStringBatch(Span<const ConstBuffer> inputs, EASN1ClassTagType class_type, BYTE* destination, SIZE_TYPE* offsets)
+	{
+		const BYTE identifier = GetIdentifierOctet(EASN1ValueType::OctetString, class_type, EASN1PCType::PRIMITIVE);
+		BYTE* current = destination;
+
+		for (SIZE_T i = 0; i < inputs.Size(); ++i)
 		{
-			goal.Length.NumberOfEncodedBytes = 5;
-			goal.Length.EncodedLengthSequence = new BYTE[5];
-			goal.Length.EncodedLengthSequence[0] = 0b10000101;
+			if (offsets)
+				offsets[i] = current - destination;
 
-			uint32 big_endian_length = Endian::native_to_big<uint32>(length);
-			std::memcpy(goal.Length.EncodedLengthSequence + 1, &big_endian_length, goal.Length.NumberOfEncodedBytes - 1);
+			*current++ = identifier;
+			current += WriteLengthField(current, inputs[i].Size);
+
+			if (inputs[i].Size > 0)
+				std::memcpy(current, inputs[i].Data, inputs[i].Size);
+			current += inputs[i].Size;
 		}
-		// does not support 128-bit integers and more
-		else
+
+		return current - destination;
+	}
+
+	/**
+	 * Encodes all the inputs as primitive octet strings into one contiguous buffer.
+	 * Output vector is resized (not shrunk), so reusing it between batches avoids allocations at all.
+	 *
+	 * \param inputs		content of every token
+	 * \param class_type	class type of every token
+	 * \param output		receives encoded tokens one after another
+	 *
+	 * \return number of written bytes
+	 */
+	ASN1_Codec::SIZE_TYPE ASN1_Codec::EncodeOctetStringBatch(Span<const ConstBuffer> inputs, EASN1ClassTagType class_type, std::vector<BYTE>& output)
+	{
+		output.resize(GetOctetStringBatchSize(inputs));
+
+		return EncodeOctetStringBatch(inputs, class_type, output.data(), nullptr);
+	}
+
+	/**
+	 * Returns number of identifier bytes (leading octet and base-128 tag number groups) for a tag number.
+	 *
+	 * \param tag_number any tag number
+	 */
+	uint8 ASN1_Codec::GetIdentifierSize(uint64 tag_number)
+	{
+		if (tag_number < Private::IdentifierTableSize)
+			return Private::IdentifierTable[tag_number].Size;
+
+		return ASN1Rules::IdentifierSize(tag_number);
+	}
+
+	/**
+	 * Writes identifier octets for any tag number of any class.
+	 * Tag numbers of at most 3 identifier bytes are copied from a table built at compile time.
+	 *
+	 * \param destination	buffer of at least MaxIdentifierSize bytes (4 bytes are always touched)
+	 * \param class_type	type of identifier octet class
+	 * \param pc_type		type of pc field (primitive / constructed)
+	 * \param tag_number	tag number
+	 *
+	 * \return number of written bytes
+	 */
+	uint8 ASN1_Codec::WriteIdentifier(BYTE* destination, EASN1ClassTagType class_type, EASN1PCType pc_type, uint64 tag_number)
+	{
+		const uint8 class_pc_bits = static_cast<uint8>(class_type) | static_cast<uint8>(pc_type);
+
+		if (tag_number < Private::IdentifierTableSize)
 		{
-			goal.Length.NumberOfEncodedBytes = 9;
-			goal.Length.EncodedLengthSequence = new BYTE[9];
-			goal.Length.EncodedLengthSequence[0] = 0b100001000;
+			const Private::IdentifierTableEntry& entry = Private::IdentifierTable[tag_number];
+
+			std::memcpy(destination, &entry, sizeof(entry));
+			destination[0] |= class_pc_bits;
 
-			uint64 big_endian_length = Endian::native_to_big<uint64>(length);
-			std::memcpy(goal.Length.EncodedLengthSequence + 1, &big_endian_length, goal.Length.NumberOfEncodedBytes - 1);
+			return entry.Size;
 		}
+
+		ASN1Rules::WriteIdentifier(destination, class_pc_bits, tag_number);
+
+		return ASN1Rules::IdentifierSize(tag_number);
+	}
+
+	/**
+	 * Writes identifier and length octets for any tag number without allocating anything.
+	 *
+	 * \param destination	buffer of at least MaxHeaderSize bytes
+	 * \param class_type	type of identifier octet class
+	 * \param pc_type		type of pc field (primitive / constructed)
+	 * \param tag_number	tag number
+	 * \param length		length of the content in bytes
+	 *
+	 * \return number of written bytes
+	 */
+	uint8 ASN1_Codec::WriteTaggedHeader(BYTE* destination, EASN1ClassTagType class_type, EASN1PCType pc_type, uint64 tag_number, SIZE_TYPE length)
+	{
+		const uint8 identifier_size = WriteIdentifier(destination, class_type, pc_type, tag_number);
+
+		return identifier_size + WriteLengthField(destination + identifier_size, length);
+	}
+
+	/**
+	 * Encodes a primitive or constructed token with an explicit tag number of any class.
+	 * Content is copied as it is (octet string encoding).
+	 *
+	 * \param class_type class type
+	 * \param pc_type	 primitive/constructed
+	 * \param tag_number tag number, numbers above 30 use the high tag number form
+	 * \param source	 content stream
+	 * \param length	 length of the content
+	 * \param arena		 storage of the token bytes, nullptr takes them from the heap
+	 *
+	 * \return ASN1_Codec::ASN1EncodedToken structure that represents the token
+	 */
+	ASN1_Codec::ASN1EncodedToken ASN1_Codec::EncodeTaggedToken(EASN1ClassTagType class_type, EASN1PCType pc_type, uint64 tag_number, const void* source, SIZE_TYPE length, System::MonotonicArena* arena)
+	{
+		ASN1EncodedToken goal(EASN1ValueType::OctetString, length, arena);
+
+		EncodeOctetString(goal, source, length);
+		ConstructLengthField(goal, length);
+		ConstructIdentifier(goal, class_type, pc_type, tag_number);
+
+		return goal;
+	}
+
+	/**
+	 * Takes a token and sets identifier octets for any tag number in front of the length field.
+	 * Base-128 tag number groups follow the leading octet if the number does not fit in 5 bits.
+	 *
+	 * \param goal			token structure that contains token data
+	 * \param class_type	type of identifier octet class
+	 * \param pc_type		type of pc field (primitive / constructed)
+	 * \param tag_number	tag number
+	 */
+	void ASN1_Codec::ConstructIdentifier(ASN1EncodedToken& goal, EASN1ClassTagType class_type, EASN1PCType pc_type, uint64 tag_number)
+	{
+		// WriteIdentifier may copy a whole table entry, so it never writes right in front of the length
+		BYTE identifier[MaxIdentifierSize];
+		const uint8 size = WriteIdentifier(identifier, class_type, pc_type, tag_number);
+
+		std::memcpy(goal.GetHeaderEnd() - goal.LengthSize - size, identifier, size);
+		goal.IdentifierSize = size;
 	}
 
 	/// 
@@ -143,12 +1063,89 @@ namespace Real { namespace Codecs {
 	/// \param pc_type		type of pc field (primitive / constructed)
 	void ASN1_Codec::ConstructIdentifierOctet(ASN1EncodedToken& goal, ASN1CodecOptions::EASN1ValueType value_type, ASN1CodecOptions::EASN1ClassTagType class_type, ASN1CodecOptions::EASN1PCType pc_type)
 	{
-		uint8 tag_number = static_cast<uint8>(value_type);
+		BYTE* const identifier = goal.GetHeaderEnd() - goal.LengthSize - 1;
 
-		// if size >= 31 last 5 bits should be equal to 1
-		tag_number = (tag_number >= 31) ? 0b00011111 : static_cast<uint8>(tag_number);
-		
-		goal.Identifier.IdentifierOctet.Content = static_cast<uint8>(class_type) | static_cast<uint8>(pc_type) | tag_number;
+		*identifier = static_cast<BYTE>(GetIdentifierOctet(value_type, class_type, pc_type));
+		goal.IdentifierSize = 1;
+	}
+
+
+	/**
+	 * Copies identifier and length bytes to the destination.
+	 *
+	 * \param destination buffer of at least GetHeaderBytesCount() bytes
+	 *
+	 * \return number of copied bytes
+	 */
+	ASN1_Codec::SIZE_TYPE ASN1_Codec::ASN1EncodedToken::CopyHeaderTo(BYTE* destination) const
+	{
+		const SIZE_TYPE size = GetHeaderBytesCount();
+
+		std::memcpy(destination, GetHeaderBytes(), size);
+
+		return size;
+	}
+
+
+	/**
+	 * Describes the token as scatter-gather buffers: one buffer if it is contiguous,
+	 * header and content otherwise. Buffers stay valid while the token lives.
+	 *
+	 * \param vectors array to fill
+	 *
+	 * \return number of filled buffers
+	 */
+	int32 ASN1_Codec::ASN1EncodedToken::GetIOVectors(System::IOVector (&vectors)[MaxIOVectors]) const
+	{
+		vectors[0].iov_base = const_cast<BYTE*>(GetHeaderBytes());
+
+		if (IsContiguous())
+		{
+			vectors[0].iov_len = GetEncodedSize();
+			return 1;
+		}
+
+		vectors[0].iov_len = GetHeaderBytesCount();
+
+		vectors[1].iov_base = const_cast<BYTE*>(Content);
+		vectors[1].iov_len = ContentSize;
+
+		return 2;
+	}
+
+	/**
+	 * Writes the whole token at the current file position with a single write call
+	 * (more calls only if the kernel accepts a part of the data).
+	 *
+	 * \param file file opened for writing
+	 *
+	 * \return false if not all the bytes could be written
+	 */
+	bool ASN1_Codec::ASN1EncodedToken::WriteTo(System::PlatformFile& file) const
+	{
+		if (IsContiguous())
+			return file.WriteAll(GetHeaderBytes(), GetEncodedSize());
+
+		System::IOVector vectors[MaxIOVectors];
+		const int32 count = GetIOVectors(vectors);
+
+		return file.WriteVectors(vectors, count);
+	}
+
+	/**
+	 * Writes the whole token at the given offset with a single positional write. File position is not changed.
+	 *
+	 * \param file		file opened for writing
+	 * \param offset	position of the first identifier byte in the file
+	 *
+	 * \return false if not all the bytes could be written
+	 */
+	bool ASN1_Codec::ASN1EncodedToken::WriteTo(System::PlatformFile& file, uint64 offset) const
+	{
+		System::IOVector vectors[MaxIOVectors];
+		const int32 count = GetIOVectors(vectors);
+
+		return file.WriteVectorsAt(vectors, count, offset);
 	}
 
 
@@ -162,19 +1159,18 @@ namespace Real { namespace Codecs {
 	*/
 	std::ostream& operator << (std::ostream& stream, const ASN1_Codec::ASN1EncodedToken& token)
 	{
-		stream << token.GetIdentifier().Content;
+		if (token.IsContiguous())
+			return stream.write(token.GetHeaderBytes(), token.GetEncodedSize());
 
-		for (ASN1_Codec::SIZE_TYPE i = 0; i < token.GetLengthBytesCount(); ++i)
-		{
-			stream << token.GetLengthBytes()[i];
-		}
-
-		for (ASN1_Codec::SIZE_TYPE i = 0; i < token.GetContentBytesCount(); ++i)
-		{
-			stream << token.GetContentBytes()[i];
-		}
+		stream.write(token.GetHeaderBytes(), token.GetHeaderBytesCount());
+		stream.write(token.GetContentBytes(), token.GetContentBytesCount());
 
 		return stream;
 	}
 
+	// compile time headers and runtime encoder have to agree
+	static_assert(ASN1UniversalHeader<EASN1ValueType::OctetString, 5>::Bytes[0] == 0x04 && ASN1UniversalHeader<EASN1ValueType::OctetString, 5>::Bytes[1] == 0x05, "ASN1Header: wrong short form header");
+	static_assert(ASN1Header<EASN1ClassTagType::APPLICATION, EASN1PCType::PRIMITIVE, 200, 300>::Size == 3 + 3, "ASN1Header: wrong long form header size");
+	static_assert(ASN1UniversalHeader<EASN1ValueType::OctetString, 200>::Bytes[1] == static_cast<BYTE>(0x81) && ASN1UniversalHeader<EASN1ValueType::OctetString, 200>::Size == 3, "ASN1Header: long form length is not minimal");
+
 } }
@@ -3,10 +3,20 @@
 
 #include "../Core.h"
 #include "ICodec.h"
+#include "../Platform/PlatformFile.h"
+#include "../Platform/MonotonicArena.h"
+#include "../Misc/Span.hpp"
+#include <cstring>
+#include <vector>
+#include <string>
+#include <functional>
 
 #define ASN1_CODEC_USED
 
 
+namespace Real { namespace System { class WorkerPool; } }
+
+
 namespace Real { namespace Codecs {
 
 	
@@ -42,6 +52,8 @@ namespace Real { namespace Codecs {
 			Real,
 			Enumerated,
 			EmbeddedPDV,
+			Sequence = 16,	///< SEQUENCE and SEQUENCE OF, always constructed
+			Set,			///< SET and SET OF, always constructed
 			// ... lots of other types, no support for them now
 			MaxASN1Values
 		};
@@ -69,6 +81,16 @@ namespace Real { namespace Codecs {
 		};
 
 
+		/**
+		 * How long form length fields are sized.
+		 */
+		enum class EASN1LengthForm : uint8
+		{
+			DER,		///< minimal number of length bytes, required by DER
+			BUCKETED,	///< 2, 4 or 8 length bytes, accepted by BER decoders only
+		};
+
+
 		/// Union that allows operations on identifier octet
 		union IDENTIFIER_OCTET
 		{
@@ -111,6 +133,13 @@ namespace Real { namespace Codecs {
 		typedef uint64 SIZE_TYPE;
 		class ASN1EncodedToken;
 
+		/// Read-only content buffer passed to batch functions.
+		struct ConstBuffer
+		{
+			const void* Data;
+			SIZE_TYPE	Size;
+		};
+
 	public:
 		
 
@@ -125,12 +154,700 @@ namespace Real { namespace Codecs {
 		 * \param value_type type of value the token stores
 		 * \param class_type class type
 		 * \param pc_type	 primitive/constructed
+		 * \param source	 content stream: bytes for OctetString, native signed integer for Integer/Enumerated,
+		 *					 one byte for Boolean, ignored for Null, dotted decimal text for ObjectIdentifier,
+		 *					 one byte per bit for BitString (bool or uint8, any non-zero byte is set),
+		 *					 native float or double for Real
+		 * \param length	 length of the content (size of the integer: 1, 2, 4 or 8 for Integer/Enumerated,
+		 *					 number of characters for ObjectIdentifier, number of bits for BitString,
+		 *					 size of the value: 4 or 8 for Real)
+		 * \param arena		 storage of the token bytes, nullptr takes them from the heap
+		 * 
+		 * \return ASN1_Codec::ASN1EncodedToken structure that represents the token
+		 */
+		static ASN1EncodedToken EncodeToken(ASN1CodecOptions::EASN1ValueType value_type, ASN1CodecOptions::EASN1ClassTagType class_type, ASN1CodecOptions::EASN1PCType pc_type, const void* source, SIZE_TYPE length, System::MonotonicArena* arena = nullptr);
+
+		/**
+		 * Encodes a primitive or constructed token with an explicit tag number of any class.
+		 * Content is copied as it is (octet string encoding).
+		 *
+		 * \param class_type class type
+		 * \param pc_type	 primitive/constructed
+		 * \param tag_number tag number, numbers above 30 use the high tag number form
 		 * \param source	 content stream
 		 * \param length	 length of the content
-		 * 
+		 * \param arena		 storage of the token bytes, nullptr takes them from the heap
+		 *
 		 * \return ASN1_Codec::ASN1EncodedToken structure that represents the token
 		 */
-		static ASN1EncodedToken EncodeToken(ASN1CodecOptions::EASN1ValueType value_type, ASN1CodecOptions::EASN1ClassTagType class_type, ASN1CodecOptions::EASN1PCType pc_type, const void* source, SIZE_TYPE length);
+		static ASN1EncodedToken EncodeTaggedToken(ASN1CodecOptions::EASN1ClassTagType class_type, ASN1CodecOptions::EASN1PCType pc_type, uint64 tag_number, const void* source, SIZE_TYPE length, System::MonotonicArena* arena = nullptr);
+
+		/**
+		 * Encodes an octet string token that does not copy the content.
+		 * Only identifier and length octets are built, content pointer refers to the source,
+		 * so the source must outlive the returned token.
+		 *
+		 * \param class_type class type
+		 * \param source	 content stream
+		 * \param length	 length of the content
+		 * \param arena		 storage of the header bytes, nullptr takes them from the heap
+		 *
+		 * \return ASN1_Codec::ASN1EncodedToken structure that views the source
+		 */
+		static ASN1EncodedToken EncodeOctetStringView(ASN1CodecOptions::EASN1ClassTagType class_type, const void* source, SIZE_TYPE length, System::MonotonicArena* arena = nullptr);
+
+		/**
+		 * Encodes only identifier and length octets of a token. Content is left empty,
+		 * so it can be written by the caller right after the header.
+		 *
+		 * \param value_type type of value the token stores
+		 * \param class_type class type
+		 * \param pc_type	 primitive/constructed
+		 * \param length	 length of the content that will follow the header
+		 * \param arena		 storage of the header bytes, nullptr takes them from the heap
+		 *
+		 * \return ASN1_Codec::ASN1EncodedToken structure without content
+		 */
+		static ASN1EncodedToken EncodeHeader(ASN1CodecOptions::EASN1ValueType value_type, ASN1CodecOptions::EASN1ClassTagType class_type, ASN1CodecOptions::EASN1PCType pc_type, SIZE_TYPE length, System::MonotonicArena* arena = nullptr);
+
+		/**
+		 * Encodes the whole content of a regular file as a primitive octet string with universal tag.
+		 * Only the header is built in user space, the content is moved from file to file by the kernel
+		 * (see System::TransferFileContent).
+		 *
+		 * \param input	regular file opened for reading, its size is taken from fstat
+		 * \param output	file opened for writing
+		 *
+		 * \return false if input size is unknown or not all the bytes could be written
+		 */
+		static bool EncodeFile(System::PlatformFile& input, System::PlatformFile& output);
+
+		/**
+		 * Same as EncodeFile, but nothing is allocated: a file that fits in the buffer together with the header
+		 * is read once and written with its header in one call, larger files are moved by the kernel
+		 * and the buffer is only used if kernel-side copying is not supported.
+		 *
+		 * \param input	regular file opened for reading, its size is taken from fstat
+		 * \param output	file opened for writing
+		 * \param buffer	scratch memory of the calling thread
+		 *
+		 * \return false if input size is unknown, the file is shorter than its size or not all the bytes could be written
+		 */
+		static bool EncodeFile(System::PlatformFile& input, System::PlatformFile& output, Span<BYTE> buffer);
+
+		/// Input bytes one job of EncodeFileParallel moves, also the size of every worker's buffer.
+		static constexpr SIZE_TYPE ParallelSliceSize = 1 << 23;
+
+		/**
+		 * Encodes the whole content of a regular file as an octet string using all workers of the pool.
+		 * The header and the output offset of every slice are computed up front, so each worker reads its slice
+		 * and writes it at its final place (pread/pwrite) independently of the others.
+		 * With segment_size 0 the result is one primitive octet string (DER), otherwise it is a constructed
+		 * octet string of definite length made of primitive segments of segment_size bytes (the last one may be shorter).
+		 *
+		 * \param input			regular file opened for reading, its size is taken from fstat
+		 * \param output		regular file opened for writing, it is written at offsets and its position is not moved
+		 * \param pool			workers to run the slices on
+		 * \param segment_size	content bytes of every segment of the constructed form, 0 for the primitive form
+		 *
+		 * \return false if input size is unknown, the file is shorter than its size or not all the bytes could be written
+		 */
+		static bool EncodeFileParallel(System::PlatformFile& input, System::PlatformFile& output, System::WorkerPool& pool, SIZE_TYPE segment_size = 0);
+
+		/**
+		 * Sizing pass of batch encoding. Returns number of bytes all the inputs take
+		 * when encoded as octet strings one after another.
+		 *
+		 * \param inputs content of every token
+		 */
+		static SIZE_TYPE GetOctetStringBatchSize(Span<const ConstBuffer> inputs);
+
+		/**
+		 * Filling pass of batch encoding. Writes all the inputs as primitive octet strings
+		 * one after another. Nothing is allocated.
+		 *
+		 * \param inputs		content of every token
+		 * \param class_type	class type of every token
+		 * \param destination	buffer of at least GetOctetStringBatchSize(inputs) bytes
+		 * \param offsets		optional array of inputs.Size() elements that receives offset of every token
+		 *
+		 * \return number of written bytes
+		 */
+		static SIZE_TYPE EncodeOctetStringBatch(Span<const ConstBuffer> inputs, ASN1CodecOptions::EASN1ClassTagType class_type, BYTE* destination, SIZE_TYPE* offsets = nullptr);
+
+		/**
+		 * Encodes all the inputs as primitive octet strings into one contiguous buffer.
+		 * Output vector is resized (not shrunk), so reusing it between batches avoids allocations at all.
+		 *
+		 * \param inputs		content of every token
+		 * \param class_type	class type of every token
+		 * \param output		receives encoded tokens one after another
+		 *
+		 * \return number of written bytes
+		 */
+		static SIZE_TYPE EncodeOctetStringBatch(Span<const ConstBuffer> inputs, ASN1CodecOptions::EASN1ClassTagType class_type, std::vector<BYTE>& output);
+
+		/**
+		 * Returns number of bytes ConstructLengthField/WriteLengthField use for the length.
+		 * DER form is branchless: 1 for short form, otherwise 1 + number of significant bytes of the length.
+		 *
+		 * \param length	length of the content in bytes
+		 * \param form		how long form is sized
+		 */
+		static uint8 GetLengthFieldSize(SIZE_TYPE length, ASN1CodecOptions::EASN1LengthForm form = ASN1CodecOptions::EASN1LengthForm::DER);
+
+		/**
+		 * Writes length field without allocating anything.
+		 * Short form if length is less than 128, otherwise long form: 0x80 | number of length bytes
+		 * followed by big endian length.
+		 *
+		 * \param destination	buffer of at least GetLengthFieldSize(length, form) bytes
+		 * \param length		length of the content in bytes
+		 * \param form			how long form is sized
+		 *
+		 * \return number of written bytes
+		 */
+		static uint8 WriteLengthField(BYTE* destination, SIZE_TYPE length, ASN1CodecOptions::EASN1LengthForm form = ASN1CodecOptions::EASN1LengthForm::DER);
+
+		/**
+		 * Returns identifier octet for a tag number that fits in 5 bits.
+		 *
+		 * \param value_type	type of token value
+		 * \param class_type	type of identifier octet class
+		 * \param pc_type		type of pc field (primitive / constructed)
+		 */
+		static uint8 GetIdentifierOctet(ASN1CodecOptions::EASN1ValueType value_type, ASN1CodecOptions::EASN1ClassTagType class_type, ASN1CodecOptions::EASN1PCType pc_type);
+
+		/// Number of bytes WriteInteger/WriteEnumerated always touch (identifier, length and 8 content bytes).
+		static constexpr SIZE_TYPE MaxIntegerTokenSize = 2 + sizeof(int64);
+
+		/**
+		 * Returns number of bytes of minimal two's complement representation of the value (1 to 8).
+		 * Branchless: the width of the value without its sign bits plus one sign bit, rounded up to bytes.
+		 *
+		 * \param value any value
+		 */
+		static uint8 GetIntegerContentSize(int64 value);
+
+		/**
+		 * Writes minimal two's complement content of the value.
+		 * Always stores 8 bytes, only the first GetIntegerContentSize(value) of them are meaningful.
+		 *
+		 * \param destination	buffer of at least 8 bytes
+		 * \param value			any value
+		 *
+		 * \return number of meaningful bytes
+		 */
+		static uint8 WriteIntegerContent(BYTE* destination, int64 value);
+
+		/**
+		 * Writes a whole INTEGER token (identifier, length and content) with universal tag.
+		 * Always touches MaxIntegerTokenSize bytes.
+		 *
+		 * \param destination	buffer of at least MaxIntegerTokenSize bytes
+		 * \param value			any value
+		 *
+		 * \return number of meaningful bytes
+		 */
+		static uint8 WriteInteger(BYTE* destination, int64 value);
+
+		/**
+		 * Writes a whole ENUMERATED token with universal tag. Same layout as WriteInteger.
+		 *
+		 * \param destination	buffer of at least MaxIntegerTokenSize bytes
+		 * \param value			any value
+		 *
+		 * \return number of meaningful bytes
+		 */
+		static uint8 WriteEnumerated(BYTE* destination, int64 value);
+
+		/// Writes a whole BOOLEAN token with universal tag (3 bytes). Returns number of written bytes.
+		static uint8 WriteBoolean(BYTE* destination, bool value);
+
+		/// Writes a whole NULL token with universal tag (2 bytes). Returns number of written bytes.
+		static uint8 WriteNull(BYTE* destination);
+
+		/**
+		 * Writes INTEGER tokens for all the values one after another.
+		 * Every token is written as a fixed MaxIntegerTokenSize store and the cursor moves only
+		 * by its real size, so there are no per-value branches or byte loops.
+		 *
+		 * \param values		values to encode
+		 * \param destination	buffer of at least values.Size() * MaxIntegerTokenSize bytes
+		 *
+		 * \return number of written bytes
+		 */
+		static SIZE_TYPE EncodeIntegerBatch(Span<const int64> values, BYTE* destination);
+
+		/**
+		 * Writes ENUMERATED tokens for all the values one after another. Same rules as EncodeIntegerBatch.
+		 *
+		 * \param values		values to encode
+		 * \param destination	buffer of at least values.Size() * MaxIntegerTokenSize bytes
+		 *
+		 * \return number of written bytes
+		 */
+		static SIZE_TYPE EncodeEnumeratedBatch(Span<const int64> values, BYTE* destination);
+
+		/**
+		 * Writes BOOLEAN tokens for all the values one after another.
+		 *
+		 * \param values		values to encode
+		 * \param destination	buffer of at least values.Size() * 3 bytes
+		 *
+		 * \return number of written bytes
+		 */
+		static SIZE_TYPE EncodeBooleanBatch(Span<const bool> values, BYTE* destination);
+
+		/**
+		 * Reads two's complement INTEGER/ENUMERATED content.
+		 *
+		 * \param content		content bytes
+		 * \param length		number of content bytes
+		 * \param[out] value	decoded value
+		 *
+		 * \return false if the content is empty or does not fit in 64 bits
+		 */
+		static bool ReadIntegerContent(const BYTE* content, SIZE_TYPE length, int64& value);
+
+		/**
+		 * Checks INTEGER/ENUMERATED content is minimal as DER requires: the first nine bits are neither all zeros nor all ones.
+		 *
+		 * \param content		content bytes
+		 * \param length		number of content bytes
+		 *
+		 * \return false if the first byte only repeats the sign of the second one
+		 */
+		static bool IsMinimalIntegerContent(const BYTE* content, SIZE_TYPE length);
+
+		/**
+		 * Reads BOOLEAN content. Any non-zero octet is TRUE.
+		 *
+		 * \param content		content bytes
+		 * \param length		number of content bytes
+		 * \param[out] value	decoded value
+		 *
+		 * \return false if the content is not exactly one byte
+		 */
+		static bool ReadBooleanContent(const BYTE* content, SIZE_TYPE length, bool& value);
+
+		/**
+		 * Returns number of content bytes of an OBJECT IDENTIFIER: the first two arcs share one subidentifier,
+		 * every subidentifier takes one byte per started 7 bits.
+		 *
+		 * \param arcs arcs of the identifier, e.g. { 1, 2, 840, 113549 }
+		 *
+		 * \return content size, 0 if the arcs are not a valid identifier
+		 *		   (less than two arcs, first arc above 2, second arc above 39 under the arcs 0 and 1)
+		 */
+		static SIZE_TYPE GetObjectIdentifierContentSize(Span<const uint64> arcs);
+
+		/**
+		 * Writes OBJECT IDENTIFIER content. Every subidentifier below 2^56 is spread into 7-bit groups,
+		 * marked with continuation bits and stored as a single 8-byte word, the cursor moves only by its real size.
+		 * Up to sizeof(uint64) bytes past the content are garbage.
+		 *
+		 * \param destination	buffer of at least GetObjectIdentifierContentSize(arcs) + sizeof(uint64) bytes
+		 * \param arcs			arcs of the identifier
+		 *
+		 * \return number of meaningful bytes, 0 if the arcs are not a valid identifier
+		 */
+		static SIZE_TYPE WriteObjectIdentifierContent(BYTE* destination, Span<const uint64> arcs);
+
+		/**
+		 * Writes a whole OBJECT IDENTIFIER token with universal tag.
+		 *
+		 * \param destination	buffer of at least MaxHeaderSize + GetObjectIdentifierContentSize(arcs) + sizeof(uint64) bytes
+		 * \param arcs			arcs of the identifier
+		 *
+		 * \return number of meaningful bytes, 0 if the arcs are not a valid identifier
+		 */
+		static SIZE_TYPE WriteObjectIdentifier(BYTE* destination, Span<const uint64> arcs);
+
+		/**
+		 * Reads OBJECT IDENTIFIER content. Ends of subidentifiers are found 16 bytes at a time from the
+		 * continuation bits, every subidentifier of up to 8 bytes is then gathered from one 8-byte load.
+		 *
+		 * \param content		content bytes
+		 * \param length		number of content bytes
+		 * \param[out] arcs		buffer of at least length + 1 arcs
+		 *
+		 * \return number of arcs, 0 if the content is empty, truncated, not minimal or an arc does not fit in 64 bits
+		 */
+		static SIZE_TYPE ReadObjectIdentifierContent(const BYTE* content, SIZE_TYPE length, uint64* arcs);
+
+		/**
+		 * Reads OBJECT IDENTIFIER content into a vector.
+		 *
+		 * \param content		content bytes
+		 * \param length		number of content bytes
+		 * \param[out] arcs		decoded arcs
+		 *
+		 * \return false if the content is malformed
+		 */
+		static bool ReadObjectIdentifierContent(const BYTE* content, SIZE_TYPE length, std::vector<uint64>& arcs);
+
+		/**
+		 * Parses dotted decimal notation of an OBJECT IDENTIFIER, e.g. "1.2.840.113549".
+		 *
+		 * \param text			characters of the identifier, not null-terminated
+		 * \param length		number of characters
+		 * \param[out] arcs		parsed arcs
+		 *
+		 * \return false if the text is not a sequence of dot separated decimal numbers without leading zeros
+		 *		   fitting in 64 bits or the arcs are not a valid identifier
+		 */
+		static bool ParseObjectIdentifier(const ANSICHAR* text, SIZE_TYPE length, std::vector<uint64>& arcs);
+
+		/// Returns dotted decimal notation of the arcs.
+		static std::string FormatObjectIdentifier(Span<const uint64> arcs);
+
+		/**
+		 * Returns number of BIT STRING content bytes: the unused bits octet and one byte per started 8 bits.
+		 *
+		 * \param bit_count number of bits
+		 */
+		static SIZE_TYPE GetBitStringContentSize(SIZE_TYPE bit_count);
+
+		/**
+		 * Writes BIT STRING content of flags, the first flag becomes the high bit of the first byte.
+		 * Flags are packed 16 at a time with a vector compare and movemask, unused bits are zero as DER requires.
+		 *
+		 * \param destination	buffer of at least GetBitStringContentSize(flags.Size()) bytes
+		 * \param flags			one flag per bool
+		 *
+		 * \return number of written bytes
+		 */
+		static SIZE_TYPE WriteBitStringContent(BYTE* destination, Span<const bool> flags);
+
+		/**
+		 * Writes BIT STRING content of byte flags, any non-zero byte is a set bit. Same layout as the bool overload.
+		 *
+		 * \param destination	buffer of at least GetBitStringContentSize(flags.Size()) bytes
+		 * \param flags			one flag per byte
+		 *
+		 * \return number of written bytes
+		 */
+		static SIZE_TYPE WriteBitStringContent(BYTE* destination, Span<const uint8> flags);
+
+		/**
+		 * Writes BIT STRING content of a bitset stored in 64-bit words: bit i of the string is bit i % 64 of word i / 64,
+		 * as std::bitset and dynamic bitsets number their bits. Bits of the last word past bit_count are ignored.
+		 *
+		 * \param destination	buffer of at least GetBitStringContentSize(bit_count) bytes
+		 * \param words			at least (bit_count + 63) / 64 words
+		 * \param bit_count		number of bits
+		 *
+		 * \return number of written bytes
+		 */
+		static SIZE_TYPE WriteBitStringContent(BYTE* destination, Span<const uint64> words, SIZE_TYPE bit_count);
+
+		/**
+		 * Writes a whole BIT STRING token with universal tag.
+		 *
+		 * \param destination	buffer of at least MaxHeaderSize + GetBitStringContentSize(flags.Size()) bytes
+		 * \param flags			one flag per bool
+		 *
+		 * \return number of written bytes
+		 */
+		static SIZE_TYPE WriteBitString(BYTE* destination, Span<const bool> flags);
+
+		/**
+		 * Writes a whole BIT STRING token with universal tag, any non-zero byte is a set bit.
+		 *
+		 * \param destination	buffer of at least MaxHeaderSize + GetBitStringContentSize(flags.Size()) bytes
+		 * \param flags			one flag per byte
+		 *
+		 * \return number of written bytes
+		 */
+		static SIZE_TYPE WriteBitString(BYTE* destination, Span<const uint8> flags);
+
+		/**
+		 * Checks BIT STRING content and returns the number of bits it holds.
+		 *
+		 * \param content			content bytes
+		 * \param length			number of content bytes
+		 * \param[out] bit_count	number of bits
+		 *
+		 * \return false if the content is empty, the unused bits octet is above 7 (or not 0 for an empty string)
+		 *		   or unused bits are not zero
+		 */
+		static bool GetBitStringBitCount(const BYTE* content, SIZE_TYPE length, SIZE_TYPE& bit_count);
+
+		/**
+		 * Reads BIT STRING content into flags of 0 or 1. Bytes are expanded 16 bits at a time.
+		 *
+		 * \param content			content bytes
+		 * \param length			number of content bytes
+		 * \param[out] flags		buffer of at least GetBitStringBitCount flags, exactly that many are written
+		 * \param[out] bit_count	number of bits
+		 *
+		 * \return false if the content is malformed, see GetBitStringBitCount
+		 */
+		static bool ReadBitStringContent(const BYTE* content, SIZE_TYPE length, bool* flags, SIZE_TYPE& bit_count);
+
+		/**
+		 * Reads BIT STRING content into byte flags of 0 or 1.
+		 *
+		 * \param content			content bytes
+		 * \param length			number of content bytes
+		 * \param[out] flags		buffer of at least GetBitStringBitCount flags, exactly that many are written
+		 * \param[out] bit_count	number of bits
+		 *
+		 * \return false if the content is malformed, see GetBitStringBitCount
+		 */
+		static bool ReadBitStringContent(const BYTE* content, SIZE_TYPE length, uint8* flags, SIZE_TYPE& bit_count);
+
+		/**
+		 * Reads BIT STRING content into a bitset stored in 64-bit words, numbered as WriteBitStringContent does.
+		 * Bits of the last word past bit_count are zero.
+		 *
+		 * \param content			content bytes
+		 * \param length			number of content bytes
+		 * \param[out] words		buffer of at least (bit_count + 63) / 64 words
+		 * \param[out] bit_count	number of bits
+		 *
+		 * \return false if the content is malformed, see GetBitStringBitCount
+		 */
+		static bool ReadBitStringContent(const BYTE* content, SIZE_TYPE length, uint64* words, SIZE_TYPE& bit_count);
+
+		/**
+		 * Reads BIT STRING content into a vector of byte flags.
+		 *
+		 * \param content		content bytes
+		 * \param length		number of content bytes
+		 * \param[out] flags	decoded flags of 0 or 1
+		 *
+		 * \return false if the content is malformed
+		 */
+		static bool ReadBitStringContent(const BYTE* content, SIZE_TYPE length, std::vector<uint8>& flags);
+
+		/// Number of bytes WriteRealContent always touches (first octet, 2-byte exponent store and 8-byte mantissa store).
+		static constexpr SIZE_TYPE MaxRealContentSize = 1 + 2 + sizeof(uint64);
+
+		/// Number of bytes WriteReal always touches (identifier, length and content).
+		static constexpr SIZE_TYPE MaxRealTokenSize = 2 + MaxRealContentSize;
+
+		/**
+		 * Returns number of REAL content bytes of the value: 0 for +0, 1 for -0, infinities and NaN,
+		 * otherwise the first octet, 1 or 2 exponent bytes and 1 to 7 mantissa bytes.
+		 *
+		 * \param value any value
+		 */
+		static uint8 GetRealContentSize(double value);
+
+		/**
+		 * Writes REAL content in the DER binary form: base 2, no scaling, odd mantissa and minimal exponent.
+		 * Mantissa and exponent come straight from the IEEE 754 bits, trailing zero bits of the mantissa move to the exponent.
+		 * Always touches MaxRealContentSize bytes, only the first GetRealContentSize(value) of them are meaningful.
+		 *
+		 * \param destination	buffer of at least MaxRealContentSize bytes
+		 * \param value			any value
+		 *
+		 * \return number of meaningful bytes
+		 */
+		static uint8 WriteRealContent(BYTE* destination, double value);
+
+		/// Writes REAL content of a float, the encoding is the same as for the equal double.
+		static uint8 WriteRealContent(BYTE* destination, float value);
+
+		/**
+		 * Writes a whole REAL token with universal tag. Always touches MaxRealTokenSize bytes.
+		 *
+		 * \param destination	buffer of at least MaxRealTokenSize bytes
+		 * \param value			any value
+		 *
+		 * \return number of meaningful bytes
+		 */
+		static uint8 WriteReal(BYTE* destination, double value);
+
+		/**
+		 * Writes REAL tokens for all the values one after another. Every token is written with fixed size stores
+		 * and the cursor moves only by its real size, like EncodeIntegerBatch does.
+		 *
+		 * \param values		values to encode
+		 * \param destination	buffer of at least values.Size() * MaxRealTokenSize bytes
+		 *
+		 * \return number of written bytes
+		 */
+		static SIZE_TYPE EncodeRealBatch(Span<const double> values, BYTE* destination);
+
+		/**
+		 * Writes REAL tokens for all the float values one after another. Same rules as the double overload.
+		 *
+		 * \param values		values to encode
+		 * \param destination	buffer of at least values.Size() * MaxRealTokenSize bytes
+		 *
+		 * \return number of written bytes
+		 */
+		static SIZE_TYPE EncodeRealBatch(Span<const float> values, BYTE* destination);
+
+		/**
+		 * Reads REAL content of the binary form with any base (2, 8, 16), scaling factor and exponent format,
+		 * and the special values. DER content of a normal double is assembled straight into its IEEE 754 bits.
+		 * Mantissas longer than 8 bytes are rounded.
+		 *
+		 * \param content		content bytes
+		 * \param length		number of content bytes
+		 * \param[out] value	decoded value, out of range values become infinities or zeros
+		 *
+		 * \return false if the content is truncated, uses the reserved base or the decimal form
+		 */
+		static bool ReadRealContent(const BYTE* content, SIZE_TYPE length, double& value);
+
+		/**
+		 * Reads REAL content into a float, the value is rounded to the nearest float.
+		 *
+		 * \param content		content bytes
+		 * \param length		number of content bytes
+		 * \param[out] value	decoded value
+		 *
+		 * \return false if the content is malformed, see the double overload
+		 */
+		static bool ReadRealContent(const BYTE* content, SIZE_TYPE length, float& value);
+
+		/// Maximum number of identifier bytes: leading octet and base-128 groups of a 64-bit tag number.
+		static constexpr SIZE_TYPE MaxIdentifierSize = 1 + 10;
+
+		/// Maximum number of header bytes: the longest identifier and the longest length field.
+		static constexpr SIZE_TYPE MaxHeaderSize = MaxIdentifierSize + 9;
+
+		/**
+		 * Returns number of identifier bytes (leading octet and base-128 tag number groups) for a tag number.
+		 *
+		 * \param tag_number any tag number
+		 */
+		static uint8 GetIdentifierSize(uint64 tag_number);
+
+		/**
+		 * Writes identifier octets for any tag number of any class.
+		 * Tag numbers of at most 3 identifier bytes are copied from a table built at compile time.
+		 *
+		 * \param destination	buffer of at least MaxIdentifierSize bytes (4 bytes are always touched)
+		 * \param class_type	type of identifier octet class
+		 * \param pc_type		type of pc field (primitive / constructed)
+		 * \param tag_number	tag number
+		 *
+		 * \return number of written bytes
+		 */
+		static uint8 WriteIdentifier(BYTE* destination, ASN1CodecOptions::EASN1ClassTagType class_type, ASN1CodecOptions::EASN1PCType pc_type, uint64 tag_number);
+
+		/**
+		 * Writes identifier and length octets for any tag number without allocating anything.
+		 *
+		 * \param destination	buffer of at least MaxHeaderSize bytes
+		 * \param class_type	type of identifier octet class
+		 * \param pc_type		type of pc field (primitive / constructed)
+		 * \param tag_number	tag number
+		 * \param length		length of the content in bytes
+		 *
+		 * \return number of written bytes
+		 */
+		static uint8 WriteTaggedHeader(BYTE* destination, ASN1CodecOptions::EASN1ClassTagType class_type, ASN1CodecOptions::EASN1PCType pc_type, uint64 tag_number, SIZE_TYPE length);
+
+		/**
+		 * Writes identifier and length octets without allocating anything.
+		 *
+		 * \param destination	buffer of at least MaxHeaderSize bytes
+		 * \param value_type	type of token value
+		 * \param class_type	type of identifier octet class
+		 * \param pc_type		type of pc field (primitive / constructed)
+		 * \param length		length of the content in bytes
+		 *
+		 * \return number of written bytes
+		 */
+		static uint8 WriteHeader(BYTE* destination, ASN1CodecOptions::EASN1ValueType value_type, ASN1CodecOptions::EASN1ClassTagType class_type, ASN1CodecOptions::EASN1PCType pc_type, SIZE_TYPE length);
+
+		/**
+		 * Writes identifier and length octets of a constructed token with indefinite length.
+		 * Content has to be finished with WriteEndOfContents.
+		 *
+		 * \param destination	buffer of at least MaxHeaderSize bytes
+		 * \param value_type	type of token value
+		 * \param class_type	type of identifier octet class
+		 *
+		 * \return number of written bytes
+		 */
+		static uint8 WriteIndefiniteHeader(BYTE* destination, ASN1CodecOptions::EASN1ValueType value_type, ASN1CodecOptions::EASN1ClassTagType class_type);
+
+		/// Writes end-of-contents octets (two zero bytes). Returns number of written bytes.
+		static uint8 WriteEndOfContents(BYTE* destination);
+
+		/// Receives encoded bytes from EncodeStream and EncodeStreamDefinite. Returns false to stop encoding.
+		typedef std::function<bool(const BYTE*, SIZE_TYPE)> SINK_TYPE;
+
+		/**
+		 * Encodes input of unknown size as a constructed octet string with indefinite length.
+		 * Input is gathered into chunks of chunk_size bytes and every chunk becomes one primitive octet string segment,
+		 * only the last one may be shorter. The stream ends with end-of-contents octets. Memory use is one chunk,
+		 * the first segment is passed to the sink as soon as the first chunk is full.
+		 *
+		 * \param input			input file (pipe, terminal or regular file)
+		 * \param chunk_size	size of every segment but the last one
+		 * \param sink			receives the header, every segment and end-of-contents octets
+		 *
+		 * \return false if reading failed or the sink stopped encoding
+		 */
+		static bool EncodeStream(System::PlatformFile& input, SIZE_TYPE chunk_size, const SINK_TYPE& sink);
+
+		/// Fills the buffer with at most count bytes of input. Returns number of bytes read, 0 at the end of input, -1 on error.
+		typedef std::function<int64(BYTE*, SIZE_TYPE)> SOURCE_TYPE;
+
+		/**
+		 * EncodeStream reading from a source, e.g. a decoder of text input.
+		 *
+		 * \param source		gives the input piece by piece
+		 * \param chunk_size	size of every segment but the last one
+		 * \param sink			receives the header, every segment and end-of-contents octets
+		 *
+		 * \return false if the source failed or the sink stopped encoding
+		 */
+		static bool EncodeStream(const SOURCE_TYPE& source, SIZE_TYPE chunk_size, const SINK_TYPE& sink);
+
+		/**
+		 * Encodes the whole input as one primitive octet string of definite length. Binary safe: the input is read
+		 * in large blocks until the end of file. Size of a regular file is known up front, so the header goes first
+		 * and one block is reused; any other input is kept block by block (never moved) until its end fixes the length.
+		 *
+		 * \param input	input file (pipe, terminal or regular file)
+		 * \param sink	receives the header and then the content block by block
+		 *
+		 * \return false if reading failed, a regular file is shorter than its size or the sink stopped encoding
+		 */
+		static bool EncodeStreamDefinite(System::PlatformFile& input, const SINK_TYPE& sink);
+
+		/**
+		 * EncodeStreamDefinite reading from a source of unknown size: the input is kept block by block until its end.
+		 *
+		 * \param source	gives the input piece by piece
+		 * \param sink		receives the header and then the content block by block
+		 *
+		 * \return false if the source failed or the sink stopped encoding
+		 */
+		static bool EncodeStreamDefinite(const SOURCE_TYPE& source, const SINK_TYPE& sink);
+
+		/**
+		 * Unwraps a sequence of encoded tokens: content of every primitive token is copied to the destination,
+		 * constructed tokens are entered. Destination of length bytes is always large enough.
+		 * Throws bad_sequence if the sequence is malformed.
+		 *
+		 * \param[in]  from		encoded tokens
+		 * \param[out] to		destination to write content bytes to
+		 * \param[in]  length	number of encoded bytes
+		 */
+		void Decode(void* from, void* to, int32 length) override;
+
+		/**
+		 * Same as Decode, but for 64-bit lengths.
+		 * Throws bad_sequence if the sequence is malformed.
+		 *
+		 * \param source		encoded tokens
+		 * \param length		number of encoded bytes
+		 * \param destination	buffer of at least length bytes
+		 *
+		 * \return number of content bytes written to the destination
+		 */
+		static SIZE_TYPE UnwrapContent(const void* source, SIZE_TYPE length, void* destination);
 
 		FORCEINLINE const TCHAR* GetCodecName() const override { return "ASN.1 Codec"; }
 
@@ -153,6 +870,8 @@ namespace Real { namespace Codecs {
 
 		class asn1_bad_sequence : public bad_sequence
 		{
+		public:
+
 			asn1_bad_sequence() : bad_sequence() { }
 
 			explicit asn1_bad_sequence(const TCHAR* const _Message) NOEXCEPT
@@ -175,6 +894,17 @@ namespace Real { namespace Codecs {
 		/// \param pc_type		type of pc field (primitive / constructed)
 		static void ConstructIdentifierOctet(ASN1EncodedToken& goal, ASN1CodecOptions::EASN1ValueType value_type, ASN1CodecOptions::EASN1ClassTagType class_type, ASN1CodecOptions::EASN1PCType pc_type);
 		
+		/**
+		 * Takes a token and sets identifier octets for any tag number.
+		 * Base-128 tag number groups are stored in the token if the number does not fit in 5 bits.
+		 *
+		 * \param goal			token structure that contains token data
+		 * \param class_type	type of identifier octet class
+		 * \param pc_type		type of pc field (primitive / constructed)
+		 * \param tag_number	tag number
+		 */
+		static void ConstructIdentifier(ASN1EncodedToken& goal, ASN1CodecOptions::EASN1ClassTagType class_type, ASN1CodecOptions::EASN1PCType pc_type, uint64 tag_number);
+
 		/**
 		 * Takes a token and sets length field.
 		 * To get fully encoded token should also construct identifier octet and encode value content.
@@ -194,8 +924,63 @@ namespace Real { namespace Codecs {
 		 */
 		static void EncodeOctetString(ASN1EncodedToken& goal, const void* source, SIZE_TYPE length);
 
+		/**
+		 * Takes a token and encodes a native signed integer of 1, 2, 4 or 8 bytes
+		 * as minimal two's complement content.
+		 *
+		 * \param goal		token structure that contains token data
+		 * \param source	native integer
+		 * \param length	size of the integer in bytes
+		 */
+		static void EncodeInteger(ASN1EncodedToken& goal, const void* source, SIZE_TYPE length);
+
+		/**
+		 * Takes a token and encodes a boolean (any non-zero byte is TRUE) as DER does: 0xFF or 0x00.
+		 *
+		 * \param goal		token structure that contains token data
+		 * \param source	one byte
+		 * \param length	has to be 1
+		 */
+		static void EncodeBoolean(ASN1EncodedToken& goal, const void* source, SIZE_TYPE length);
+
+		/**
+		 * Takes a token and encodes an OBJECT IDENTIFIER given in dotted decimal notation.
+		 * Throws bad_sequence if the text is not a valid identifier.
+		 *
+		 * \param goal		token structure that contains token data
+		 * \param source	characters of the identifier, e.g. "1.2.840.113549"
+		 * \param length	number of characters
+		 */
+		static void EncodeObjectIdentifier(ASN1EncodedToken& goal, const void* source, SIZE_TYPE length);
+
+		/**
+		 * Takes a token and packs flags (one byte each, any non-zero byte is set) into BIT STRING content.
+		 *
+		 * \param goal		token structure that contains token data
+		 * \param source	flags
+		 * \param length	number of flags
+		 */
+		static void EncodeBitString(ASN1EncodedToken& goal, const void* source, SIZE_TYPE length);
+
+		/**
+		 * Takes a token and encodes a native float or double as binary REAL content.
+		 *
+		 * \param goal		token structure that contains token data
+		 * \param source	native floating point value
+		 * \param length	size of the value in bytes: 4 or 8
+		 */
+		static void EncodeReal(ASN1EncodedToken& goal, const void* source, SIZE_TYPE length);
+
 	public:
 
+		/**
+		 * Encoded token kept in one region: identifier and length octets are stored right in front of the content,
+		 * so encoding touches one run of memory and a token that owns its content is written with a single write.
+		 *
+		 * Owned content lives in one allocation that reserves MaxHeaderSize bytes for the header in front of it.
+		 * Tokens that refer to the caller's content or have none keep the header in a small array of their own.
+		 * Header is built from its end: length octets end where the content starts, identifier octets end where length octets start.
+		 */
 		class ASN1EncodedToken
 		{
 		public:
@@ -208,93 +993,156 @@ namespace Real { namespace Codecs {
 
 			ASN1CodecOptions::EASN1ValueType	ValueType;	///< type of token value
 
+			uint8		IdentifierSize;	///< number of identifier bytes including the leading octet
 
-			struct {
+			uint8		LengthSize;		///< number of length bytes
 
-				SIZE_TYPE			Value; ///< Actual length
+			SIZE_TYPE	LengthValue;	///< actual length
 
-				/**
-				 * Fits in one byte if length is less than 128.
-				 * Otherwise it is encoded as big endian number.
-				 */
-				BYTE*				EncodedLengthSequence;
-				uint8				NumberOfEncodedBytes;
+			/**
+			 * Points right behind the header room of Storage if the token owns its content.
+			 * Otherwise refers to the caller's buffer that must outlive the token.
+			 */
+			const BYTE*	Content;
 
-			} 
-			Length;
+			SIZE_TYPE	ContentSize;
 
-			struct {
-				
-				ASN1CodecOptions::IDENTIFIER_OCTET	IdentifierOctet; ///< octet itself
-				
-				/**
-				 * nullptr if tag number fits in 5 bits.
-				 * Otherwise it is encoded in a special format.
-				 */
-				BYTE*	EncodedTagNumberBytes;
+			/// MaxHeaderSize bytes of header room followed by the owned content, nullptr if the token owns no content.
+			BYTE*		Storage;
 
-				/**
-				 * Number of all the bytes including leading octet.
-				 */
-				int8	NumberOfEncodedBytes;
+			/**
+			 * Storage is released with the arena instead of the token, so the arena must not be reset while the token is used.
+			 * nullptr if storage comes from the heap.
+			 */
+			System::MonotonicArena* Arena;
 
-			} 
-			Identifier;
+			/// Header of tokens without storage, aligned to the end of the array
+			BYTE		InlineHeader[MaxHeaderSize];
 
-			struct 
-			{
-				BYTE* Value;
+		public:
 
-				SIZE_TYPE NumberOfEncodedBytes;
-			} 
-			Content;
+			ASN1EncodedToken(ASN1CodecOptions::EASN1ValueType type, SIZE_TYPE length, System::MonotonicArena* arena = nullptr)
+				: bIsEncoded(false), ValueType(type), IdentifierSize(0), LengthSize(0), LengthValue(length),
+				  Content(nullptr), ContentSize(0), Storage(nullptr), Arena(arena)
+			{ }
 
-		public:
+			ASN1EncodedToken(const ASN1EncodedToken&) = delete;
+			ASN1EncodedToken& operator = (const ASN1EncodedToken&) = delete;
 
-			ASN1EncodedToken(ASN1CodecOptions::EASN1ValueType type, SIZE_TYPE length)
-				: bIsEncoded(false), ValueType(type)
+			/// Steals the storage of other token, leaving it empty.
+			ASN1EncodedToken(ASN1EncodedToken&& other) NOEXCEPT
+				: Storage(nullptr)
 			{
-				Length.Value = length;
-				Length.EncodedLengthSequence = nullptr;
-				Length.NumberOfEncodedBytes = 0;
-
-				Identifier.EncodedTagNumberBytes = nullptr;
-				Identifier.NumberOfEncodedBytes = 0;
+				Steal(other);
+			}
 
-				Content.Value = nullptr;
-				Content.NumberOfEncodedBytes = 0;
+			ASN1EncodedToken& operator = (ASN1EncodedToken&& other) NOEXCEPT
+			{
+				if (this != &other)
+				{
+					Release();
+					Steal(other);
+				}
+				return *this;
 			}
 
+			~ASN1EncodedToken() { Release(); }
+
 			/// Checks if this token has been already encoded (preferably with ASN1_Codec::EncodeToken function).
 			FORCEINLINE bool IsEncoded() const { return bIsEncoded; }
 
 			/// Returns an identifier.
-			FORCEINLINE ASN1CodecOptions::IDENTIFIER_OCTET GetIdentifier() const { return Identifier.IdentifierOctet; }
+			FORCEINLINE ASN1CodecOptions::IDENTIFIER_OCTET GetIdentifier() const
+			{
+				ASN1CodecOptions::IDENTIFIER_OCTET octet;
+				octet.Content = IdentifierSize ? static_cast<uint8>(GetHeaderBytes()[0]) : 0;
+				return octet;
+			}
 
-			/// Returns a pointer to the identifier encoded tag number sequence. Always nullptr.
-			FORCEINLINE const BYTE* GetIndentifierBytes() const { return Identifier.EncodedTagNumberBytes; }
+			/// Returns a pointer to the base-128 tag number groups that follow identifier octet. nullptr if tag number fits in 5 bits.
+			FORCEINLINE const BYTE* GetIndentifierBytes() const { return (IdentifierSize > 1) ? GetHeaderBytes() + 1 : nullptr; }
 
-			/// Returns number of bytes that represent tag number. Always 0.
-			FORCEINLINE SIZE_TYPE GetIdentifierBytesCount() const { return Identifier.NumberOfEncodedBytes; }
+			/// Returns number of identifier bytes including the leading octet.
+			FORCEINLINE SIZE_TYPE GetIdentifierBytesCount() const { return IdentifierSize; }
 
 			/// Returns the length of the content.
-			FORCEINLINE SIZE_TYPE GetLength() const { return Length.Value; }
+			FORCEINLINE SIZE_TYPE GetLength() const { return LengthValue; }
 
 			/// Returns pointer to encoded length bytes sequence.
-			FORCEINLINE const BYTE* GetLengthBytes() const { return Length.EncodedLengthSequence; }
+			FORCEINLINE const BYTE* GetLengthBytes() const { return GetHeaderEnd() - LengthSize; }
 
 			/// Returns number of bytes in length bytes sequence.
-			FORCEINLINE uint8 GetLengthBytesCount() const { return Length.NumberOfEncodedBytes; }
+			FORCEINLINE uint8 GetLengthBytesCount() const { return LengthSize; }
 
 			/// Returns pointer to the content.
-			FORCEINLINE const BYTE* GetContentBytes() const { return Content.Value; }
+			FORCEINLINE const BYTE* GetContentBytes() const { return Content; }
 
 			/// Returns number of bytes in encoded content bytes sequence.
-			FORCEINLINE SIZE_TYPE GetContentBytesCount() const { return Content.NumberOfEncodedBytes; }
+			FORCEINLINE SIZE_TYPE GetContentBytesCount() const { return ContentSize; }
+
+			/// Checks if the content refers to the caller's buffer instead of being owned by the token.
+			FORCEINLINE bool IsView() const { return Content != nullptr && Storage == nullptr; }
+
+			/// Returns the arena the token storage comes from, nullptr if it comes from the heap.
+			FORCEINLINE System::MonotonicArena* GetArena() const { return Arena; }
 
 			/// Returns the value type of this token.
 			FORCEINLINE ASN1CodecOptions::EASN1ValueType GetValueType() const { return ValueType; }
 
+			/// Returns number of identifier and length bytes.
+			FORCEINLINE SIZE_TYPE GetHeaderBytesCount() const { return IdentifierSize + LengthSize; }
+
+			/// Returns pointer to identifier bytes followed by length bytes.
+			FORCEINLINE const BYTE* GetHeaderBytes() const { return GetHeaderEnd() - GetHeaderBytesCount(); }
+
+			/// Returns number of bytes of the whole token.
+			FORCEINLINE SIZE_TYPE GetEncodedSize() const { return GetHeaderBytesCount() + ContentSize; }
+
+			/// Checks if header and content follow each other, so GetEncodedSize() bytes at GetHeaderBytes() are the whole token.
+			FORCEINLINE bool IsContiguous() const { return Storage != nullptr || ContentSize == 0; }
+
+			/**
+			 * Copies identifier and length bytes to the destination.
+			 * 
+			 * \param destination buffer of at least GetHeaderBytesCount() bytes
+			 * 
+			 * \return number of copied bytes
+			 */
+			SIZE_TYPE CopyHeaderTo(BYTE* destination) const;
+
+			/// Maximum number of buffers returned by GetIOVectors.
+			static constexpr int32 MaxIOVectors = 2;
+
+			/**
+			 * Describes the token as scatter-gather buffers: one buffer if it is contiguous,
+			 * header and content otherwise. Buffers stay valid while the token lives.
+			 * 
+			 * \param vectors array to fill
+			 * 
+			 * \return number of filled buffers
+			 */
+			int32 GetIOVectors(System::IOVector (&vectors)[MaxIOVectors]) const;
+
+			/**
+			 * Writes the whole token at the current file position with a single write call
+			 * (more calls only if the kernel accepts a part of the data).
+			 * 
+			 * \param file file opened for writing
+			 * 
+			 * \return false if not all the bytes could be written
+			 */
+			bool WriteTo(System::PlatformFile& file) const;
+
+			/**
+			 * Writes the whole token at the given offset with a single positional write. File position is not changed.
+			 * 
+			 * \param file		file opened for writing
+			 * \param offset	position of the first identifier byte in the file
+			 * 
+			 * \return false if not all the bytes could be written
+			 */
+			bool WriteTo(System::PlatformFile& file, uint64 offset) const;
+
 			/**
 			 * Allows easily write encoded tokens to streams.
 			 * 
@@ -305,6 +1153,68 @@ namespace Real { namespace Codecs {
 			 */
 			friend std::ostream& operator << (std::ostream& os, const ASN1EncodedToken& token);
 
+		private:
+
+			FORCEINLINE const BYTE* GetHeaderEnd() const { return (Storage ? Storage : InlineHeader) + MaxHeaderSize; }
+
+			FORCEINLINE BYTE* GetHeaderEnd() { return (Storage ? Storage : InlineHeader) + MaxHeaderSize; }
+
+			/**
+			 * Allocates storage for the content from the arena or from the heap
+			 * and moves header bytes written so far in front of it.
+			 * 
+			 * \param capacity number of content bytes the encoder may write (content size is set by the encoder)
+			 * 
+			 * \return pointer to the content
+			 */
+			BYTE* AllocateContent(SIZE_TYPE capacity)
+			{
+				BYTE* storage = Arena ? Arena->AllocateArray<BYTE>(MaxHeaderSize + capacity) : new BYTE[MaxHeaderSize + capacity];
+				const SIZE_TYPE header_size = GetHeaderBytesCount();
+
+				std::memcpy(storage + MaxHeaderSize - header_size, GetHeaderEnd() - header_size, header_size);
+
+				Release();
+				Storage = storage;
+				Content = storage + MaxHeaderSize;
+
+				return storage + MaxHeaderSize;
+			}
+
+			/// Takes all the fields of other token, leaving it without storage. This token must own nothing.
+			void Steal(ASN1EncodedToken& other) NOEXCEPT
+			{
+				bIsEncoded = other.bIsEncoded;
+				ValueType = other.ValueType;
+				IdentifierSize = other.IdentifierSize;
+				LengthSize = other.LengthSize;
+				LengthValue = other.LengthValue;
+				Content = other.Content;
+				ContentSize = other.ContentSize;
+				Storage = other.Storage;
+				Arena = other.Arena;
+
+				std::memcpy(InlineHeader, other.InlineHeader, MaxHeaderSize);
+
+				// no header either, GetHeaderBytes of the moved-from token must not view a buffer it does not own
+				other.IdentifierSize = 0;
+				other.LengthSize = 0;
+				other.Storage = nullptr;
+				other.Content = nullptr;
+				other.ContentSize = 0;
+			}
+
+			/// Frees the storage owned by the token. Arena storage is left to the arena.
+			void Release() NOEXCEPT
+			{
+				if (Arena == nullptr)
+					delete[] Storage;
+
+				Storage = nullptr;
+				Content = nullptr;
+				ContentSize = 0;
+			}
+
 
 		};
 
@@ -0,0 +1,426 @@
+#ifndef __REAL_ASN1_GENERATED__
+#define __REAL_ASN1_GENERATED__
+
+#include "ASN1_Codec.h"
+#include "ASN1_Header.hpp"
+#include "ASN1_Reader.h"
+#include "ASN1_ReverseWriter.h"
+#include <type_traits>
+#include <optional>
+#include <vector>
+
+
+namespace Real { namespace Codecs {
+
+
+	/**
+	 * Support code for C++ emitted by the ASN.1 module compiler (tools/ModuleCompiler).
+	 * Every ASN.1 type maps to a C++ type and Traits of that type tell its universal tag and how its content
+	 * is sized, written and read. Generated code calls GetEncodedSize/Prepend/Matches/Read with the tag of every
+	 * field as template arguments, so the encoding of a message is resolved at compile time: there are no type
+	 * switches at runtime and headers of fixed size content (BOOLEAN, NULL) are constants.
+	 *
+	 * A tag replaces the universal tag (IMPLICIT) unless _bIsExplicit is set or the type is a CHOICE,
+	 * then the universal encoding is wrapped into a constructed token with the tag (EXPLICIT).
+	 */
+	namespace ASN1Generated
+	{
+
+		typedef ASN1_Codec::SIZE_TYPE SIZE_TYPE;
+
+		/// Tag number meaning "the universal tag of the type"
+		constexpr uint64 DefaultTag = ~0ull;
+
+		/// Content size of types without fixed content size
+		constexpr SIZE_TYPE VariableSize = ~0ull;
+
+		/// Rules every generated decoder checks headers and BOOLEAN, INTEGER and ENUMERATED content against
+		constexpr EASN1DecodeRules Rules = EASN1DecodeRules::DER;
+
+		/// Reads INTEGER/ENUMERATED content, under DER only the minimal encoding is accepted
+		FORCEINLINE bool ReadIntegerContent(const ASN1DecodedToken& token, int64& value)
+		{
+			if (Rules == EASN1DecodeRules::DER && !ASN1_Codec::IsMinimalIntegerContent(token.Content, token.ContentLength))
+				return false;
+
+			return ASN1_Codec::ReadIntegerContent(token.Content, token.ContentLength, value);
+		}
+
+		/// C++ type of ASN.1 NULL
+		struct Null { };
+
+		/// C++ type of ASN.1 OBJECT IDENTIFIER
+		struct ObjectIdentifier
+		{
+			std::vector<uint64> Arcs;
+		};
+
+		/// C++ type of ASN.1 BIT STRING, one flag of 0 or 1 per bit
+		struct BitString
+		{
+			std::vector<uint8> Bits;
+		};
+
+
+		/**
+		 * Describes how an ASN.1 type is encoded. Generated SEQUENCE and CHOICE structs provide the members themselves.
+		 */
+		template<typename _Ty, typename = void>
+		struct Traits
+		{
+			static constexpr ASN1CodecOptions::EASN1ClassTagType Class = _Ty::Class;
+			static constexpr uint64 Tag = _Ty::Tag;
+			static constexpr bool bIsConstructed = true;
+			static constexpr bool bIsChoice = _Ty::bIsChoice;
+			static constexpr SIZE_TYPE FixedContentSize = VariableSize;
+
+			static FORCEINLINE SIZE_TYPE GetContentSize(const _Ty& value) { return value.GetContentSize(); }
+			static FORCEINLINE void PrependContent(ASN1ReverseWriter& writer, const _Ty& value) { value.PrependContent(writer); }
+			static FORCEINLINE bool ReadContent(const ASN1DecodedToken& token, _Ty& value) { return value.ReadContent(token); }
+			static FORCEINLINE bool MatchesAlternative(const ASN1DecodedToken& token) { return _Ty::Matches(token); }
+		};
+
+		/// Universal primitive type
+		template<ASN1CodecOptions::EASN1ValueType _Type, SIZE_TYPE _FixedContentSize = VariableSize>
+		struct PrimitiveTraits
+		{
+			static constexpr ASN1CodecOptions::EASN1ClassTagType Class = ASN1CodecOptions::EASN1ClassTagType::UNIVERSAL;
+			static constexpr uint64 Tag = static_cast<uint64>(_Type);
+			static constexpr bool bIsConstructed = false;
+			static constexpr bool bIsChoice = false;
+			static constexpr SIZE_TYPE FixedContentSize = _FixedContentSize;
+		};
+
+		/// BOOLEAN
+		template<>
+		struct Traits<bool> : PrimitiveTraits<ASN1CodecOptions::EASN1ValueType::Boolean, 1>
+		{
+			static FORCEINLINE SIZE_TYPE GetContentSize(const bool&) { return 1; }
+
+			static FORCEINLINE void PrependContent(ASN1ReverseWriter& writer, const bool& value)
+			{
+				const BYTE content = value ? static_cast<BYTE>(0xFF) : 0;
+				writer.PrependRaw(&content, 1);
+			}
+
+			/// Under DER TRUE is 0xFF only
+			static FORCEINLINE bool ReadContent(const ASN1DecodedToken& token, bool& value)
+			{
+				if (!ASN1_Codec::ReadBooleanContent(token.Content, token.ContentLength, value))
+					return false;
+
+				const uint8 content = static_cast<uint8>(token.Content[0]);
+				return Rules != EASN1DecodeRules::DER || content == 0x00 || content == 0xFF;
+			}
+		};
+
+		/// INTEGER
+		template<>
+		struct Traits<int64> : PrimitiveTraits<ASN1CodecOptions::EASN1ValueType::Integer>
+		{
+			static FORCEINLINE SIZE_TYPE GetContentSize(const int64& value) { return ASN1_Codec::GetIntegerContentSize(value); }
+
+			static FORCEINLINE void PrependContent(ASN1ReverseWriter& writer, const int64& value)
+			{
+				BYTE content[sizeof(int64)];
+				writer.PrependRaw(content, ASN1_Codec::WriteIntegerContent(content, value));
+			}
+
+			static FORCEINLINE bool ReadContent(const ASN1DecodedToken& token, int64& value) { return ASN1Generated::ReadIntegerContent(token, value); }
+		};
+
+		/// ENUMERATED, generated enums have int64 underlying type
+		template<typename _Ty>
+		struct Traits<_Ty, std::enable_if_t<std::is_enum_v<_Ty>>> : PrimitiveTraits<ASN1CodecOptions::EASN1ValueType::Enumerated>
+		{
+			static FORCEINLINE SIZE_TYPE GetContentSize(const _Ty& value) { return ASN1_Codec::GetIntegerContentSize(static_cast<int64>(value)); }
+
+			static FORCEINLINE void PrependContent(ASN1ReverseWriter& writer, const _Ty& value) { Traits<int64>::PrependContent(writer, static_cast<int64>(value)); }
+
+			static FORCEINLINE bool ReadContent(const ASN1DecodedToken& token, _Ty& value)
+			{
+				int64 number;
+				if (!ASN1Generated::ReadIntegerContent(token, number))
+					return false;
+
+				value = static_cast<_Ty>(number);
+				return true;
+			}
+		};
+
+		/// OCTET STRING
+		template<>
+		struct Traits<std::vector<BYTE>> : PrimitiveTraits<ASN1CodecOptions::EASN1ValueType::OctetString>
+		{
+			static FORCEINLINE SIZE_TYPE GetContentSize(const std::vector<BYTE>& value) { return value.size(); }
+
+			static FORCEINLINE void PrependContent(ASN1ReverseWriter& writer, const std::vector<BYTE>& value) { writer.PrependRaw(value.data(), value.size()); }
+
+			static FORCEINLINE bool ReadContent(const ASN1DecodedToken& token, std::vector<BYTE>& value)
+			{
+				value.assign(token.Content, token.Content + token.ContentLength);
+				return true;
+			}
+		};
+
+		/// REAL
+		template<>
+		struct Traits<double> : PrimitiveTraits<ASN1CodecOptions::EASN1ValueType::Real>
+		{
+			static FORCEINLINE SIZE_TYPE GetContentSize(const double& value) { return ASN1_Codec::GetRealContentSize(value); }
+
+			static FORCEINLINE void PrependContent(ASN1ReverseWriter& writer, const double& value)
+			{
+				BYTE content[ASN1_Codec::MaxRealContentSize];
+				writer.PrependRaw(content, ASN1_Codec::WriteRealContent(content, value));
+			}
+
+			static FORCEINLINE bool ReadContent(const ASN1DecodedToken& token, double& value) { return ASN1_Codec::ReadRealContent(token.Content, token.ContentLength, value); }
+		};
+
+		/// NULL
+		template<>
+		struct Traits<Null> : PrimitiveTraits<ASN1CodecOptions::EASN1ValueType::Null, 0>
+		{
+			static FORCEINLINE SIZE_TYPE GetContentSize(const Null&) { return 0; }
+
+			static FORCEINLINE void PrependContent(ASN1ReverseWriter&, const Null&) { }
+
+			static FORCEINLINE bool ReadContent(const ASN1DecodedToken& token, Null&) { return token.ContentLength == 0; }
+		};
+
+		/// OBJECT IDENTIFIER
+		template<>
+		struct Traits<ObjectIdentifier> : PrimitiveTraits<ASN1CodecOptions::EASN1ValueType::ObjectIdentifier>
+		{
+			static FORCEINLINE SIZE_TYPE GetContentSize(const ObjectIdentifier& value) { return ASN1_Codec::GetObjectIdentifierContentSize(value.Arcs); }
+
+			static FORCEINLINE void PrependContent(ASN1ReverseWriter& writer, const ObjectIdentifier& value) { writer.PrependObjectIdentifierContent(value.Arcs); }
+
+			static FORCEINLINE bool ReadContent(const ASN1DecodedToken& token, ObjectIdentifier& value) { return ASN1_Codec::ReadObjectIdentifierContent(token.Content, token.ContentLength, value.Arcs); }
+		};
+
+		/// BIT STRING
+		template<>
+		struct Traits<BitString> : PrimitiveTraits<ASN1CodecOptions::EASN1ValueType::BitString>
+		{
+			static FORCEINLINE SIZE_TYPE GetContentSize(const BitString& value) { return ASN1_Codec::GetBitStringContentSize(value.Bits.size()); }
+
+			static FORCEINLINE void PrependContent(ASN1ReverseWriter& writer, const BitString& value) { writer.PrependBitStringContent(value.Bits); }
+
+			static FORCEINLINE bool ReadContent(const ASN1DecodedToken& token, BitString& value) { return ASN1_Codec::ReadBitStringContent(token.Content, token.ContentLength, value.Bits); }
+		};
+
+
+		/// Class of a field tagged with _Class/_Tag, universal class of the type for DefaultTag.
+		template<ASN1CodecOptions::EASN1ClassTagType _Class, uint64 _Tag, typename _Ty>
+		constexpr ASN1CodecOptions::EASN1ClassTagType FieldClass = (_Tag == DefaultTag) ? Traits<_Ty>::Class : _Class;
+
+		/// Tag number of a field tagged with _Class/_Tag, tag number of the type for DefaultTag.
+		template<ASN1CodecOptions::EASN1ClassTagType _Class, uint64 _Tag, typename _Ty>
+		constexpr uint64 FieldTag = (_Tag == DefaultTag) ? Traits<_Ty>::Tag : _Tag;
+
+		/// Untagged CHOICE has no header, its alternative is encoded instead.
+		template<uint64 _Tag, typename _Ty>
+		constexpr bool bIsBareChoice = Traits<_Ty>::bIsChoice && _Tag == DefaultTag;
+
+		/// EXPLICIT tag wraps the universal encoding into a constructed token. Tags on CHOICE are always EXPLICIT.
+		template<uint64 _Tag, bool _bIsExplicit, typename _Ty>
+		constexpr bool bIsExplicitField = _Tag != DefaultTag && (_bIsExplicit || Traits<_Ty>::bIsChoice);
+
+		/**
+		 * Returns number of bytes of the value encoded with the tag.
+		 *
+		 * \param value value
+		 */
+		template<ASN1CodecOptions::EASN1ClassTagType _Class, uint64 _Tag, bool _bIsExplicit = false, typename _Ty>
+		FORCEINLINE SIZE_TYPE GetEncodedSize(const _Ty& value)
+		{
+			if constexpr (bIsBareChoice<_Tag, _Ty>)
+			{
+				return Traits<_Ty>::GetContentSize(value);
+			}
+			else if constexpr (bIsExplicitField<_Tag, _bIsExplicit, _Ty>)
+			{
+				const SIZE_TYPE inner_size = GetEncodedSize<ASN1CodecOptions::EASN1ClassTagType::UNIVERSAL, DefaultTag>(value);
+				return ASN1Rules::IdentifierSize(_Tag) + ASN1_Codec::GetLengthFieldSize(inner_size) + inner_size;
+			}
+			else if constexpr (Traits<_Ty>::FixedContentSize != VariableSize)
+			{
+				return ASN1Header<FieldClass<_Class, _Tag, _Ty>, ASN1CodecOptions::EASN1PCType::PRIMITIVE, FieldTag<_Class, _Tag, _Ty>, Traits<_Ty>::FixedContentSize>::TotalSize;
+			}
+			else
+			{
+				const SIZE_TYPE content_size = Traits<_Ty>::GetContentSize(value);
+				return ASN1Rules::IdentifierSize(FieldTag<_Class, _Tag, _Ty>) + ASN1_Codec::GetLengthFieldSize(content_size) + content_size;
+			}
+		}
+
+		/**
+		 * Prepends the value encoded with the tag.
+		 *
+		 * \param writer	writer to prepend to
+		 * \param value		value
+		 */
+		template<ASN1CodecOptions::EASN1ClassTagType _Class, uint64 _Tag, bool _bIsExplicit = false, typename _Ty>
+		FORCEINLINE void Prepend(ASN1ReverseWriter& writer, const _Ty& value)
+		{
+			if constexpr (bIsBareChoice<_Tag, _Ty>)
+			{
+				Traits<_Ty>::PrependContent(writer, value);
+			}
+			else if constexpr (bIsExplicitField<_Tag, _bIsExplicit, _Ty>)
+			{
+				const SIZE_TYPE mark = writer.Mark();
+				Prepend<ASN1CodecOptions::EASN1ClassTagType::UNIVERSAL, DefaultTag>(writer, value);
+				writer.PrependHeader(_Class, ASN1CodecOptions::EASN1PCType::CONSTRUCTED, _Tag, writer.GetSize() - mark);
+			}
+			else if constexpr (Traits<_Ty>::FixedContentSize != VariableSize)
+			{
+				typedef ASN1Header<FieldClass<_Class, _Tag, _Ty>, ASN1CodecOptions::EASN1PCType::PRIMITIVE, FieldTag<_Class, _Tag, _Ty>, Traits<_Ty>::FixedContentSize> Header;
+
+				Traits<_Ty>::PrependContent(writer, value);
+				writer.PrependRaw(Header::Bytes.data(), Header::Size);
+			}
+			else
+			{
+				const SIZE_TYPE mark = writer.Mark();
+				Traits<_Ty>::PrependContent(writer, value);
+
+				constexpr auto pc_type = Traits<_Ty>::bIsConstructed ? ASN1CodecOptions::EASN1PCType::CONSTRUCTED : ASN1CodecOptions::EASN1PCType::PRIMITIVE;
+				writer.PrependHeader(FieldClass<_Class, _Tag, _Ty>, pc_type, FieldTag<_Class, _Tag, _Ty>, writer.GetSize() - mark);
+			}
+		}
+
+		/// Checks if the token is the field tagged with _Class/_Tag.
+		template<ASN1CodecOptions::EASN1ClassTagType _Class, uint64 _Tag, typename _Ty, bool _bIsExplicit = false>
+		FORCEINLINE bool Matches(const ASN1DecodedToken& token)
+		{
+			if constexpr (bIsBareChoice<_Tag, _Ty>)
+				return Traits<_Ty>::MatchesAlternative(token);
+			else if constexpr (bIsExplicitField<_Tag, _bIsExplicit, _Ty>)
+				return token.Class == _Class && token.TagNumber == _Tag && token.bIsConstructed;
+			else
+				return token.Class == FieldClass<_Class, _Tag, _Ty> && token.TagNumber == FieldTag<_Class, _Tag, _Ty> && token.bIsConstructed == Traits<_Ty>::bIsConstructed;
+		}
+
+		/**
+		 * Reads the field from a token that Matches it.
+		 *
+		 * \param token			token of the field
+		 * \param[out] value	decoded value
+		 *
+		 * \return false if the content is malformed
+		 */
+		template<ASN1CodecOptions::EASN1ClassTagType _Class, uint64 _Tag, bool _bIsExplicit = false, typename _Ty>
+		FORCEINLINE bool Read(const ASN1DecodedToken& token, _Ty& value)
+		{
+			if constexpr (bIsExplicitField<_Tag, _bIsExplicit, _Ty>)
+			{
+				// exactly one token with the universal encoding inside
+				ASN1Reader reader(token, Rules);
+				ASN1DecodedToken inner;
+
+				if (!reader.Next(inner) || !Matches<ASN1CodecOptions::EASN1ClassTagType::UNIVERSAL, DefaultTag, _Ty>(inner) || !Read<ASN1CodecOptions::EASN1ClassTagType::UNIVERSAL, DefaultTag>(inner, value))
+					return false;
+
+				return !reader.Next(inner) && reader.GetStatus() == EASN1DecodeStatus::END;
+			}
+			else
+			{
+				return Traits<_Ty>::ReadContent(token, value);
+			}
+		}
+
+		/// SEQUENCE OF
+		template<typename _Ty>
+		struct Traits<std::vector<_Ty>, std::enable_if_t<!std::is_same_v<_Ty, BYTE>>>
+		{
+			static constexpr ASN1CodecOptions::EASN1ClassTagType Class = ASN1CodecOptions::EASN1ClassTagType::UNIVERSAL;
+			static constexpr uint64 Tag = static_cast<uint64>(ASN1CodecOptions::EASN1ValueType::Sequence);
+			static constexpr bool bIsConstructed = true;
+			static constexpr bool bIsChoice = false;
+			static constexpr SIZE_TYPE FixedContentSize = VariableSize;
+
+			static SIZE_TYPE GetContentSize(const std::vector<_Ty>& values)
+			{
+				SIZE_TYPE size = 0;
+
+				for (const _Ty& value : values)
+					size += GetEncodedSize<Class, DefaultTag>(value);
+
+				return size;
+			}
+
+			static void PrependContent(ASN1ReverseWriter& writer, const std::vector<_Ty>& values)
+			{
+				for (auto it = values.rbegin(); it != values.rend(); ++it)
+					Prepend<Class, DefaultTag>(writer, *it);
+			}
+
+			static bool ReadContent(const ASN1DecodedToken& token, std::vector<_Ty>& values)
+			{
+				ASN1Reader reader(token, Rules);
+				ASN1DecodedToken element;
+
+				values.clear();
+
+				while (reader.Next(element))
+				{
+					// decoded into a local, std::vector<bool> has no references to its elements
+					_Ty value{};
+
+					if (!Matches<Class, DefaultTag, _Ty>(element) || !Read<Class, DefaultTag>(element, value))
+						return false;
+
+					values.push_back(std::move(value));
+				}
+
+				return reader.GetStatus() == EASN1DecodeStatus::END;
+			}
+		};
+
+
+		/**
+		 * Encodes a value of a generated type into a buffer of the exact size.
+		 *
+		 * \param value			value
+		 * \param[out] output	receives the encoding
+		 */
+		template<typename _Ty>
+		void Encode(const _Ty& value, std::vector<BYTE>& output)
+		{
+			output.resize(GetEncodedSize<Traits<_Ty>::Class, DefaultTag>(value));
+
+			ASN1ReverseWriter writer(output.data(), output.size());
+			Prepend<Traits<_Ty>::Class, DefaultTag>(writer, value);
+		}
+
+		/**
+		 * Decodes a value of a generated type, the encoding has to take all the bytes.
+		 *
+		 * \param data			encoded bytes
+		 * \param size			number of bytes
+		 * \param[out] value	decoded value
+		 *
+		 * \return false if the encoding is malformed or is not a value of the type
+		 */
+		template<typename _Ty>
+		bool Decode(const void* data, SIZE_TYPE size, _Ty& value)
+		{
+			ASN1Reader reader(data, size, Rules);
+			ASN1DecodedToken token;
+
+			if (!reader.Next(token) || !Matches<Traits<_Ty>::Class, DefaultTag, _Ty>(token) || !Read<Traits<_Ty>::Class, DefaultTag>(token, value))
+				return false;
+
+			return reader.AtEnd();
+		}
+
+	}
+
+
+} }
+
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef __REAL_ASN1_HEADER__
+#define __REAL_ASN1_HEADER__
+
+#include "ASN1_Codec.h"
+#include <array>
+#include <cstring>
+
+
+namespace Real { namespace Codecs {
+
+
+	/**
+	 * Header layout rules shared by the runtime encoder (ASN1_Codec) and compile time headers (ASN1Header).
+	 */
+	namespace ASN1Rules
+	{
+
+		/// Number of identifier bytes: leading octet and base-128 groups for tag numbers above 30.
+		constexpr uint8 IdentifierSize(uint64 tag_number)
+		{
+			if (tag_number < 31)
+				return 1;
+
+			uint8 groups = 0;
+			for (; tag_number; tag_number >>= 7)
+				++groups;
+
+			return 1 + groups;
+		}
+
+		/// Number of length bytes (DER): short form below 128, otherwise the prefix and significant bytes of the length.
+		constexpr uint8 LengthFieldSize(uint64 length)
+		{
+			if (length < 128)
+				return 1;
+
+			uint8 bytes = 0;
+			for (; length; length >>= 8)
+				++bytes;
+
+			return 1 + bytes;
+		}
+
+		/// Writes identifier octets. Destination has to hold IdentifierSize(tag_number) bytes.
+		constexpr void WriteIdentifier(BYTE* destination, uint8 class_pc_bits, uint64 tag_number)
+		{
+			const uint8 size = IdentifierSize(tag_number);
+
+			if (size == 1)
+			{
+				destination[0] = static_cast<BYTE>(class_pc_bits | tag_number);
+				return;
+			}
+
+			destination[0] = static_cast<BYTE>(class_pc_bits | 0b00011111);
+
+			for (uint8 i = size - 1; i > 0; --i, tag_number >>= 7)
+				destination[i] = static_cast<BYTE>((tag_number & 0b01111111) | (i == size - 1 ? 0 : 0b10000000));
+		}
+
+		/// Writes length octets. Destination has to hold LengthFieldSize(length) bytes.
+		constexpr void WriteLengthField(BYTE* destination, uint64 length)
+		{
+			const uint8 size = LengthFieldSize(length);
+
+			if (size == 1)
+			{
+				destination[0] = static_cast<BYTE>(length);
+				return;
+			}
+
+			destination[0] = static_cast<BYTE>(0b10000000 | (size - 1));
+
+			for (uint8 i = size - 1; i > 0; --i, length >>= 8)
+				destination[i] = static_cast<BYTE>(length & 0xFF);
+		}
+
+	}
+
+
+	/**
+	 * Identifier and length octets computed at compile time for messages with fixed tags and sizes.
+	 * Follows the same rules as ASN1_Codec::WriteTaggedHeader, so encoding such a message at runtime
+	 * is a copy of a constant header followed by the payload.
+	 *
+	 * \code
+	 * typedef ASN1Header<EASN1ClassTagType::APPLICATION, EASN1PCType::PRIMITIVE, 42, 16> FrameHeader;
+	 * BYTE* end = FrameHeader::Encode(destination, payload);
+	 * \endcode
+	 */
+	template<ASN1CodecOptions::EASN1ClassTagType _Class, ASN1CodecOptions::EASN1PCType _PC, uint64 _TagNumber, uint64 _Length>
+	struct ASN1Header
+	{
+		static constexpr SIZE_T IdentifierSize = ASN1Rules::IdentifierSize(_TagNumber);
+		static constexpr SIZE_T LengthSize = ASN1Rules::LengthFieldSize(_Length);
+
+		/// Number of header bytes
+		static constexpr SIZE_T Size = IdentifierSize + LengthSize;
+
+		/// Number of header and content bytes
+		static constexpr SIZE_T TotalSize = Size + _Length;
+
+		static constexpr std::array<BYTE, Size> Build()
+		{
+			std::array<BYTE, Size> bytes{};
+
+			ASN1Rules::WriteIdentifier(bytes.data(), static_cast<uint8>(_Class) | static_cast<uint8>(_PC), _TagNumber);
+			ASN1Rules::WriteLengthField(bytes.data() + IdentifierSize, _Length);
+
+			return bytes;
+		}
+
+		/// Encoded identifier and length octets
+		static constexpr std::array<BYTE, Size> Bytes = Build();
+
+		/**
+		 * Writes the header and the payload.
+		 *
+		 * \param destination	buffer of at least TotalSize bytes
+		 * \param payload		_Length content bytes
+		 *
+		 * \return pointer past the last written byte
+		 */
+		static FORCEINLINE BYTE* Encode(BYTE* destination, const void* payload)
+		{
+			std::memcpy(destination, Bytes.data(), Size);
+			std::memcpy(destination + Size, payload, _Length);
+
+			return destination + TotalSize;
+		}
+
+		/// Writes only the header. Returns pointer past the header.
+		static FORCEINLINE BYTE* EncodeHeader(BYTE* destination)
+		{
+			std::memcpy(destination, Bytes.data(), Size);
+
+			return destination + Size;
+		}
+	};
+
+	/// Compile time header of a universal type listed in EASN1ValueType.
+	template<ASN1CodecOptions::EASN1ValueType _Type, uint64 _Length, ASN1CodecOptions::EASN1PCType _PC = ASN1CodecOptions::EASN1PCType::PRIMITIVE>
+	using ASN1UniversalHeader = ASN1Header<ASN1CodecOptions::EASN1ClassTagType::UNIVERSAL, _PC, static_cast<uint64>(_Type), _Length>;
+
+
+} }
+
+
+#endif
@@ -0,0 +1,401 @@
+#include "ASN1_Codec.h"
+#include <cstring>
+#include <array>
+#include "../Platform/Limits.h"
+#include "../Misc/Endian.hpp"
+#include "../Misc/Bits.hpp"
+#include "../Misc/Simd.hpp"
+
+
+
+namespace Real { namespace Codecs {
+
+	using namespace ASN1CodecOptions;
+
+	namespace Private
+	{
+		/// Subidentifiers below this bound take at most 8 groups and are written with one store.
+		constexpr uint64 SingleWordSubidentifierBound = 1ull << 56;
+
+		constexpr std::array<uint8, 65> BuildSubidentifierSizeTable()
+		{
+			std::array<uint8, 65> table{};
+
+			for (uint32 width = 0; width <= 64; ++width)
+				table[width] = static_cast<uint8>((width + 6) / 7);
+
+			return table;
+		}
+
+		/// Number of base-128 groups of a value of the given bit width.
+		constexpr std::array<uint8, 65> SubidentifierSizeTable = BuildSubidentifierSizeTable();
+
+		/// Returns number of base-128 groups of a subidentifier (1 to 10).
+		FORCEINLINE uint32 GetSubidentifierSize(uint64 value)
+		{
+			// | 1 keeps clz defined for 0, it takes one group anyway
+			return SubidentifierSizeTable[64 - Bits::CountLeadingZeros(value | 1)];
+		}
+
+		/// Combines the first two arcs into the first subidentifier. Returns false if they cannot be combined.
+		FORCEINLINE bool GetFirstSubidentifier(Span<const uint64> arcs, uint64& value)
+		{
+			if (arcs.Size() < 2 || arcs[0] > 2 || (arcs[0] < 2 && arcs[1] >= 40) || arcs[1] > MAX_UINT64 - 80)
+				return false;
+
+			value = arcs[0] * 40 + arcs[1];
+			return true;
+		}
+
+		/**
+		 * Writes a subidentifier of at most 8 groups as one big endian word,
+		 * every group but the last one carries the continuation bit. Always stores 8 bytes.
+		 */
+		FORCEINLINE void WriteSubidentifierWord(BYTE* destination, uint64 value, uint32 size)
+		{
+			// group 0 is the last byte and the only one without continuation bit
+			const uint64 continuation = 0x8080808080808000ull & (MAX_UINT64 >> (64 - 8 * size));
+
+			// move meaningful bytes to the top and store big endian, the tail is garbage
+			const uint64 big_endian_word = Endian::native_to_big<uint64>((Bits::SpreadBase128(value) | continuation) << (64 - 8 * size));
+			std::memcpy(destination, &big_endian_word, sizeof(big_endian_word));
+		}
+
+		/// Writes a subidentifier. Stores 1 byte for arcs below 128 and at least 8 bytes for others, returns number of meaningful ones.
+		FORCEINLINE uint32 WriteSubidentifier(BYTE* destination, uint64 value)
+		{
+			// most of the arcs are below 128
+			if (value < 0x80)
+			{
+				destination[0] = static_cast<BYTE>(value);
+				return 1;
+			}
+
+			const uint32 size = GetSubidentifierSize(value);
+
+			if (value < SingleWordSubidentifierBound)
+			{
+				WriteSubidentifierWord(destination, value, size);
+				return size;
+			}
+
+			// 9 or 10 groups: the top ones byte by byte, the low 56 bits as a full word
+			const uint32 head = size - 8;
+
+			for (uint32 i = 0; i < head; ++i)
+				destination[i] = static_cast<BYTE>(0x80 | ((value >> (7 * (size - 1 - i))) & 0x7F));
+
+			WriteSubidentifierWord(destination + head, value & (SingleWordSubidentifierBound - 1), 8);
+			return size;
+		}
+
+		/// Number of bytes the decoder looks for ends of subidentifiers in at once.
+		constexpr SIZE_T ReadWindowSize = 16;
+
+		/**
+		 * Returns a mask of bytes without continuation bit among up to 16 bytes starting at position.
+		 * Content is at least 8 bytes long, loads never cross its bounds: the last window is loaded
+		 * from the last 16 bytes, content shorter than 16 bytes from two overlapping 8-byte halves.
+		 */
+		FORCEINLINE uint32 GetSubidentifierEnds(const BYTE* content, SIZE_T length, SIZE_T position)
+		{
+			if (position + ReadWindowSize <= length)
+				return ~Simd::MoveMask16(content + position) & 0xFFFF;
+
+			const uint32 window_mask = (1u << (length - position)) - 1;
+
+			if (length >= ReadWindowSize)
+				return (~Simd::MoveMask16(content + length - ReadWindowSize) >> (position + ReadWindowSize - length)) & window_mask;
+
+			const uint32 high_bits = Simd::MoveMask8(content) | (Simd::MoveMask8(content + length - sizeof(uint64)) << (length - sizeof(uint64)));
+			return ~high_bits & window_mask;
+		}
+
+		FORCEINLINE uint64 LoadBigEndianWord(const BYTE* data)
+		{
+			uint64 word;
+			std::memcpy(&word, data, sizeof(word));
+
+			return Endian::big_to_native(word);
+		}
+
+		/**
+		 * Reads the subidentifier occupying bytes start..end of the content.
+		 * Content is at least 8 bytes long, so 8 bytes ending at end
+		 * (or starting at the content if end is below 7) are always loaded at once.
+		 */
+		FORCEINLINE bool ReadSubidentifier(const BYTE* content, SIZE_T start, SIZE_T end, uint64& value)
+		{
+			const SIZE_T size = end + 1 - start;
+
+			// leading zero group is not minimal, more than 10 groups do not fit in 64 bits
+			if (static_cast<uint8>(content[start]) == 0x80 || size > 10)
+				return false;
+
+			// groups above the low 8 ones (9 or 10 groups)
+			uint64 high = 0;
+
+			for (SIZE_T i = start; i + 8 < end + 1; ++i)
+				high = (high << 7) | (content[i] & 0x7F);
+
+			if (high >> 8)
+				return false;
+
+			// the last byte of the subidentifier becomes the lowest byte of the word, bytes of the previous ones are masked off
+			const SIZE_T base = (end >= 7) ? end - 7 : 0;
+			const uint64 word = LoadBigEndianWord(content + base) >> (8 * (7 - (end - base)));
+			const SIZE_T tail = (size < 8) ? size : 8;
+
+			value = (high << 56) | Bits::GatherBase128(word & (MAX_UINT64 >> (64 - 8 * tail)));
+			return true;
+		}
+	}
+
+	/**
+	 * Returns number of content bytes of an OBJECT IDENTIFIER: the first two arcs share one subidentifier,
+	 * every subidentifier takes one byte per started 7 bits.
+	 *
+	 * \param arcs arcs of the identifier, e.g. { 1, 2, 840, 113549 }
+	 *
+	 * \return content size, 0 if the arcs are not a valid identifier
+	 *		   (less than two arcs, first arc above 2, second arc above 39 under the arcs 0 and 1)
+	 */
+	ASN1_Codec::SIZE_TYPE ASN1_Codec::GetObjectIdentifierContentSize(Span<const uint64> arcs)
+	{
+		uint64 first;
+
+		if (!Private::GetFirstSubidentifier(arcs, first))
+			return 0;
+
+		SIZE_TYPE size = Private::GetSubidentifierSize(first);
+
+		for (SIZE_T i = 2; i < arcs.Size(); ++i)
+			size += Private::GetSubidentifierSize(arcs[i]);
+
+		return size;
+	}
+
+	/**
+	 * Writes OBJECT IDENTIFIER content. Every subidentifier below 2^56 is spread into 7-bit groups,
+	 * marked with continuation bits and stored as a single 8-byte word, the cursor moves only by its real size.
+	 * Up to sizeof(uint64) bytes past the content are garbage.
+	 *
+	 * \param destination	buffer of at least GetObjectIdentifierContentSize(arcs) + sizeof(uint64) bytes
+	 * \param arcs			arcs of the identifier
+	 *
+	 * \return number of meaningful bytes, 0 if the arcs are not a valid identifier
+	 */
+	ASN1_Codec::SIZE_TYPE ASN1_Codec::WriteObjectIdentifierContent(BYTE* destination, Span<const uint64> arcs)
+	{
+		uint64 first;
+
+		if (!Private::GetFirstSubidentifier(arcs, first))
+			return 0;
+
+		BYTE* current = destination;
+		current += Private::WriteSubidentifier(current, first);
+
+		for (SIZE_T i = 2; i < arcs.Size(); ++i)
+			current += Private::WriteSubidentifier(current, arcs[i]);
+
+		return current - destination;
+	}
+
+	/**
+	 * Writes a whole OBJECT IDENTIFIER token with universal tag.
+	 *
+	 * \param destination	buffer of at least MaxHeaderSize + GetObjectIdentifierContentSize(arcs) + sizeof(uint64) bytes
+	 * \param arcs			arcs of the identifier
+	 *
+	 * \return number of meaningful bytes, 0 if the arcs are not a valid identifier
+	 */
+	ASN1_Codec::SIZE_TYPE ASN1_Codec::WriteObjectIdentifier(BYTE* destination, Span<const uint64> arcs)
+	{
+		const SIZE_TYPE content_size = GetObjectIdentifierContentSize(arcs);
+
+		if (content_size == 0)
+			return 0;
+
+		destination[0] = static_cast<BYTE>(GetIdentifierOctet(EASN1ValueType::ObjectIdentifier, EASN1ClassTagType::UNIVERSAL, EASN1PCType::PRIMITIVE));
+		const SIZE_TYPE header_size = 1 + WriteLengthField(destination + 1, content_size);
+
+		WriteObjectIdentifierContent(destination + header_size, arcs);
+
+		return header_size + content_size;
+	}
+
+	/**
+	 * Reads OBJECT IDENTIFIER content. Ends of subidentifiers are found 16 bytes at a time from the
+	 * continuation bits, every subidentifier of up to 8 bytes is then gathered from one 8-byte load.
+	 *
+	 * \param content		content bytes
+	 * \param length		number of content bytes
+	 * \param[out] arcs		buffer of at least length + 1 arcs
+	 *
+	 * \return number of arcs, 0 if the content is empty, truncated, not minimal or an arc does not fit in 64 bits
+	 */
+	ASN1_Codec::SIZE_TYPE ASN1_Codec::ReadObjectIdentifierContent(const BYTE* content, SIZE_TYPE length, uint64* arcs)
+	{
+		// the first subidentifier is read into arcs[1] and split into two arcs in the end
+		uint64* current = arcs + 1;
+
+		// first byte of the subidentifier being read, it may start in one window and end in another
+		SIZE_TYPE start = 0;
+
+		if (length < sizeof(uint64))
+		{
+			// too short for a single load, at most 49 bits cannot overflow
+			uint64 value = 0;
+
+			for (SIZE_TYPE i = 0; i < length; ++i)
+			{
+				if (i == start && static_cast<uint8>(content[i]) == 0x80)
+					return 0;
+
+				value = (value << 7) | (content[i] & 0x7F);
+
+				if ((content[i] & 0x80) == 0)
+				{
+					*current++ = value;
+					value = 0;
+					start = i + 1;
+				}
+			}
+		}
+		else
+		{
+			for (SIZE_TYPE position = 0; position < length; position += Private::ReadWindowSize)
+			{
+				// bit i is set if byte position + i ends a subidentifier
+				uint32 ends = Private::GetSubidentifierEnds(content, length, position);
+
+				while (ends)
+				{
+					const SIZE_TYPE end = position + Bits::CountTrailingZeros(ends);
+					ends &= ends - 1;
+
+					// most of the arcs are below 128
+					if (end == start)
+						*current++ = static_cast<uint8>(content[end]);
+					else if (!Private::ReadSubidentifier(content, start, end, *current++))
+						return 0;
+
+					start = end + 1;
+				}
+			}
+		}
+
+		// the last byte must end a subidentifier
+		if (length == 0 || start != length)
+			return 0;
+
+		const uint64 first = arcs[1];
+		arcs[0] = (first < 80) ? first / 40 : 2;
+		arcs[1] = first - 40 * arcs[0];
+
+		return current - arcs;
+	}
+
+	/**
+	 * Reads OBJECT IDENTIFIER content into a vector.
+	 *
+	 * \param content		content bytes
+	 * \param length		number of content bytes
+	 * \param[out] arcs		decoded arcs
+	 *
+	 * \return false if the content is malformed
+	 */
+	bool ASN1_Codec::ReadObjectIdentifierContent(const BYTE* content, SIZE_TYPE length, std::vector<uint64>& arcs)
+	{
+		arcs.resize(length + 1);
+		arcs.resize(ReadObjectIdentifierContent(content, length, arcs.data()));
+
+		return !arcs.empty();
+	}
+
+	/**
+	 * Parses dotted decimal notation of an OBJECT IDENTIFIER, e.g. "1.2.840.113549".
+	 *
+	 * \param text			characters of the identifier, not null-terminated
+	 * \param length		number of characters
+	 * \param[out] arcs		parsed arcs
+	 *
+	 * \return false if the text is not a sequence of dot separated decimal numbers without leading zeros
+	 *		   fitting in 64 bits or the arcs are not a valid identifier
+	 */
+	bool ASN1_Codec::ParseObjectIdentifier(const ANSICHAR* text, SIZE_TYPE length, std::vector<uint64>& arcs)
+	{
+		arcs.clear();
+
+		for (SIZE_TYPE position = 0; ; ++position)
+		{
+			const SIZE_TYPE start = position;
+			uint64 arc = 0;
+
+			for (; position < length && text[position] >= '0' && text[position] <= '9'; ++position)
+			{
+				const uint64 digit = text[position] - '0';
+
+				if (arc > (MAX_UINT64 - digit) / 10)
+					return false;
+
+				arc = arc * 10 + digit;
+			}
+
+			// empty arcs and leading zeros
+			if (position == start || (text[start] == '0' && position - start > 1))
+				return false;
+
+			arcs.push_back(arc);
+
+			if (position == length)
+				break;
+
+			if (text[position] != '.')
+				return false;
+		}
+
+		uint64 first;
+		return Private::GetFirstSubidentifier(arcs, first);
+	}
+
+	/// Returns dotted decimal notation of the arcs.
+	std::string ASN1_Codec::FormatObjectIdentifier(Span<const uint64> arcs)
+	{
+		std::string text;
+
+		for (SIZE_T i = 0; i < arcs.Size(); ++i)
+		{
+			if (i)
+				text += '.';
+
+			text += std::to_string(arcs[i]);
+		}
+
+		return text;
+	}
+
+	/**
+	 * Takes a token and encodes an OBJECT IDENTIFIER given in dotted decimal notation.
+	 * Throws bad_sequence if the text is not a valid identifier.
+	 *
+	 * \param goal		token structure that contains token data
+	 * \param source	characters of the identifier, e.g. "1.2.840.113549"
+	 * \param length	number of characters
+	 */
+	void ASN1_Codec::EncodeObjectIdentifier(ASN1EncodedToken& goal, const void* source, SIZE_TYPE length)
+	{
+		std::vector<uint64> arcs;
+
+		if (!ParseObjectIdentifier(static_cast<const ANSICHAR*>(source), length, arcs))
+			throw asn1_bad_sequence{};
+
+		const SIZE_TYPE size = GetObjectIdentifierContentSize(arcs);
+		BYTE* content = goal.AllocateContent(size + sizeof(uint64));
+		WriteObjectIdentifierContent(content, arcs);
+
+		goal.ContentSize = size;
+	}
+
+
+} }
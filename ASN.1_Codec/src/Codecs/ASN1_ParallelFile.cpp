@@ -0,0 +1,267 @@
+#include "ASN1_Codec.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <vector>
+#include "../Platform/WorkerPool.h"
+
+
+
+namespace Real { namespace Codecs {
+
+	using namespace ASN1CodecOptions;
+
+	namespace Private
+	{
+		/// Vectors given to one pwritev call (IOV_MAX on Linux)
+		constexpr int32 MaxVectorsPerCall = 1024;
+
+		/**
+		 * Output of EncodeFileParallel computed before any worker starts.
+		 * Every segment but the last one has the same header, so only two segment headers exist.
+		 */
+		struct ParallelFileLayout
+		{
+			BYTE Header[ASN1_Codec::MaxHeaderSize];
+			uint8 HeaderSize = 0;
+
+			/// Content bytes of a segment, 0 for the primitive form
+			uint64 SegmentSize = 0;
+
+			BYTE SegmentHeader[ASN1_Codec::MaxHeaderSize];
+			uint8 SegmentHeaderSize = 0;
+
+			BYTE LastSegmentHeader[ASN1_Codec::MaxHeaderSize];
+			uint8 LastSegmentHeaderSize = 0;
+
+			uint64 SegmentCount = 0;
+
+			/// Segments of one job (constructed form), 0 if a segment is larger than a slice
+			uint64 SegmentsPerJob = 0;
+
+			/// Jobs one segment is split into if it is larger than a slice, so buffers never exceed ParallelSliceSize
+			uint64 JobsPerSegment = 0;
+
+			/// Input bytes of one job
+			uint64 SliceSize = 0;
+
+			uint64 JobCount = 0;
+		};
+
+		/// Computes headers and slicing of an input of size bytes.
+		void ComputeParallelFileLayout(ParallelFileLayout& layout, uint64 size, uint64 segment_size)
+		{
+			if (segment_size == 0)
+			{
+				layout.HeaderSize = ASN1_Codec::WriteHeader(layout.Header, EASN1ValueType::OctetString, EASN1ClassTagType::UNIVERSAL, EASN1PCType::PRIMITIVE, size);
+				layout.SliceSize = ASN1_Codec::ParallelSliceSize;
+				layout.JobCount = (size + layout.SliceSize - 1) / layout.SliceSize;
+				return;
+			}
+
+			layout.SegmentSize = segment_size;
+			layout.SegmentCount = (size + segment_size - 1) / segment_size;
+
+			const uint64 last_segment_size = layout.SegmentCount ? size - (layout.SegmentCount - 1) * segment_size : 0;
+
+			if (segment_size <= ASN1_Codec::ParallelSliceSize)
+			{
+				layout.SegmentsPerJob = ASN1_Codec::ParallelSliceSize / segment_size;
+				layout.SliceSize = layout.SegmentsPerJob * segment_size;
+				layout.JobCount = (layout.SegmentCount + layout.SegmentsPerJob - 1) / layout.SegmentsPerJob;
+			}
+			else
+			{
+				// the last segment may be shorter and take fewer jobs than the others
+				layout.SliceSize = ASN1_Codec::ParallelSliceSize;
+				layout.JobsPerSegment = (segment_size + layout.SliceSize - 1) / layout.SliceSize;
+				layout.JobCount = layout.SegmentCount ? (layout.SegmentCount - 1) * layout.JobsPerSegment + (last_segment_size + layout.SliceSize - 1) / layout.SliceSize : 0;
+			}
+
+			uint64 content_size = 0;
+
+			if (layout.SegmentCount > 0)
+			{
+
+				layout.SegmentHeaderSize = ASN1_Codec::WriteHeader(layout.SegmentHeader, EASN1ValueType::OctetString, EASN1ClassTagType::UNIVERSAL, EASN1PCType::PRIMITIVE, segment_size);
+				layout.LastSegmentHeaderSize = ASN1_Codec::WriteHeader(layout.LastSegmentHeader, EASN1ValueType::OctetString, EASN1ClassTagType::UNIVERSAL, EASN1PCType::PRIMITIVE, last_segment_size);
+
+				content_size = (layout.SegmentCount - 1) * (layout.SegmentHeaderSize + segment_size) + layout.LastSegmentHeaderSize + last_segment_size;
+			}
+
+			layout.HeaderSize = ASN1_Codec::WriteHeader(layout.Header, EASN1ValueType::OctetString, EASN1ClassTagType::UNIVERSAL, EASN1PCType::CONSTRUCTED, content_size);
+		}
+
+		/// Reads exactly count bytes at offset. Returns false on failure or unexpected end of file.
+		bool ReadAllAt(System::PlatformFile& file, BYTE* destination, uint64 count, uint64 offset)
+		{
+			while (count > 0)
+			{
+				const int64 received = file.ReadAt(destination, count, offset);
+
+				if (received <= 0)
+					return false;
+
+				destination += received;
+				offset += received;
+				count -= received;
+			}
+
+			return true;
+		}
+
+		/**
+		 * Writes segments [first, first + count) of the constructed form.
+		 * Content of the segments lies in content one after another, headers are interleaved by pwritev.
+		 */
+		bool WriteSegmentsAt(System::PlatformFile& output, const ParallelFileLayout& layout, const BYTE* content, uint64 content_size, uint64 first, uint64 count, uint64 offset)
+		{
+			System::IOVector vectors[MaxVectorsPerCall];
+
+			while (count > 0)
+			{
+				const uint64 batch = std::min<uint64>(count, MaxVectorsPerCall / 2);
+				uint64 batch_size = 0;
+
+				for (uint64 i = 0; i < batch; ++i)
+				{
+					const bool bIsLast = first + i == layout.SegmentCount - 1;
+					const uint64 segment_size = std::min(layout.SegmentSize, content_size);
+
+					vectors[2 * i].iov_base = const_cast<BYTE*>(bIsLast ? layout.LastSegmentHeader : layout.SegmentHeader);
+					vectors[2 * i].iov_len = bIsLast ? layout.LastSegmentHeaderSize : layout.SegmentHeaderSize;
+					vectors[2 * i + 1].iov_base = const_cast<BYTE*>(content);
+					vectors[2 * i + 1].iov_len = segment_size;
+
+					batch_size += vectors[2 * i].iov_len + segment_size;
+					content += segment_size;
+					content_size -= segment_size;
+				}
+
+				if (!output.WriteVectorsAt(vectors, static_cast<int32>(2 * batch), offset))
+					return false;
+
+				offset += batch_size;
+				first += batch;
+				count -= batch;
+			}
+
+			return true;
+		}
+
+		/**
+		 * Writes one part of a segment larger than a slice: the first part carries the segment header,
+		 * every part goes right after the parts before it.
+		 */
+		bool WriteSegmentPartAt(System::PlatformFile& output, const ParallelFileLayout& layout, const BYTE* content, uint64 content_size, uint64 segment, uint64 part)
+		{
+			const bool bIsLast = segment == layout.SegmentCount - 1;
+			const uint8 header_size = bIsLast ? layout.LastSegmentHeaderSize : layout.SegmentHeaderSize;
+			const uint64 segment_offset = layout.HeaderSize + segment * (layout.SegmentHeaderSize + layout.SegmentSize);
+
+			if (part > 0)
+			{
+				System::IOVector slice = { const_cast<BYTE*>(content), content_size };
+				return output.WriteVectorsAt(&slice, 1, segment_offset + header_size + part * layout.SliceSize);
+			}
+
+			System::IOVector vectors[2] = {
+				{ const_cast<BYTE*>(bIsLast ? layout.LastSegmentHeader : layout.SegmentHeader), header_size },
+				{ const_cast<BYTE*>(content), content_size }
+			};
+
+			return output.WriteVectorsAt(vectors, 2, segment_offset);
+		}
+	}
+
+
+	/**
+	 * Encodes the whole content of a regular file as an octet string using all workers of the pool.
+	 * The header and the output offset of every slice are computed up front, so each worker reads its slice
+	 * and writes it at its final place (pread/pwrite) independently of the others.
+	 * With segment_size 0 the result is one primitive octet string (DER), otherwise it is a constructed
+	 * octet string of definite length made of primitive segments of segment_size bytes (the last one may be shorter).
+	 *
+	 * \param input			regular file opened for reading, its size is taken from fstat
+	 * \param output		regular file opened for writing, it is written at offsets and its position is not moved
+	 * \param pool			workers to run the slices on
+	 * \param segment_size	content bytes of every segment of the constructed form, 0 for the primitive form
+	 *
+	 * \return false if input size is unknown, the file is shorter than its size or not all the bytes could be written
+	 */
+	bool ASN1_Codec::EncodeFileParallel(System::PlatformFile& input, System::PlatformFile& output, System::WorkerPool& pool, SIZE_TYPE segment_size)
+	{
+		const int64 size = input.Size();
+
+		if (size < 0)
+			return false;
+
+		Private::ParallelFileLayout layout;
+		Private::ComputeParallelFileLayout(layout, size, segment_size);
+
+		System::IOVector header = { layout.Header, layout.HeaderSize };
+
+		if (!output.WriteVectorsAt(&header, 1, 0))
+			return false;
+
+		// allocated by the worker on first use, so a small file does not cost a buffer per thread
+		std::vector<std::unique_ptr<BYTE[]>> buffers(pool.GetWorkerCount());
+		const uint64 buffer_size = std::min<uint64>(layout.SliceSize, size);
+
+		std::atomic<bool> bFailed(false);
+
+		pool.Run(layout.JobCount, [&](uint32 worker_index, uint64 job_index)
+		{
+			if (bFailed.load(std::memory_order_relaxed))
+				return;
+
+			// jobs must not throw, a failed allocation fails the encoding
+			if (!buffers[worker_index])
+				buffers[worker_index].reset(new (std::nothrow) BYTE[buffer_size]);
+
+			BYTE* const buffer = buffers[worker_index].get();
+
+			if (!buffer)
+			{
+				bFailed.store(true, std::memory_order_relaxed);
+				return;
+			}
+
+			// a segment larger than a slice is split into parts of slice size
+			const uint64 segment = layout.JobsPerSegment ? job_index / layout.JobsPerSegment : 0;
+			const uint64 part = layout.JobsPerSegment ? job_index % layout.JobsPerSegment : 0;
+
+			const uint64 input_offset = layout.JobsPerSegment ? segment * layout.SegmentSize + part * layout.SliceSize : job_index * layout.SliceSize;
+			const uint64 slice_end = layout.JobsPerSegment ? std::min<uint64>((segment + 1) * layout.SegmentSize, size) : size;
+			const uint64 slice_size = std::min<uint64>(layout.SliceSize, slice_end - input_offset);
+
+			bool bSucceeded = Private::ReadAllAt(input, buffer, slice_size, input_offset);
+
+			if (bSucceeded && layout.JobsPerSegment)
+			{
+				bSucceeded = Private::WriteSegmentPartAt(output, layout, buffer, slice_size, segment, part);
+			}
+			else if (bSucceeded && layout.SegmentSize == 0)
+			{
+				System::IOVector slice = { buffer, slice_size };
+				bSucceeded = output.WriteVectorsAt(&slice, 1, layout.HeaderSize + input_offset);
+			}
+			else if (bSucceeded)
+			{
+				const uint64 first = job_index * layout.SegmentsPerJob;
+				const uint64 count = std::min(layout.SegmentsPerJob, layout.SegmentCount - first);
+				const uint64 output_offset = layout.HeaderSize + first * (layout.SegmentHeaderSize + layout.SegmentSize);
+
+				bSucceeded = Private::WriteSegmentsAt(output, layout, buffer, slice_size, first, count, output_offset);
+			}
+
+			if (!bSucceeded)
+				bFailed.store(true, std::memory_order_relaxed);
+		});
+
+		return !bFailed.load();
+	}
+
+
+} }
@@ -0,0 +1,181 @@
+#include "ASN1_Reader.h"
+
+
+
+namespace Real { namespace Codecs {
+
+	using namespace ASN1CodecOptions;
+
+	/// Returns string representation of a decode status
+	const TCHAR* GetASN1DecodeStatusString(EASN1DecodeStatus status)
+	{
+		switch (status)
+		{
+		case EASN1DecodeStatus::OK:
+			return "OK";
+		case EASN1DecodeStatus::END:
+			return "END";
+		case EASN1DecodeStatus::TRUNCATED_HEADER:
+			return "TRUNCATED_HEADER";
+		case EASN1DecodeStatus::BAD_TAG_NUMBER:
+			return "BAD_TAG_NUMBER";
+		case EASN1DecodeStatus::BAD_LENGTH:
+			return "BAD_LENGTH";
+		case EASN1DecodeStatus::INDEFINITE_PRIMITIVE:
+			return "INDEFINITE_PRIMITIVE";
+		case EASN1DecodeStatus::CONTENT_OUT_OF_RANGE:
+			return "CONTENT_OUT_OF_RANGE";
+		case EASN1DecodeStatus::MISSING_END_OF_CONTENTS:
+			return "MISSING_END_OF_CONTENTS";
+		case EASN1DecodeStatus::TOO_DEEP:
+			return "TOO_DEEP";
+		case EASN1DecodeStatus::UNEXPECTED_END_OF_CONTENTS:
+			return "UNEXPECTED_END_OF_CONTENTS";
+		case EASN1DecodeStatus::NON_MINIMAL_LENGTH:
+			return "NON_MINIMAL_LENGTH";
+		case EASN1DecodeStatus::INDEFINITE_LENGTH:
+			return "INDEFINITE_LENGTH";
+		default:
+			return "UNKNOWN";
+		}
+	}
+
+	/**
+	 * Reads the next token and moves past it.
+	 *
+	 * \param[out] token read token, valid only if true is returned
+	 *
+	 * \return false at the end of the range or on error (see GetStatus)
+	 */
+	bool ASN1Reader::Next(ASN1DecodedToken& token)
+	{
+		// errors and the end of the range are sticky
+		if (Status != EASN1DecodeStatus::OK)
+			return false;
+
+		if (Current == End)
+			return Fail(EASN1DecodeStatus::END);
+
+		if (!ReadHeader(token))
+			return false;
+
+		if (token.bIsIndefinite && !FindIndefiniteEnd(token))
+			return false;
+
+		Current = token.Content + token.ContentLength + (token.bIsIndefinite ? 2 : 0);
+		return true;
+	}
+
+	/// Reads identifier and length octets. Returns false (and sets Status) if they are malformed.
+	bool ASN1Reader::ReadHeader(ASN1DecodedToken& token)
+	{
+		const BYTE* position = Current;
+
+		const uint8 identifier = static_cast<uint8>(*position++);
+
+		token.Class = static_cast<EASN1ClassTagType>(identifier & 0b11000000);
+		token.bIsConstructed = (identifier & _CONSTRUCTED_PC_TAG_BITS_) != 0;
+		token.TagNumber = identifier & 0b00011111;
+
+		// high tag number form: base-128 groups, bit 8 set on every group except the last one
+		if (token.TagNumber == 0b00011111)
+		{
+			token.TagNumber = 0;
+
+			if (position != End && static_cast<uint8>(*position) == 0b10000000)
+				return Fail(EASN1DecodeStatus::BAD_TAG_NUMBER);
+
+			uint8 group;
+			do
+			{
+				if (position == End)
+					return Fail(EASN1DecodeStatus::TRUNCATED_HEADER);
+
+				if (token.TagNumber >> 57)
+					return Fail(EASN1DecodeStatus::BAD_TAG_NUMBER);
+
+				group = static_cast<uint8>(*position++);
+				token.TagNumber = (token.TagNumber << 7) | (group & 0b01111111);
+			}
+			while (group & 0b10000000);
+		}
+
+		if (position == End)
+			return Fail(EASN1DecodeStatus::TRUNCATED_HEADER);
+
+		const uint8 length_octet = static_cast<uint8>(*position++);
+
+		token.bIsIndefinite = false;
+		token.ContentLength = 0;
+
+		// short form
+		if (length_octet < 0b10000000)
+		{
+			token.ContentLength = length_octet;
+		}
+		// indefinite form, only constructed tokens may use it
+		else if (length_octet == 0b10000000)
+		{
+			if (!token.bIsConstructed)
+				return Fail(EASN1DecodeStatus::INDEFINITE_PRIMITIVE);
+
+			if (Rules == EASN1DecodeRules::DER)
+				return Fail(EASN1DecodeStatus::INDEFINITE_LENGTH);
+
+			token.bIsIndefinite = true;
+		}
+		// long form, 0xFF is reserved
+		else
+		{
+			const uint8 count = length_octet & 0b01111111;
+
+			if (length_octet == 0xFF || count > sizeof(uint64))
+				return Fail(EASN1DecodeStatus::BAD_LENGTH);
+
+			if (static_cast<uint64>(End - position) < count)
+				return Fail(EASN1DecodeStatus::TRUNCATED_HEADER);
+
+			for (uint8 i = 0; i < count; ++i)
+				token.ContentLength = (token.ContentLength << 8) | static_cast<uint8>(position[i]);
+
+			position += count;
+
+			// DER encoder would have written exactly this many bytes
+			if (Rules == EASN1DecodeRules::DER && ASN1_Codec::GetLengthFieldSize(token.ContentLength) != 1 + count)
+				return Fail(EASN1DecodeStatus::NON_MINIMAL_LENGTH);
+		}
+
+		token.HeaderLength = static_cast<uint8>(position - Current);
+		token.Content = position;
+
+		if (token.ContentLength > static_cast<uint64>(End - position))
+			return Fail(EASN1DecodeStatus::CONTENT_OUT_OF_RANGE);
+
+		return true;
+	}
+
+	/// Walks indefinite length content up to the end-of-contents octets and sets ContentLength.
+	bool ASN1Reader::FindIndefiniteEnd(ASN1DecodedToken& token)
+	{
+		if (Depth + 1 >= MaxDepth)
+			return Fail(EASN1DecodeStatus::TOO_DEEP);
+
+		ASN1Reader nested(token.Content, End, Depth + 1, Rules);
+		ASN1DecodedToken child;
+
+		for (;;)
+		{
+			// end-of-contents: universal primitive tag 0 with zero length
+			if (nested.End - nested.Current >= 2 && nested.Current[0] == 0 && nested.Current[1] == 0)
+			{
+				token.ContentLength = nested.Current - token.Content;
+				return true;
+			}
+
+			if (!nested.Next(child))
+				return Fail(nested.Status == EASN1DecodeStatus::END ? EASN1DecodeStatus::MISSING_END_OF_CONTENTS : nested.Status);
+		}
+	}
+
+
+} }
@@ -0,0 +1,151 @@
+#ifndef __REAL_ASN1_READER__
+#define __REAL_ASN1_READER__
+
+#include "ASN1_Codec.h"
+
+
+namespace Real { namespace Codecs {
+
+
+	/**
+	 * Result of reading a token with ASN1Reader.
+	 */
+	enum class EASN1DecodeStatus : uint8
+	{
+		OK,							///< token has been read
+		END,						///< no more tokens in the range
+		TRUNCATED_HEADER,			///< identifier or length octets run past the end of the range
+		BAD_TAG_NUMBER,				///< multi-byte tag number does not fit in 64 bits or has leading zero groups
+		BAD_LENGTH,					///< reserved 0xFF length octet or more length bytes than 64 bits hold
+		INDEFINITE_PRIMITIVE,		///< indefinite length used with a primitive token
+		CONTENT_OUT_OF_RANGE,		///< content runs past the end of the range
+		MISSING_END_OF_CONTENTS,	///< indefinite length content is not terminated
+		TOO_DEEP,					///< indefinite length tokens are nested deeper than ASN1Reader::MaxDepth
+		UNEXPECTED_END_OF_CONTENTS,	///< end-of-contents octets outside of indefinite length content
+		NON_MINIMAL_LENGTH,			///< DER only: long form where short form fits or leading zero length bytes
+		INDEFINITE_LENGTH,			///< DER only: indefinite length is not allowed
+	};
+
+	/**
+	 * Set of rules a decoder checks headers against.
+	 */
+	enum class EASN1DecodeRules : uint8
+	{
+		BER,	///< any valid length form
+		DER,	///< definite lengths with the minimal number of length bytes only
+	};
+
+	/// Returns string representation of a decode status
+	const TCHAR* GetASN1DecodeStatusString(EASN1DecodeStatus status);
+
+
+	/**
+	 * Token returned by ASN1Reader. Never owns anything, content points into the reader's range.
+	 */
+	struct ASN1DecodedToken
+	{
+		ASN1CodecOptions::EASN1ClassTagType	Class;
+
+		bool		bIsConstructed;
+
+		/// true if the token has been encoded with indefinite length (ContentLength excludes end-of-contents octets)
+		bool		bIsIndefinite;
+
+		uint64		TagNumber;
+
+		/// Number of identifier and length bytes
+		uint8		HeaderLength;
+
+		const BYTE*	Content;
+
+		uint64		ContentLength;
+
+		/// Returns number of bytes the whole token takes including end-of-contents octets.
+		FORCEINLINE uint64 GetTotalLength() const { return HeaderLength + ContentLength + (bIsIndefinite ? 2 : 0); }
+	};
+
+
+	/**
+	 * Pull-parser over a range of BER/DER encoded bytes.
+	 * Every call to Next yields the next token on the same level and skips its content.
+	 * Constructed tokens are entered with a new reader over the token content.
+	 * Nothing is allocated, malformed headers are rejected before the content is touched.
+	 *
+	 * \code
+	 * ASN1Reader reader(data, size);
+	 * ASN1DecodedToken token;
+	 * while (reader.Next(token)) { ... }
+	 * if (reader.GetStatus() != EASN1DecodeStatus::END) { ... malformed ... }
+	 * \endcode
+	 */
+	class ASN1Reader
+	{
+	public:
+
+		/// Maximum nesting of indefinite length tokens (they have to be walked to find their end)
+		static constexpr uint32 MaxDepth = 64;
+
+	public:
+
+		/**
+		 * \param data	first byte of the range
+		 * \param size	number of bytes in the range
+		 * \param rules	rules headers are checked against
+		 */
+		ASN1Reader(const void* data, uint64 size, EASN1DecodeRules rules = EASN1DecodeRules::BER)
+			: Begin(static_cast<const BYTE*>(data)), Current(Begin), End(Begin + size), Status(EASN1DecodeStatus::OK), Depth(0), Rules(rules) { }
+
+		/// Creates a reader over the content of a constructed token.
+		explicit ASN1Reader(const ASN1DecodedToken& token, EASN1DecodeRules rules = EASN1DecodeRules::BER)
+			: ASN1Reader(token.Content, token.ContentLength, rules) { }
+
+		/**
+		 * Reads the next token and moves past it.
+		 *
+		 * \param[out] token read token, valid only if true is returned
+		 *
+		 * \return false at the end of the range or on error (see GetStatus)
+		 */
+		bool Next(ASN1DecodedToken& token);
+
+		/// Returns status of the last Next call.
+		FORCEINLINE EASN1DecodeStatus GetStatus() const { return Status; }
+
+		/// Checks if all the bytes of the range have been read.
+		FORCEINLINE bool AtEnd() const { return Current == End; }
+
+		/// Returns offset of the next token from the beginning of the range.
+		FORCEINLINE uint64 GetOffset() const { return Current - Begin; }
+
+	private:
+
+		ASN1Reader(const BYTE* begin, const BYTE* end, uint32 depth, EASN1DecodeRules rules)
+			: Begin(begin), Current(begin), End(end), Status(EASN1DecodeStatus::OK), Depth(depth), Rules(rules) { }
+
+		/// Reads identifier and length octets. Returns false (and sets Status) if they are malformed.
+		bool ReadHeader(ASN1DecodedToken& token);
+
+		/// Walks indefinite length content up to the end-of-contents octets and sets ContentLength.
+		bool FindIndefiniteEnd(ASN1DecodedToken& token);
+
+		FORCEINLINE bool Fail(EASN1DecodeStatus status) { Status = status; return false; }
+
+	private:
+
+		const BYTE* Begin;
+		const BYTE* Current;
+		const BYTE* End;
+
+		EASN1DecodeStatus Status;
+
+		uint32 Depth;
+
+		EASN1DecodeRules Rules;
+
+	};
+
+
+} }
+
+
+#endif
@@ -0,0 +1,408 @@
+#include "ASN1_Codec.h"
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include "../Misc/Endian.hpp"
+#include "../Misc/Bits.hpp"
+
+
+
+namespace Real { namespace Codecs {
+
+	using namespace ASN1CodecOptions;
+
+	namespace Private
+	{
+		constexpr uint64 RealFractionMask = (1ull << 52) - 1;
+
+		/// Biased exponent of infinities and NaN
+		constexpr uint32 RealSpecialExponent = 0x7FF;
+
+		/// Subtracted from the biased exponent when the mantissa is taken as an integer: bias and 52 fraction bits
+		constexpr int32 RealIntegerExponentBias = 1023 + 52;
+
+		/// First content octets of the special values (X.690 8.5.9)
+		constexpr uint8 RealPlusInfinity	= 0x40;
+		constexpr uint8 RealMinusInfinity	= 0x41;
+		constexpr uint8 RealNotANumber		= 0x42;
+		constexpr uint8 RealMinusZero		= 0x43;
+
+		/// Binary form bit of the first content octet
+		constexpr uint8 RealBinaryForm		= 0x80;
+
+		/// Exponent of a base 8 or 16 digit in bits, 0 for the reserved base
+		constexpr uint8 RealBaseShifts[4] = { 1, 3, 4, 0 };
+
+		/// Exponents beyond this bound give zero or infinity for any mantissa of up to 64 bits.
+		constexpr int64 RealExponentBound = 2200;
+
+		/**
+		 * Decoded exponents and numbers of dropped mantissa bytes saturate here before they are summed.
+		 * Both are far beyond any content that fits in memory, so the sum cannot overflow and keeps its sign.
+		 */
+		constexpr int64 RealExponentSaturation = 1ll << 60;
+		constexpr uint64 RealDroppedBytesSaturation = 1ull << 56;
+
+		FORCEINLINE uint64 GetRealBits(double value)
+		{
+			uint64 bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+
+			return bits;
+		}
+
+		FORCEINLINE uint32 GetBiasedExponent(uint64 bits)
+		{
+			return static_cast<uint32>(bits >> 52) & RealSpecialExponent;
+		}
+
+		/// Checks if the value has no mantissa and exponent: zeros, infinities and NaN.
+		FORCEINLINE bool IsSpecialReal(uint64 bits)
+		{
+			return GetBiasedExponent(bits) == RealSpecialExponent || (bits << 1) == 0;
+		}
+
+		/// Writes content of a special value, returns its size (0 for +0, 1 for others).
+		FORCEINLINE uint8 WriteSpecialRealContent(BYTE* destination, uint64 bits)
+		{
+			const bool bIsNegative = (bits >> 63) != 0;
+
+			if ((bits << 1) == 0)
+			{
+				if (!bIsNegative)
+					return 0;
+
+				destination[0] = static_cast<BYTE>(RealMinusZero);
+				return 1;
+			}
+
+			if ((bits & RealFractionMask) != 0)
+				destination[0] = static_cast<BYTE>(RealNotANumber);
+			else
+				destination[0] = static_cast<BYTE>(bIsNegative ? RealMinusInfinity : RealPlusInfinity);
+
+			return 1;
+		}
+
+		/**
+		 * Splits a finite non-zero value into an odd integer mantissa and a binary exponent: |value| = mantissa * 2^exponent.
+		 * Subnormals have no hidden bit and the exponent of the smallest normal value.
+		 */
+		FORCEINLINE void DecomposeReal(uint64 bits, uint64& mantissa, int32& exponent)
+		{
+			const uint32 biased_exponent = GetBiasedExponent(bits);
+
+			mantissa = (bits & RealFractionMask) | (static_cast<uint64>(biased_exponent != 0) << 52);
+			exponent = static_cast<int32>(biased_exponent + (biased_exponent == 0)) - RealIntegerExponentBias;
+
+			// DER wants an odd mantissa, trailing zeros go to the exponent
+			const uint32 trailing_zeros = Bits::CountTrailingZeros(mantissa);
+			mantissa >>= trailing_zeros;
+			exponent += static_cast<int32>(trailing_zeros);
+		}
+
+		/// Number of two's complement exponent bytes: 1 or 2, every double exponent fits in 2.
+		FORCEINLINE uint32 GetRealExponentSize(int32 exponent)
+		{
+			return 1 + (static_cast<uint32>(exponent + 128) > 255);
+		}
+
+		/// Number of mantissa bytes: 1 to 7.
+		FORCEINLINE uint32 GetRealMantissaSize(uint64 mantissa)
+		{
+			return (64 - Bits::CountLeadingZeros(mantissa) + 7) / 8;
+		}
+
+		/**
+		 * Builds a positive double of mantissa * 2^exponent. Values of up to 53 significant bits in the normal range
+		 * are exact and go straight to the IEEE 754 bits, others are rounded by the conversion and ldexp.
+		 */
+		FORCEINLINE double AssembleReal(uint64 mantissa, int64 exponent)
+		{
+			const uint32 width = 64 - Bits::CountLeadingZeros(mantissa);
+			const int64 top_exponent = exponent + width - 1;
+
+			if (width <= 53 && top_exponent >= -1022 && top_exponent <= 1023)
+			{
+				// the highest bit becomes the hidden one
+				const uint64 bits = (static_cast<uint64>(top_exponent + 1023) << 52) | ((mantissa << (53 - width)) & RealFractionMask);
+
+				double value;
+				std::memcpy(&value, &bits, sizeof(value));
+
+				return value;
+			}
+
+			exponent = (exponent < -RealExponentBound) ? -RealExponentBound : (exponent > RealExponentBound) ? RealExponentBound : exponent;
+			return std::ldexp(static_cast<double>(mantissa), static_cast<int32>(exponent));
+		}
+	}
+
+	/**
+	 * Returns number of REAL content bytes of the value: 0 for +0, 1 for -0, infinities and NaN,
+	 * otherwise the first octet, 1 or 2 exponent bytes and 1 to 7 mantissa bytes.
+	 *
+	 * \param value any value
+	 */
+	uint8 ASN1_Codec::GetRealContentSize(double value)
+	{
+		const uint64 bits = Private::GetRealBits(value);
+
+		if (Private::IsSpecialReal(bits))
+			return (bits == 0) ? 0 : 1;
+
+		uint64 mantissa;
+		int32 exponent;
+		Private::DecomposeReal(bits, mantissa, exponent);
+
+		return static_cast<uint8>(1 + Private::GetRealExponentSize(exponent) + Private::GetRealMantissaSize(mantissa));
+	}
+
+	/**
+	 * Writes REAL content in the DER binary form: base 2, no scaling, odd mantissa and minimal exponent.
+	 * Mantissa and exponent come straight from the IEEE 754 bits, trailing zero bits of the mantissa move to the exponent.
+	 * Always touches MaxRealContentSize bytes, only the first GetRealContentSize(value) of them are meaningful.
+	 *
+	 * \param destination	buffer of at least MaxRealContentSize bytes
+	 * \param value			any value
+	 *
+	 * \return number of meaningful bytes
+	 */
+	uint8 ASN1_Codec::WriteRealContent(BYTE* destination, double value)
+	{
+		const uint64 bits = Private::GetRealBits(value);
+
+		if (Private::IsSpecialReal(bits))
+			return Private::WriteSpecialRealContent(destination, bits);
+
+		uint64 mantissa;
+		int32 exponent;
+		Private::DecomposeReal(bits, mantissa, exponent);
+
+		const uint32 exponent_size = Private::GetRealExponentSize(exponent);
+		const uint32 mantissa_size = Private::GetRealMantissaSize(mantissa);
+
+		// binary form, sign, base 2, no scaling, exponent format 00 or 01 (1 or 2 bytes)
+		destination[0] = static_cast<BYTE>(Private::RealBinaryForm | ((bits >> 57) & 0x40) | (exponent_size - 1));
+
+		// both fields move to the top and are stored big endian, the tails are garbage
+		const uint16 big_endian_exponent = Endian::native_to_big<uint16>(static_cast<uint16>(static_cast<uint32>(exponent) << (16 - 8 * exponent_size)));
+		std::memcpy(destination + 1, &big_endian_exponent, sizeof(big_endian_exponent));
+
+		const uint64 big_endian_mantissa = Endian::native_to_big<uint64>(mantissa << (64 - 8 * mantissa_size));
+		std::memcpy(destination + 1 + exponent_size, &big_endian_mantissa, sizeof(big_endian_mantissa));
+
+		return static_cast<uint8>(1 + exponent_size + mantissa_size);
+	}
+
+	/// Writes REAL content of a float, the encoding is the same as for the equal double.
+	uint8 ASN1_Codec::WriteRealContent(BYTE* destination, float value)
+	{
+		return WriteRealContent(destination, static_cast<double>(value));
+	}
+
+	/**
+	 * Writes a whole REAL token with universal tag. Always touches MaxRealTokenSize bytes.
+	 *
+	 * \param destination	buffer of at least MaxRealTokenSize bytes
+	 * \param value			any value
+	 *
+	 * \return number of meaningful bytes
+	 */
+	uint8 ASN1_Codec::WriteReal(BYTE* destination, double value)
+	{
+		const uint8 size = WriteRealContent(destination + 2, value);
+
+		destination[0] = static_cast<BYTE>(EASN1ValueType::Real);
+		destination[1] = static_cast<BYTE>(size);
+
+		return 2 + size;
+	}
+
+	/**
+	 * Writes REAL tokens for all the values one after another. Every token is written with fixed size stores
+	 * and the cursor moves only by its real size, like EncodeIntegerBatch does.
+	 *
+	 * \param values		values to encode
+	 * \param destination	buffer of at least values.Size() * MaxRealTokenSize bytes
+	 *
+	 * \return number of written bytes
+	 */
+	ASN1_Codec::SIZE_TYPE ASN1_Codec::EncodeRealBatch(Span<const double> values, BYTE* destination)
+	{
+		BYTE* current = destination;
+
+		for (const double value : values)
+			current += WriteReal(current, value);
+
+		return current - destination;
+	}
+
+	/**
+	 * Writes REAL tokens for all the float values one after another. Same rules as the double overload.
+	 *
+	 * \param values		values to encode
+	 * \param destination	buffer of at least values.Size() * MaxRealTokenSize bytes
+	 *
+	 * \return number of written bytes
+	 */
+	ASN1_Codec::SIZE_TYPE ASN1_Codec::EncodeRealBatch(Span<const float> values, BYTE* destination)
+	{
+		BYTE* current = destination;
+
+		for (const float value : values)
+			current += WriteReal(current, static_cast<double>(value));
+
+		return current - destination;
+	}
+
+	/**
+	 * Reads REAL content of the binary form with any base (2, 8, 16), scaling factor and exponent format,
+	 * and the special values. DER content of a normal double is assembled straight into its IEEE 754 bits.
+	 * Mantissas longer than 8 bytes are rounded.
+	 *
+	 * \param content		content bytes
+	 * \param length		number of content bytes
+	 * \param[out] value	decoded value, out of range values become infinities or zeros
+	 *
+	 * \return false if the content is truncated, uses the reserved base or the decimal form
+	 */
+	bool ASN1_Codec::ReadRealContent(const BYTE* content, SIZE_TYPE length, double& value)
+	{
+		if (length == 0)
+		{
+			value = 0.0;
+			return true;
+		}
+
+		const uint8 first = static_cast<uint8>(content[0]);
+
+		if ((first & Private::RealBinaryForm) == 0)
+		{
+			if (length != 1)
+				return false;
+
+			switch (first)
+			{
+			case Private::RealPlusInfinity:		value = std::numeric_limits<double>::infinity(); return true;
+			case Private::RealMinusInfinity:	value = -std::numeric_limits<double>::infinity(); return true;
+			case Private::RealNotANumber:		value = std::numeric_limits<double>::quiet_NaN(); return true;
+			case Private::RealMinusZero:		value = -0.0; return true;
+			default:							return false;	// decimal forms
+			}
+		}
+
+		const uint32 base_shift = Private::RealBaseShifts[(first >> 4) & 3];
+		const uint32 scale = (first >> 2) & 3;
+
+		if (base_shift == 0)
+			return false;
+
+		// exponent format 11: the length of the exponent is in the next octet
+		SIZE_TYPE position = 1;
+		SIZE_TYPE exponent_size = (first & 3) + 1;
+
+		if ((first & 3) == 3)
+		{
+			if (length < 2)
+				return false;
+
+			exponent_size = static_cast<uint8>(content[1]);
+			position = 2;
+		}
+
+		// at least one mantissa byte has to follow
+		if (exponent_size == 0 || position + exponent_size >= length)
+			return false;
+
+		int64 exponent;
+
+		if (exponent_size > sizeof(int64))
+		{
+			// exponents are minimal, so such a long one is far out of range
+			exponent = (static_cast<int8>(content[position]) < 0) ? -Private::RealExponentSaturation : Private::RealExponentSaturation;
+		}
+		else
+		{
+			ReadIntegerContent(content + position, exponent_size, exponent);
+			exponent = (exponent < -Private::RealExponentSaturation) ? -Private::RealExponentSaturation : (exponent > Private::RealExponentSaturation) ? Private::RealExponentSaturation : exponent;
+		}
+
+		position += exponent_size;
+
+		// leading zero bytes do not count, the top 8 significant bytes are kept and the rest only rounds them
+		while (position < length && content[position] == 0)
+			++position;
+
+		const SIZE_TYPE mantissa_size = length - position;
+		const SIZE_TYPE kept_size = (mantissa_size < sizeof(uint64)) ? mantissa_size : sizeof(uint64);
+
+		uint64 mantissa = 0;
+
+		for (SIZE_TYPE i = 0; i < kept_size; ++i)
+			mantissa = (mantissa << 8) | static_cast<uint8>(content[position + i]);
+
+		bool bHasDroppedBits = false;
+
+		for (SIZE_TYPE i = position + kept_size; i < length; ++i)
+			bHasDroppedBits |= content[i] != 0;
+
+		// a sticky bit below the 53 kept ones keeps the rounding right
+		mantissa |= static_cast<uint64>(bHasDroppedBits);
+
+		// only the whole exponent is clamped (by AssembleReal): dropped bytes of a long mantissa may bring a far exponent back in range
+		const uint64 dropped_size = (mantissa_size - kept_size < Private::RealDroppedBytesSaturation) ? mantissa_size - kept_size : Private::RealDroppedBytesSaturation;
+
+		const int64 binary_exponent = exponent * base_shift + scale + 8 * static_cast<int64>(dropped_size);
+		const double magnitude = mantissa ? Private::AssembleReal(mantissa, binary_exponent) : 0.0;
+
+		value = (first & 0x40) ? -magnitude : magnitude;
+		return true;
+	}
+
+	/**
+	 * Reads REAL content into a float, the value is rounded to the nearest float.
+	 *
+	 * \param content		content bytes
+	 * \param length		number of content bytes
+	 * \param[out] value	decoded value
+	 *
+	 * \return false if the content is malformed, see the double overload
+	 */
+	bool ASN1_Codec::ReadRealContent(const BYTE* content, SIZE_TYPE length, float& value)
+	{
+		double wide;
+
+		if (!ReadRealContent(content, length, wide))
+			return false;
+
+		value = static_cast<float>(wide);
+		return true;
+	}
+
+	/**
+	 * Takes a token and encodes a native float or double as binary REAL content.
+	 *
+	 * \param goal		token structure that contains token data
+	 * \param source	native floating point value
+	 * \param length	size of the value in bytes: 4 or 8
+	 */
+	void ASN1_Codec::EncodeReal(ASN1EncodedToken& goal, const void* source, SIZE_TYPE length)
+	{
+		double value;
+
+		switch (length)
+		{
+		case sizeof(float): { float v; std::memcpy(&v, source, sizeof(v)); value = v; break; }
+		case sizeof(double): { std::memcpy(&value, source, sizeof(value)); break; }
+		default:
+			throw asn1_bad_sequence{};
+		}
+
+		BYTE* content = goal.AllocateContent(MaxRealContentSize);
+
+		goal.ContentSize = WriteRealContent(content, value);
+	}
+
+
+} }
@@ -0,0 +1,181 @@
+#include "ASN1_ReverseWriter.h"
+#include <cstring>
+
+
+
+namespace Real { namespace Codecs {
+
+	using namespace ASN1CodecOptions;
+
+	/**
+	 * Prepends identifier and length octets of a constructed token around everything written since the mark.
+	 *
+	 * \param mark			value returned by Mark before the content has been written
+	 * \param class_type	type of identifier octet class
+	 * \param tag_number	tag number
+	 */
+	void ASN1ReverseWriter::CloseConstructed(SIZE_TYPE mark, EASN1ClassTagType class_type, uint64 tag_number)
+	{
+		if (mark > GetSize())
+			throw Codec::bad_sequence{};
+
+		PrependHeader(class_type, EASN1PCType::CONSTRUCTED, tag_number, GetSize() - mark);
+	}
+
+	/**
+	 * Prepends identifier and length octets.
+	 *
+	 * \param class_type	type of identifier octet class
+	 * \param pc_type		type of pc field (primitive / constructed)
+	 * \param tag_number	tag number
+	 * \param length		length of the content in bytes
+	 */
+	void ASN1ReverseWriter::PrependHeader(EASN1ClassTagType class_type, EASN1PCType pc_type, uint64 tag_number, SIZE_TYPE length)
+	{
+		// the header is built in front order, its size is known only after writing
+		BYTE header[ASN1_Codec::MaxHeaderSize];
+		const uint8 size = ASN1_Codec::WriteTaggedHeader(header, class_type, pc_type, tag_number, length);
+
+		std::memcpy(Reserve(size), header, size);
+	}
+
+	/**
+	 * Prepends a primitive token: its content and then its header.
+	 *
+	 * \param class_type	type of identifier octet class
+	 * \param tag_number	tag number
+	 * \param content		content bytes
+	 * \param length		length of the content in bytes
+	 */
+	void ASN1ReverseWriter::PrependPrimitive(EASN1ClassTagType class_type, uint64 tag_number, const void* content, SIZE_TYPE length)
+	{
+		PrependRaw(content, length);
+		PrependHeader(class_type, EASN1PCType::PRIMITIVE, tag_number, length);
+	}
+
+	/// Prepends an INTEGER with universal tag.
+	void ASN1ReverseWriter::PrependInteger(int64 value)
+	{
+		BYTE token[ASN1_Codec::MaxIntegerTokenSize];
+		const uint8 size = ASN1_Codec::WriteInteger(token, value);
+
+		std::memcpy(Reserve(size), token, size);
+	}
+
+	/// Prepends an ENUMERATED with universal tag.
+	void ASN1ReverseWriter::PrependEnumerated(int64 value)
+	{
+		BYTE token[ASN1_Codec::MaxIntegerTokenSize];
+		const uint8 size = ASN1_Codec::WriteEnumerated(token, value);
+
+		std::memcpy(Reserve(size), token, size);
+	}
+
+	/// Prepends a BOOLEAN with universal tag.
+	void ASN1ReverseWriter::PrependBoolean(bool value)
+	{
+		ASN1_Codec::WriteBoolean(Reserve(3), value);
+	}
+
+	/// Prepends a NULL with universal tag.
+	void ASN1ReverseWriter::PrependNull()
+	{
+		ASN1_Codec::WriteNull(Reserve(2));
+	}
+
+	/// Prepends a REAL with universal tag.
+	void ASN1ReverseWriter::PrependReal(double value)
+	{
+		BYTE token[ASN1_Codec::MaxRealTokenSize];
+		const uint8 size = ASN1_Codec::WriteReal(token, value);
+
+		std::memcpy(Reserve(size), token, size);
+	}
+
+	/**
+	 * Prepends OBJECT IDENTIFIER content without a header.
+	 * Throws Codec::bad_sequence if the arcs are not a valid identifier.
+	 *
+	 * \param arcs arcs of the identifier
+	 *
+	 * \return number of content bytes
+	 */
+	ASN1ReverseWriter::SIZE_TYPE ASN1ReverseWriter::PrependObjectIdentifierContent(Span<const uint64> arcs)
+	{
+		const SIZE_TYPE size = ASN1_Codec::GetObjectIdentifierContentSize(arcs);
+
+		if (size == 0)
+			throw Codec::bad_sequence{};
+
+		// content is written with 8-byte stores running past its end, that would overwrite the bytes
+		// already prepended, so it is built in a scratch buffer first (on the stack for usual identifiers)
+		BYTE local[128];
+		std::vector<BYTE> heap;
+		BYTE* scratch = local;
+
+		if (size + sizeof(uint64) > sizeof(local))
+		{
+			heap.resize(size + sizeof(uint64));
+			scratch = heap.data();
+		}
+
+		ASN1_Codec::WriteObjectIdentifierContent(scratch, arcs);
+		std::memcpy(Reserve(size), scratch, size);
+
+		return size;
+	}
+
+	/// Prepends an OBJECT IDENTIFIER with universal tag. Throws Codec::bad_sequence if the arcs are not a valid identifier.
+	void ASN1ReverseWriter::PrependObjectIdentifier(Span<const uint64> arcs)
+	{
+		const SIZE_TYPE size = PrependObjectIdentifierContent(arcs);
+		PrependHeader(EASN1ClassTagType::UNIVERSAL, EASN1PCType::PRIMITIVE, static_cast<uint64>(EASN1ValueType::ObjectIdentifier), size);
+	}
+
+	/**
+	 * Prepends BIT STRING content of byte flags without a header, any non-zero byte is a set bit.
+	 *
+	 * \param flags one flag per byte
+	 *
+	 * \return number of content bytes
+	 */
+	ASN1ReverseWriter::SIZE_TYPE ASN1ReverseWriter::PrependBitStringContent(Span<const uint8> flags)
+	{
+		// packing writes exactly the content, so it goes straight to the front
+		const SIZE_TYPE size = ASN1_Codec::GetBitStringContentSize(flags.Size());
+		ASN1_Codec::WriteBitStringContent(Reserve(size), flags);
+
+		return size;
+	}
+
+	/// Prepends a BIT STRING of byte flags with universal tag.
+	void ASN1ReverseWriter::PrependBitString(Span<const uint8> flags)
+	{
+		const SIZE_TYPE size = PrependBitStringContent(flags);
+		PrependHeader(EASN1ClassTagType::UNIVERSAL, EASN1PCType::PRIMITIVE, static_cast<uint64>(EASN1ValueType::BitString), size);
+	}
+
+	/**
+	 * Prepends already encoded bytes as they are.
+	 *
+	 * \param data	bytes
+	 * \param size	number of bytes
+	 */
+	void ASN1ReverseWriter::PrependRaw(const void* data, SIZE_TYPE size)
+	{
+		if (size)
+			std::memcpy(Reserve(size), data, size);
+	}
+
+	/// Moves the front by size bytes. Throws Codec::bad_sequence if the buffer is full.
+	BYTE* ASN1ReverseWriter::Reserve(SIZE_TYPE size)
+	{
+		if (size > GetFreeSpace())
+			throw Codec::bad_sequence{};
+
+		Current -= size;
+		return Current;
+	}
+
+
+} }
@@ -0,0 +1,159 @@
+#ifndef __REAL_ASN1_REVERSE_WRITER__
+#define __REAL_ASN1_REVERSE_WRITER__
+
+#include "ASN1_Codec.h"
+
+
+namespace Real { namespace Codecs {
+
+
+	/**
+	 * Writes DER from the end of a preallocated buffer toward its front.
+	 * Content of a constructed token is written before its header, so the length is already known
+	 * when the header is prepended: nested structures are encoded in one pass, nothing is copied twice
+	 * and nothing is patched. Children are prepended in reverse order (last one first).
+	 * Nesting depth is unlimited, every open constructed token is just a mark kept by the caller.
+	 *
+	 * \code
+	 * ASN1ReverseWriter writer(buffer, capacity);
+	 * const auto sequence = writer.Mark();
+	 *     writer.PrependInteger(second);
+	 *     writer.PrependInteger(first);
+	 * writer.CloseSequence(sequence);
+	 * output.WriteAll(writer.GetData(), writer.GetSize());
+	 * \endcode
+	 */
+	class ASN1ReverseWriter
+	{
+	public:
+
+		typedef ASN1_Codec::SIZE_TYPE SIZE_TYPE;
+
+	public:
+
+		/**
+		 * \param buffer	memory to write to, encoded bytes end at buffer + capacity
+		 * \param capacity	size of the buffer in bytes
+		 */
+		ASN1ReverseWriter(BYTE* buffer, SIZE_TYPE capacity)
+			: Begin(buffer), Current(buffer + capacity), End(buffer + capacity) { }
+
+		/// Starts content of a constructed token. Returns value to pass to CloseConstructed.
+		FORCEINLINE SIZE_TYPE Mark() const { return GetSize(); }
+
+		/**
+		 * Prepends identifier and length octets of a constructed token around everything written since the mark.
+		 *
+		 * \param mark			value returned by Mark before the content has been written
+		 * \param class_type	type of identifier octet class
+		 * \param tag_number	tag number
+		 */
+		void CloseConstructed(SIZE_TYPE mark, ASN1CodecOptions::EASN1ClassTagType class_type, uint64 tag_number);
+
+		/// Closes a SEQUENCE (or SEQUENCE OF) with universal tag.
+		FORCEINLINE void CloseSequence(SIZE_TYPE mark) { CloseConstructed(mark, ASN1CodecOptions::EASN1ClassTagType::UNIVERSAL, static_cast<uint64>(ASN1CodecOptions::EASN1ValueType::Sequence)); }
+
+		/// Closes a SET (or SET OF) with universal tag.
+		FORCEINLINE void CloseSet(SIZE_TYPE mark) { CloseConstructed(mark, ASN1CodecOptions::EASN1ClassTagType::UNIVERSAL, static_cast<uint64>(ASN1CodecOptions::EASN1ValueType::Set)); }
+
+		/**
+		 * Prepends identifier and length octets.
+		 *
+		 * \param class_type	type of identifier octet class
+		 * \param pc_type		type of pc field (primitive / constructed)
+		 * \param tag_number	tag number
+		 * \param length		length of the content in bytes
+		 */
+		void PrependHeader(ASN1CodecOptions::EASN1ClassTagType class_type, ASN1CodecOptions::EASN1PCType pc_type, uint64 tag_number, SIZE_TYPE length);
+
+		/**
+		 * Prepends a primitive token: its content and then its header.
+		 *
+		 * \param class_type	type of identifier octet class
+		 * \param tag_number	tag number
+		 * \param content		content bytes
+		 * \param length		length of the content in bytes
+		 */
+		void PrependPrimitive(ASN1CodecOptions::EASN1ClassTagType class_type, uint64 tag_number, const void* content, SIZE_TYPE length);
+
+		/// Prepends an OCTET STRING with universal tag.
+		FORCEINLINE void PrependOctetString(const void* content, SIZE_TYPE length) { PrependPrimitive(ASN1CodecOptions::EASN1ClassTagType::UNIVERSAL, static_cast<uint64>(ASN1CodecOptions::EASN1ValueType::OctetString), content, length); }
+
+		/// Prepends an INTEGER with universal tag.
+		void PrependInteger(int64 value);
+
+		/// Prepends an ENUMERATED with universal tag.
+		void PrependEnumerated(int64 value);
+
+		/// Prepends a BOOLEAN with universal tag.
+		void PrependBoolean(bool value);
+
+		/// Prepends a NULL with universal tag.
+		void PrependNull();
+
+		/// Prepends a REAL with universal tag.
+		void PrependReal(double value);
+
+		/**
+		 * Prepends OBJECT IDENTIFIER content without a header.
+		 * Throws Codec::bad_sequence if the arcs are not a valid identifier.
+		 *
+		 * \param arcs arcs of the identifier
+		 *
+		 * \return number of content bytes
+		 */
+		SIZE_TYPE PrependObjectIdentifierContent(Span<const uint64> arcs);
+
+		/// Prepends an OBJECT IDENTIFIER with universal tag. Throws Codec::bad_sequence if the arcs are not a valid identifier.
+		void PrependObjectIdentifier(Span<const uint64> arcs);
+
+		/**
+		 * Prepends BIT STRING content of byte flags without a header, any non-zero byte is a set bit.
+		 *
+		 * \param flags one flag per byte
+		 *
+		 * \return number of content bytes
+		 */
+		SIZE_TYPE PrependBitStringContent(Span<const uint8> flags);
+
+		/// Prepends a BIT STRING of byte flags with universal tag.
+		void PrependBitString(Span<const uint8> flags);
+
+		/**
+		 * Prepends already encoded bytes as they are.
+		 *
+		 * \param data	bytes
+		 * \param size	number of bytes
+		 */
+		void PrependRaw(const void* data, SIZE_TYPE size);
+
+		/// Returns the first encoded byte.
+		FORCEINLINE const BYTE* GetData() const { return Current; }
+
+		/// Returns number of encoded bytes.
+		FORCEINLINE SIZE_TYPE GetSize() const { return End - Current; }
+
+		/// Returns number of bytes that can still be prepended.
+		FORCEINLINE SIZE_TYPE GetFreeSpace() const { return Current - Begin; }
+
+		/// Forgets everything written, the whole buffer becomes free again.
+		FORCEINLINE void Reset() { Current = End; }
+
+	private:
+
+		/// Moves the front by size bytes. Throws Codec::bad_sequence if the buffer is full.
+		BYTE* Reserve(SIZE_TYPE size);
+
+	private:
+
+		BYTE* Begin;
+		BYTE* Current;
+		BYTE* End;
+
+	};
+
+
+} }
+
+
+#endif
@@ -0,0 +1,249 @@
+#include "ASN1_StreamDecoder.h"
+#include <algorithm>
+
+
+
+namespace Real { namespace Codecs {
+
+	using namespace ASN1CodecOptions;
+
+	/// Forgets all the state, next Feed starts a new stream.
+	void ASN1StreamDecoder::Reset()
+	{
+		Status = EASN1DecodeStatus::OK;
+		State = EState::IDENTIFIER;
+		Header = ASN1DecodedToken{};
+		LengthBytesLeft = 0;
+		LengthBytesCount = 0;
+		ContentLeft = 0;
+		Offset = 0;
+		Depth = 0;
+	}
+
+	/**
+	 * Consumes the next chunk of the stream.
+	 *
+	 * \param chunk	bytes
+	 * \param size	number of bytes
+	 *
+	 * \return OK if the chunk has been consumed, error status otherwise (errors are sticky)
+	 */
+	EASN1DecodeStatus ASN1StreamDecoder::Feed(const void* chunk, uint64 size)
+	{
+		const BYTE* position = static_cast<const BYTE*>(chunk);
+		const BYTE* const end = position + size;
+
+		while (Status == EASN1DecodeStatus::OK && position != end)
+		{
+			// content goes to the listener as one fragment per chunk
+			if (State == EState::CONTENT)
+			{
+				const uint64 count = std::min<uint64>(ContentLeft, end - position);
+
+				Listener.OnContent(position, count, Depth);
+
+				position += count;
+				Offset += count;
+				ContentLeft -= count;
+
+				if (ContentLeft == 0)
+				{
+					Listener.OnTokenEnd(Depth);
+					State = EState::IDENTIFIER;
+					CloseFinishedFrames();
+				}
+
+				continue;
+			}
+
+			const uint8 octet = static_cast<uint8>(*position++);
+			++Offset;
+			++Header.HeaderLength;
+
+			switch (State)
+			{
+			case EState::IDENTIFIER:
+			{
+				Header.Class = static_cast<EASN1ClassTagType>(octet & 0b11000000);
+				Header.bIsConstructed = (octet & _CONSTRUCTED_PC_TAG_BITS_) != 0;
+				Header.TagNumber = octet & 0b00011111;
+				Header.HeaderLength = 1;
+
+				State = (Header.TagNumber == 0b00011111) ? EState::TAG_NUMBER : EState::LENGTH;
+
+				if (State == EState::TAG_NUMBER)
+					Header.TagNumber = 0;
+				break;
+			}
+
+			case EState::TAG_NUMBER:
+			{
+				// leading zero group is not allowed, 64 bits hold at most 9 full groups
+				if ((Header.HeaderLength == 2 && octet == 0b10000000) || (Header.TagNumber >> 57))
+				{
+					Fail(EASN1DecodeStatus::BAD_TAG_NUMBER);
+					break;
+				}
+
+				Header.TagNumber = (Header.TagNumber << 7) | (octet & 0b01111111);
+
+				if ((octet & 0b10000000) == 0)
+					State = EState::LENGTH;
+				break;
+			}
+
+			case EState::LENGTH:
+			{
+				Header.bIsIndefinite = false;
+				Header.ContentLength = 0;
+
+				if (octet < 0b10000000)
+				{
+					Header.ContentLength = octet;
+					OnHeaderComplete();
+				}
+				else if (octet == 0b10000000)
+				{
+					if (!Header.bIsConstructed)
+					{
+						Fail(EASN1DecodeStatus::INDEFINITE_PRIMITIVE);
+						break;
+					}
+
+					if (Rules == EASN1DecodeRules::DER)
+					{
+						Fail(EASN1DecodeStatus::INDEFINITE_LENGTH);
+						break;
+					}
+
+					Header.bIsIndefinite = true;
+					OnHeaderComplete();
+				}
+				else
+				{
+					LengthBytesLeft = octet & 0b01111111;
+					LengthBytesCount = LengthBytesLeft;
+
+					if (octet == 0xFF || LengthBytesLeft > sizeof(uint64))
+					{
+						Fail(EASN1DecodeStatus::BAD_LENGTH);
+						break;
+					}
+
+					State = EState::LENGTH_BYTES;
+				}
+				break;
+			}
+
+			case EState::LENGTH_BYTES:
+			{
+				Header.ContentLength = (Header.ContentLength << 8) | octet;
+
+				if (--LengthBytesLeft != 0)
+					break;
+
+				// DER encoder would have written exactly this many bytes
+				if (Rules == EASN1DecodeRules::DER && ASN1_Codec::GetLengthFieldSize(Header.ContentLength) != 1 + LengthBytesCount)
+				{
+					Fail(EASN1DecodeStatus::NON_MINIMAL_LENGTH);
+					break;
+				}
+
+				OnHeaderComplete();
+				break;
+			}
+
+			default:
+				break;
+			}
+		}
+
+		return Status;
+	}
+
+	/**
+	 * Signals the end of the stream.
+	 *
+	 * \return END if the stream stopped between top-level tokens, error status otherwise
+	 */
+	EASN1DecodeStatus ASN1StreamDecoder::Finish()
+	{
+		if (Status != EASN1DecodeStatus::OK)
+			return Status;
+
+		if (State == EState::CONTENT)
+			return Fail(EASN1DecodeStatus::CONTENT_OUT_OF_RANGE);
+
+		if (State != EState::IDENTIFIER)
+			return Fail(EASN1DecodeStatus::TRUNCATED_HEADER);
+
+		if (Depth > 0)
+			return Fail(Frames[Depth - 1].bIsIndefinite ? EASN1DecodeStatus::MISSING_END_OF_CONTENTS : EASN1DecodeStatus::CONTENT_OUT_OF_RANGE);
+
+		return Fail(EASN1DecodeStatus::END);
+	}
+
+	/// Called when identifier and length octets are complete.
+	bool ASN1StreamDecoder::OnHeaderComplete()
+	{
+		Header.Content = nullptr;
+		State = EState::IDENTIFIER;
+
+		// header and declared content have to fit in the enclosing definite token
+		if (Depth > 0 && !Frames[Depth - 1].bIsIndefinite && (Offset > Frames[Depth - 1].End || Header.ContentLength > Frames[Depth - 1].End - Offset))
+		{
+			Fail(EASN1DecodeStatus::CONTENT_OUT_OF_RANGE);
+			return false;
+		}
+
+		// end-of-contents octets: universal primitive tag 0 with zero length
+		if (Header.HeaderLength == 2 && Header.Class == EASN1ClassTagType::UNIVERSAL && !Header.bIsConstructed && Header.TagNumber == 0 && Header.ContentLength == 0)
+		{
+			if (Depth == 0 || !Frames[Depth - 1].bIsIndefinite)
+			{
+				Fail(EASN1DecodeStatus::UNEXPECTED_END_OF_CONTENTS);
+				return false;
+			}
+
+			Listener.OnTokenEnd(--Depth);
+			CloseFinishedFrames();
+			return true;
+		}
+
+		// checked before the listener hears of the token, so it never begins a token that is rejected
+		if (Header.bIsConstructed && Depth == MaxDepth)
+		{
+			Fail(EASN1DecodeStatus::TOO_DEEP);
+			return false;
+		}
+
+		Listener.OnTokenBegin(Header, Depth);
+
+		if (Header.bIsConstructed)
+		{
+			Frames[Depth++] = { Offset + Header.ContentLength, Header.bIsIndefinite };
+			CloseFinishedFrames();
+		}
+		else if (Header.ContentLength == 0)
+		{
+			Listener.OnTokenEnd(Depth);
+			CloseFinishedFrames();
+		}
+		else
+		{
+			ContentLeft = Header.ContentLength;
+			State = EState::CONTENT;
+		}
+
+		return true;
+	}
+
+	/// Closes all the definite frames that end at the current offset.
+	void ASN1StreamDecoder::CloseFinishedFrames()
+	{
+		while (Depth > 0 && !Frames[Depth - 1].bIsIndefinite && Frames[Depth - 1].End == Offset)
+			Listener.OnTokenEnd(--Depth);
+	}
+
+
+} }
@@ -0,0 +1,156 @@
+#ifndef __REAL_ASN1_STREAM_DECODER__
+#define __REAL_ASN1_STREAM_DECODER__
+
+#include "ASN1_Reader.h"
+
+
+namespace Real { namespace Codecs {
+
+
+	/**
+	 * Receives events from ASN1StreamDecoder.
+	 * Headers are reported with Content == nullptr, content arrives in fragments as soon as it is fed.
+	 */
+	class ASN1StreamListener
+	{
+	public:
+
+		virtual ~ASN1StreamListener() { }
+
+		/**
+		 * Called when identifier and length octets of a token have been read.
+		 *
+		 * \param header	token header (Content is always nullptr, ContentLength is 0 for indefinite tokens)
+		 * \param depth		number of enclosing constructed tokens
+		 */
+		virtual void OnTokenBegin(const ASN1DecodedToken& /*header*/, uint32 /*depth*/) { }
+
+		/**
+		 * Called with a part of primitive token content. Fragment is valid only during the call.
+		 *
+		 * \param fragment	content bytes
+		 * \param size		number of bytes
+		 * \param depth		number of enclosing constructed tokens
+		 */
+		virtual void OnContent(const BYTE* /*fragment*/, uint64 /*size*/, uint32 /*depth*/) { }
+
+		/**
+		 * Called when the whole token (including content of constructed tokens) has been read.
+		 *
+		 * \param depth number of enclosing constructed tokens
+		 */
+		virtual void OnTokenEnd(uint32 /*depth*/) { }
+	};
+
+
+	/**
+	 * Resumable push-parser for BER/DER input that arrives in arbitrary chunks (pipes, sockets).
+	 * Partial identifier and length octets are kept between Feed calls, content is never buffered,
+	 * so memory use does not depend on the size of tokens.
+	 *
+	 * \code
+	 * ASN1StreamDecoder decoder(listener);
+	 * while (read chunk) decoder.Feed(chunk, size);
+	 * if (decoder.Finish() != EASN1DecodeStatus::END) { ... truncated or malformed ... }
+	 * \endcode
+	 */
+	class ASN1StreamDecoder
+	{
+	public:
+
+		/// Maximum nesting of constructed tokens
+		static constexpr uint32 MaxDepth = ASN1Reader::MaxDepth;
+
+	public:
+
+		/**
+		 * \param listener	receives decoding events
+		 * \param rules		rules headers are checked against
+		 */
+		explicit ASN1StreamDecoder(ASN1StreamListener& listener, EASN1DecodeRules rules = EASN1DecodeRules::BER) : Listener(listener), Rules(rules) { Reset(); }
+
+		/// Forgets all the state, next Feed starts a new stream.
+		void Reset();
+
+		/**
+		 * Consumes the next chunk of the stream.
+		 *
+		 * \param chunk	bytes
+		 * \param size	number of bytes
+		 *
+		 * \return OK if the chunk has been consumed, error status otherwise (errors are sticky)
+		 */
+		EASN1DecodeStatus Feed(const void* chunk, uint64 size);
+
+		/**
+		 * Signals the end of the stream.
+		 *
+		 * \return END if the stream stopped between top-level tokens, error status otherwise
+		 */
+		EASN1DecodeStatus Finish();
+
+		/// Returns number of bytes consumed so far.
+		FORCEINLINE uint64 GetOffset() const { return Offset; }
+
+		/// Returns current status.
+		FORCEINLINE EASN1DecodeStatus GetStatus() const { return Status; }
+
+	private:
+
+		enum class EState : uint8
+		{
+			IDENTIFIER,		///< waiting for the first identifier octet
+			TAG_NUMBER,		///< inside high tag number groups
+			LENGTH,			///< waiting for the first length octet
+			LENGTH_BYTES,	///< inside long form length bytes
+			CONTENT,		///< inside primitive content
+		};
+
+		/// Open constructed token
+		struct Frame
+		{
+			uint64	End;			///< stream offset after the content (definite tokens only)
+			bool	bIsIndefinite;
+		};
+
+		/// Called when identifier and length octets are complete.
+		bool OnHeaderComplete();
+
+		/// Closes all the definite frames that end at the current offset.
+		void CloseFinishedFrames();
+
+		FORCEINLINE EASN1DecodeStatus Fail(EASN1DecodeStatus status) { return Status = status; }
+
+	private:
+
+		ASN1StreamListener& Listener;
+
+		EASN1DecodeRules Rules;
+
+		EASN1DecodeStatus Status;
+
+		EState State;
+
+		/// Header being read
+		ASN1DecodedToken Header;
+
+		uint8 LengthBytesLeft;
+
+		/// Number of long form length bytes of the header being read
+		uint8 LengthBytesCount;
+
+		uint64 ContentLeft;
+
+		uint64 Offset;
+
+		Frame Frames[MaxDepth];
+
+		uint32 Depth;
+
+	};
+
+
+} }
+
+
+#endif
@@ -0,0 +1,366 @@
+#ifndef __REAL_CODEC_PIPELINE__
+#define __REAL_CODEC_PIPELINE__
+
+#include "../Core.h"
+#include "../Misc/Span.hpp"
+#include "ICodec.h"
+#include <array>
+#include <cstring>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+namespace Real { namespace Codecs {
+
+
+	/**
+	 * Base of pipeline stages (CRTP): gives the defaults and a one-shot Run, the pipeline calls the stage itself
+	 * without any virtual call. A stage keeps its state between calls, so input may be split anywhere.
+	 *
+	 * A converting stage provides
+	 *		bool Process(BYTE* destination, const BYTE* source, SIZE_T count, SIZE_T& written)
+	 *		bool Finish(BYTE* destination, SIZE_T& written)
+	 *		SIZE_T GetMaxOutputSize(SIZE_T count) const
+	 * where GetMaxOutputSize(count) bounds what one Process call of count bytes followed by Finish writes
+	 * whatever the state is. Both return false if the input is malformed.
+	 *
+	 * A pass-through stage (checksums, counters) sets bIsPassThrough and provides
+	 *		void Observe(const BYTE* bytes, SIZE_T count)
+	 * it only looks at the bytes, they go to the next stage without a copy.
+	 *
+	 * A stage that has to know the whole input in advance (the length of a token) provides
+	 *		void Begin(SIZE_T length)
+	 * CodecPipeline::Reset(length) calls it on the first stage with the number of bytes the run passes.
+	 */
+	template<typename _Derived>
+	class CodecStage
+	{
+	public:
+
+		static constexpr bool bIsPassThrough = false;
+
+		FORCEINLINE void Begin(SIZE_T /*length*/) { }
+
+		FORCEINLINE SIZE_T GetMaxOutputSize(SIZE_T count) const { return count; }
+
+		FORCEINLINE bool Finish(BYTE* /*destination*/, SIZE_T& written)
+		{
+			written = 0;
+			return true;
+		}
+
+		/**
+		 * Converts the whole input with this stage alone.
+		 *
+		 * \param input			bytes to convert
+		 * \param destination	buffer of at least GetMaxOutputSize(input.Size()) bytes
+		 * \param[out] written	number of written bytes
+		 *
+		 * \return false if the input is malformed
+		 */
+		bool Run(Span<const BYTE> input, BYTE* destination, SIZE_T& written)
+		{
+			_Derived& self = static_cast<_Derived&>(*this);
+			SIZE_T tail = 0;
+
+			if (!self.Process(destination, input.Data(), input.Size(), written) || !self.Finish(destination + written, tail))
+				return false;
+
+			written += tail;
+			return true;
+		}
+
+	};
+
+
+	/// Bytes every stage of a pipeline converts at once: small enough for the data of all the stages to stay in L2 cache.
+	constexpr SIZE_T PipelineBlockSize = 16 * 1024;
+
+
+	/**
+	 * Chain of stages resolved at compile time, e.g. CodecPipeline<ASN1OctetStringStage, Base64EncodeStage, Crc32Stage>.
+	 * Input is split into blocks of PipelineBlockSize and every block goes through all the stages before the next one
+	 * is taken, so stages are fused into one pass over the data: the output of a stage is read by the next one
+	 * while it is still in cache, and all the calls are inlined into one loop without virtual calls.
+	 * Every converting stage writes into its own buffer, they are taken once in one allocation.
+	 */
+	template<typename... _Stages>
+	class CodecPipeline
+	{
+	public:
+
+		static constexpr SIZE_T StageCount = sizeof...(_Stages);
+
+		explicit CodecPipeline(_Stages... stages)
+			: Stages(std::move(stages)...), InitialStages(Stages)
+		{
+			std::array<SIZE_T, StageCount + 1> offsets{};
+			GetBufferOffsets<0>(PipelineBlockSize, offsets);
+
+			Storage.reset(new BYTE[offsets[StageCount] ? offsets[StageCount] : 1]);
+
+			for (SIZE_T i = 0; i < StageCount; ++i)
+				Buffers[i] = Storage.get() + offsets[i];
+		}
+
+		/// Returns stage of given index, e.g. to read a checksum.
+		template<SIZE_T _Index>
+		FORCEINLINE auto& GetStage() { return std::get<_Index>(Stages); }
+
+		template<SIZE_T _Index>
+		FORCEINLINE const auto& GetStage() const { return std::get<_Index>(Stages); }
+
+		/// Returns maximum number of bytes the pipeline writes for count bytes of input in total.
+		FORCEINLINE SIZE_T GetMaxOutputSize(SIZE_T count) const { return ComposeMaxOutputSize<0>(count); }
+
+		/**
+		 * Converts bytes a block at a time, output of the last stage goes to the sink right away.
+		 *
+		 * \param input	bytes to convert
+		 * \param sink	callable as bool(const BYTE* bytes, SIZE_T count), false stops the pipeline
+		 *
+		 * \return false if a stage failed on malformed input or the sink failed
+		 */
+		template<typename _Sink>
+		bool Write(Span<const BYTE> input, _Sink&& sink)
+		{
+			const BYTE* current = input.Data();
+			SIZE_T remaining = input.Size();
+
+			while (remaining > 0)
+			{
+				const SIZE_T block = (remaining < PipelineBlockSize) ? remaining : PipelineBlockSize;
+
+				if (!Push<0>(current, block, sink))
+					return false;
+
+				current += block;
+				remaining -= block;
+			}
+
+			return true;
+		}
+
+		/**
+		 * Finishes stages in order, the tail of every stage goes through the stages after it.
+		 *
+		 * \param sink callable as bool(const BYTE* bytes, SIZE_T count)
+		 *
+		 * \return false if a stage failed or the sink failed
+		 */
+		template<typename _Sink>
+		bool Finish(_Sink&& sink)
+		{
+			return FinishFrom<0>(sink);
+		}
+
+		/// Brings all the stages back to the state they were constructed with.
+		void Reset() { Stages = InitialStages; }
+
+		/// Brings all the stages back to the state they were constructed with and tells the first one that length bytes follow.
+		void Reset(SIZE_T length)
+		{
+			Reset();
+
+			if constexpr (StageCount > 0)
+				std::get<0>(Stages).Begin(length);
+		}
+
+		/**
+		 * Converts the whole input into memory starting from the stages as they were constructed,
+		 * the first stage is told the input size (so a wrapping stage takes any length).
+		 * Stages keep their state afterwards, so a checksum of the run can be read.
+		 *
+		 * \param input			bytes to convert
+		 * \param destination	buffer of at least GetMaxOutputSize(input.Size()) bytes
+		 * \param[out] written	number of written bytes
+		 *
+		 * \return false if the input is malformed
+		 */
+		bool Run(Span<const BYTE> input, BYTE* destination, SIZE_T& written)
+		{
+			BYTE* current = destination;
+
+			Reset(input.Size());
+
+			auto sink = [&current](const BYTE* bytes, SIZE_T count)
+			{
+				std::memcpy(current, bytes, count);
+				current += count;
+				return true;
+			};
+
+			const bool bSucceeded = Write(input, sink) && Finish(sink);
+
+			written = current - destination;
+			return bSucceeded;
+		}
+
+	private:
+
+		template<SIZE_T _Index>
+		using Stage = std::tuple_element_t<_Index, std::tuple<_Stages...>>;
+
+		/// Lays out the buffers of converting stages, offsets[StageCount] becomes the size of all of them.
+		template<SIZE_T _Index>
+		void GetBufferOffsets(SIZE_T input_size, std::array<SIZE_T, StageCount + 1>& offsets) const
+		{
+			if constexpr (_Index < StageCount)
+			{
+				SIZE_T output_size = input_size;
+
+				if constexpr (!Stage<_Index>::bIsPassThrough)
+					output_size = std::get<_Index>(Stages).GetMaxOutputSize(input_size);
+
+				offsets[_Index + 1] = offsets[_Index] + (Stage<_Index>::bIsPassThrough ? 0 : output_size);
+				GetBufferOffsets<_Index + 1>(output_size, offsets);
+			}
+		}
+
+		template<SIZE_T _Index>
+		FORCEINLINE SIZE_T ComposeMaxOutputSize(SIZE_T count) const
+		{
+			if constexpr (_Index == StageCount)
+				return count;
+			else
+				return ComposeMaxOutputSize<_Index + 1>(std::get<_Index>(Stages).GetMaxOutputSize(count));
+		}
+
+		/// Passes bytes through stage _Index and all the stages after it.
+		template<SIZE_T _Index, typename _Sink>
+		FORCEINLINE bool Push(const BYTE* bytes, SIZE_T count, _Sink& sink)
+		{
+			if constexpr (_Index == StageCount)
+			{
+				return count == 0 || sink(bytes, count);
+			}
+			else if constexpr (Stage<_Index>::bIsPassThrough)
+			{
+				std::get<_Index>(Stages).Observe(bytes, count);
+				return Push<_Index + 1>(bytes, count, sink);
+			}
+			else
+			{
+				SIZE_T written;
+
+				if (!std::get<_Index>(Stages).Process(Buffers[_Index], bytes, count, written))
+					return false;
+
+				return Push<_Index + 1>(Buffers[_Index], written, sink);
+			}
+		}
+
+		template<SIZE_T _Index, typename _Sink>
+		bool FinishFrom(_Sink& sink)
+		{
+			if constexpr (_Index == StageCount)
+			{
+				return true;
+			}
+			else
+			{
+				if constexpr (!Stage<_Index>::bIsPassThrough)
+				{
+					SIZE_T written;
+
+					if (!std::get<_Index>(Stages).Finish(Buffers[_Index], written) || !Push<_Index + 1>(Buffers[_Index], written, sink))
+						return false;
+				}
+
+				return FinishFrom<_Index + 1>(sink);
+			}
+		}
+
+	private:
+
+		std::tuple<_Stages...> Stages;
+
+		/// Copies of the stages as they were constructed, Reset goes back to them
+		std::tuple<_Stages...> InitialStages;
+
+		std::unique_ptr<BYTE[]> Storage;
+
+		/// Output buffer of every converting stage, nullptr for pass-through ones
+		std::array<BYTE*, StageCount> Buffers{};
+
+	};
+
+
+	/**
+	 * Codec interface over pipelines: Encode runs the whole encoding pipeline over the sequence with a single virtual call,
+	 * Decode runs the decoding one. Both throw bad_sequence if the sequence is malformed.
+	 * Output is usually longer than the input: size destinations with GetMaxEncodedSize/GetMaxDecodedSize
+	 * and read the written count with GetLastSize, all of them are virtual in Codec.
+	 */
+	template<typename _EncodePipeline, typename _DecodePipeline>
+	class PipelineCodec : public Codec
+	{
+	public:
+
+		PipelineCodec(_EncodePipeline&& encode_pipeline, _DecodePipeline&& decode_pipeline, const TCHAR* name)
+			: EncodePipeline(std::move(encode_pipeline)), DecodePipeline(std::move(decode_pipeline)), Name(name)
+		{ }
+
+		/**
+		 * Encodes length bytes of sequence and writes them to the destination.
+		 *
+		 * \param[in]  sequence		source to get bytes from
+		 * \param[out] destination	buffer of at least GetMaxEncodedSize(length) bytes
+		 * \param[in]  length		number of bytes to encode
+		 */
+		void Encode(void* sequence, void* destination, int32 length) override
+		{
+			LastSize = RunPipeline(EncodePipeline, sequence, destination, length);
+		}
+
+		/**
+		 * Decodes sequence of bytes.
+		 *
+		 * \param[in]  from		source to get bytes from
+		 * \param[out] to		buffer of at least GetMaxDecodedSize(length) bytes
+		 * \param[in]  length	number of bytes to decode
+		 */
+		void Decode(void* from, void* to, int32 length) override
+		{
+			LastSize = RunPipeline(DecodePipeline, from, to, length);
+		}
+
+		FORCEINLINE const TCHAR* GetCodecName() const override { return Name; }
+
+		FORCEINLINE SIZE_T GetMaxEncodedSize(SIZE_T length) const override { return EncodePipeline.GetMaxOutputSize(length); }
+
+		FORCEINLINE SIZE_T GetMaxDecodedSize(SIZE_T length) const override { return DecodePipeline.GetMaxOutputSize(length); }
+
+		FORCEINLINE _EncodePipeline& GetEncodePipeline() { return EncodePipeline; }
+
+		FORCEINLINE _DecodePipeline& GetDecodePipeline() { return DecodePipeline; }
+
+	private:
+
+		template<typename _Pipeline>
+		static SIZE_T RunPipeline(_Pipeline& pipeline, const void* source, void* destination, int32 length)
+		{
+			SIZE_T written = 0;
+
+			if (length < 0 || !pipeline.Run(Span<const BYTE>(static_cast<const BYTE*>(source), length), static_cast<BYTE*>(destination), written))
+				throw bad_sequence{};
+
+			return written;
+		}
+
+	private:
+
+		_EncodePipeline EncodePipeline;
+
+		_DecodePipeline DecodePipeline;
+
+		const TCHAR* Name;
+
+	};
+
+} }
+
+
+#endif
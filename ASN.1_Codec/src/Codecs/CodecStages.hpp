@@ -0,0 +1,219 @@
+#ifndef __REAL_CODEC_STAGES__
+#define __REAL_CODEC_STAGES__
+
+#include "CodecPipeline.hpp"
+#include "ASN1_Codec.h"
+#include "../Misc/Base64.hpp"
+#include "../Misc/Crc32.hpp"
+#include "../Misc/Hex.hpp"
+#include <cstring>
+
+
+namespace Real { namespace Codecs {
+
+
+	/**
+	 * Wraps the bytes into a primitive octet string of definite length (DER): the header is written
+	 * in front of the first bytes, then the content is passed on. The length has to be known in advance.
+	 */
+	class ASN1OctetStringStage : public CodecStage<ASN1OctetStringStage>
+	{
+	public:
+
+		/**
+		 * \param length		number of bytes the stage will get in total, CodecPipeline::Run replaces it with the length of every run
+		 * \param class_type	class type of the token
+		 */
+		explicit ASN1OctetStringStage(SIZE_T length = 0, ASN1CodecOptions::EASN1ClassTagType class_type = ASN1CodecOptions::EASN1ClassTagType::UNIVERSAL)
+			: Length(length), Remaining(length), ClassType(class_type), bHasHeader(false)
+		{ }
+
+		/// Takes the length of the next token, the header is written for it.
+		FORCEINLINE void Begin(SIZE_T length)
+		{
+			Length = length;
+			Remaining = length;
+			bHasHeader = false;
+		}
+
+		FORCEINLINE SIZE_T GetMaxOutputSize(SIZE_T count) const { return ASN1_Codec::MaxHeaderSize + count; }
+
+		/// Fails if the stage gets more bytes than the length.
+		FORCEINLINE bool Process(BYTE* destination, const BYTE* source, SIZE_T count, SIZE_T& written)
+		{
+			written = 0;
+
+			if (count > Remaining)
+				return false;
+
+			if (!bHasHeader)
+				written = WriteHeader(destination);
+
+			std::memcpy(destination + written, source, count);
+
+			written += count;
+			Remaining -= count;
+
+			return true;
+		}
+
+		/// Writes the header of empty content, fails if the stage got less bytes than the length.
+		FORCEINLINE bool Finish(BYTE* destination, SIZE_T& written)
+		{
+			written = bHasHeader ? 0 : WriteHeader(destination);
+			return Remaining == 0;
+		}
+
+	private:
+
+		FORCEINLINE SIZE_T WriteHeader(BYTE* destination)
+		{
+			bHasHeader = true;
+			return ASN1_Codec::WriteHeader(destination, ASN1CodecOptions::EASN1ValueType::OctetString, ClassType, ASN1CodecOptions::EASN1PCType::PRIMITIVE, Length);
+		}
+
+	private:
+
+		SIZE_T Length;
+
+		/// Bytes of content not passed yet
+		SIZE_T Remaining;
+
+		ASN1CodecOptions::EASN1ClassTagType ClassType;
+
+		bool bHasHeader;
+
+	};
+
+
+	/// Bytes to Base64 text, optionally broken into lines (Base64::PemLineLength for PEM body).
+	class Base64EncodeStage : public CodecStage<Base64EncodeStage>
+	{
+	public:
+
+		explicit Base64EncodeStage(SIZE_T line_length = 0) : Encoder(line_length), LineLength(line_length) { }
+
+		/// Kept bytes of the previous call and the padded group of Finish included.
+		FORCEINLINE SIZE_T GetMaxOutputSize(SIZE_T count) const { return Base64::Encoder::GetMaxEncodedSize(count + 2, LineLength) + 5; }
+
+		FORCEINLINE bool Process(BYTE* destination, const BYTE* source, SIZE_T count, SIZE_T& written)
+		{
+			written = Encoder.Encode(destination, source, count);
+			return true;
+		}
+
+		FORCEINLINE bool Finish(BYTE* destination, SIZE_T& written)
+		{
+			written = Encoder.Finish(destination);
+			return true;
+		}
+
+	private:
+
+		Base64::Encoder Encoder;
+
+		SIZE_T LineLength;
+
+	};
+
+
+	/// Base64 text (whitespace, PEM armor lines and missing padding allowed) to bytes.
+	class Base64DecodeStage : public CodecStage<Base64DecodeStage>
+	{
+	public:
+
+		/// Pending sextets of the previous call may add up to 2 bytes to the ones of the characters.
+		FORCEINLINE SIZE_T GetMaxOutputSize(SIZE_T count) const { return count + 3; }
+
+		FORCEINLINE bool Process(BYTE* destination, const BYTE* source, SIZE_T count, SIZE_T& written)
+		{
+			return Decoder.Decode(destination, source, count, written);
+		}
+
+		FORCEINLINE bool Finish(BYTE* destination, SIZE_T& written)
+		{
+			return Decoder.Finish(destination, written);
+		}
+
+	private:
+
+		Base64::Decoder Decoder;
+
+	};
+
+
+	/// Bytes to space separated lowercase hex pairs.
+	class HexEncodeStage : public CodecStage<HexEncodeStage>
+	{
+	public:
+
+		FORCEINLINE SIZE_T GetMaxOutputSize(SIZE_T count) const { return Hex::SpacedCharsPerByte * count; }
+
+		FORCEINLINE bool Process(BYTE* destination, const BYTE* source, SIZE_T count, SIZE_T& written)
+		{
+			written = Hex::EncodeSpaced(destination, source, count);
+			return true;
+		}
+
+	};
+
+
+	/// Hex digits of any case with any whitespace to bytes.
+	class HexDecodeStage : public CodecStage<HexDecodeStage>
+	{
+	public:
+
+		FORCEINLINE SIZE_T GetMaxOutputSize(SIZE_T count) const { return count / 2 + 1; }
+
+		FORCEINLINE bool Process(BYTE* destination, const BYTE* source, SIZE_T count, SIZE_T& written)
+		{
+			return Decoder.Decode(destination, source, count, written);
+		}
+
+		/// Fails if the last digit has not got its pair.
+		FORCEINLINE bool Finish(BYTE* /*destination*/, SIZE_T& written)
+		{
+			written = 0;
+			return Decoder.IsComplete();
+		}
+
+	private:
+
+		Hex::Decoder Decoder;
+
+	};
+
+
+	/// CRC-32C of the bytes passing through the stage, they are not copied.
+	class Crc32Stage : public CodecStage<Crc32Stage>
+	{
+	public:
+
+		static constexpr bool bIsPassThrough = true;
+
+		Crc32Stage() : State(Crc32::InitialState), Size(0) { }
+
+		FORCEINLINE void Observe(const BYTE* bytes, SIZE_T count)
+		{
+			State = Crc32::Update(State, bytes, count);
+			Size += count;
+		}
+
+		/// Returns CRC-32C of all the bytes passed so far.
+		FORCEINLINE uint32 GetChecksum() const { return Crc32::GetChecksum(State); }
+
+		/// Returns number of bytes passed so far.
+		FORCEINLINE uint64 GetSize() const { return Size; }
+
+	private:
+
+		uint32 State;
+
+		uint64 Size;
+
+	};
+
+} }
+
+
+#endif
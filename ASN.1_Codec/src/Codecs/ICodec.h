@@ -2,6 +2,7 @@
 #define __REAL_ICODEC__
 
 #include <exception>
+#include <cstring>
 #include "../Core.h"
 
 
@@ -12,6 +13,8 @@ namespace Real { namespace Codecs {
 	/** /************************************************************************/
 	/*							Common Codec Interface                          */
 	/************************************************************************ / */
+
+	/// Whole buffer per virtual call. Chains of stages fused into one pass are built with CodecPipeline (CodecPipeline.hpp), PipelineCodec adapts them to this interface.
 	class Codec
 	{
 	public:
@@ -30,8 +33,10 @@ namespace Real { namespace Codecs {
 			*/
 		virtual void Encode(void* sequence, void* destination, int32 length)
 		{
-			for (int i = 0; i < length; ++i)
-				*((BYTE*)destination + i) = *((BYTE*)sequence + i);
+			if (length > 0)
+				std::memcpy(destination, sequence, length);
+
+			LastSize = (length > 0) ? length : 0;
 		};
 
 		/**
@@ -44,13 +49,24 @@ namespace Real { namespace Codecs {
 			*/
 		virtual void Decode(void* from, void* to, int32 length)
 		{
-			for (int i = 0; i < length; ++i)
-				*((BYTE*)to + i) = *((BYTE*)from + i);
+			if (length > 0)
+				std::memcpy(to, from, length);
+
+			LastSize = (length > 0) ? length : 0;
 		}
 
 		/// Returns this codec's name
 		virtual FORCEINLINE const TCHAR* GetCodecName() const { return "Base Codec"; }
 
+		/// Returns number of bytes Encode may write for length bytes of sequence, the destination must hold them.
+		virtual SIZE_T GetMaxEncodedSize(SIZE_T length) const { return length; }
+
+		/// Returns number of bytes Decode may write for length bytes of sequence, the destination must hold them.
+		virtual SIZE_T GetMaxDecodedSize(SIZE_T length) const { return length; }
+
+		/// Returns number of bytes written by the last Encode or Decode call.
+		virtual FORCEINLINE SIZE_T GetLastSize() const { return LastSize; }
+
 		// Exceptions 
 
 		/**
@@ -93,6 +109,10 @@ namespace Real { namespace Codecs {
 
 		};
 
+	protected:
+
+		/// Number of bytes written by the last Encode or Decode call
+		SIZE_T LastSize = 0;
 
 	};
 
@@ -1,16 +1,441 @@
 #include <iostream>
-#include <fstream>
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <cstdlib>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <unordered_set>
+#include <vector>
 
 #include "Misc/CommandLine.h"
 #include "Codecs/ASN1_Codec.h"
+#include "Platform/PlatformFile.h"
+#include "Platform/MappedFile.h"
+#include "Platform/WorkerPool.h"
+#include "Misc/TextStream.h"
 
 
 /// Returns text with instructions.
 extern const TCHAR* GetReference();
 
+/// Size of one segment in streaming mode if it is not given in the command line.
+constexpr uint64 DefaultStreamChunkSize = 64 * 1024;
+
+/// Scratch buffer of every batch worker, files that fit in it are encoded with one read and one write.
+constexpr SIZE_T BatchBufferSize = 1 << 20;
+
+
+/// Input and output of one file in batch mode and how its encoding went.
+struct BatchFile
+{
+	std::string InputFileName;
+
+	std::string OutputFileName;
+
+	/// Size of the input
+	uint64 Bytes = 0;
+
+	double Seconds = 0;
+
+	bool bSucceeded = false;
+};
+
+
+/**
+ * Encodes input file to output file moving the content of a regular file by the kernel.
+ * Pipes, devices and process substitution have no size, they are streamed through a buffer instead.
+ * Returns process exit code.
+ */
+static int32 EncodeFileInKernel(const std::string& InputFileName, const std::string& OutputFileName)
+{
+	using namespace Real;
+	using namespace Real::Codecs;
+
+	System::PlatformFile input;
+
+	if (!input.OpenRead(InputFileName.c_str()))
+	{
+		LOG("Cannot open " << InputFileName << " file. Something went wrong.\n");
+		LOG("Reference: \n" << GetReference());
+		return 1;
+	}
+
+	System::PlatformFile output;
+
+	if (!output.OpenWrite(OutputFileName.c_str()))
+	{
+		LOG("Cannot open " << OutputFileName << " file. Something went wrong.\n");
+		LOG("Reference: \n" << GetReference());
+		return 1;
+	}
+
+	const ASN1_Codec::SINK_TYPE sink = [&output](const BYTE* bytes, ASN1_Codec::SIZE_TYPE count) { return output.WriteAll(bytes, count); };
+
+	// only the header of a regular file passes through user space, its content is copied file to file
+	const bool bSucceeded = (input.Size() >= 0) ? ASN1_Codec::EncodeFile(input, output) : ASN1_Codec::EncodeStreamDefinite(input, sink);
+
+	if (!bSucceeded)
+	{
+		LOG("Cannot encode " << InputFileName << " file to " << OutputFileName << ". Something went wrong.\n");
+		return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * Encodes one large input file on a pool of workers, each reading its slice and writing it at its final offset.
+ * segment_size 0 gives a primitive octet string, otherwise a constructed one of segments of that size.
+ * Returns process exit code.
+ */
+static int32 EncodeFileParallel(const std::string& InputFileName, const std::string& OutputFileName, uint32 worker_count, uint64 segment_size)
+{
+	using namespace Real;
+	using namespace Real::Codecs;
+
+	System::PlatformFile input;
+
+	if (!input.OpenRead(InputFileName.c_str()))
+	{
+		LOG("Cannot open " << InputFileName << " file. Something went wrong.\n");
+		LOG("Reference: \n" << GetReference());
+		return 1;
+	}
+
+	// slices are read at their offsets, so the size has to be known up front
+	if (input.Size() < 0)
+	{
+		LOG("--parallel needs a regular file, " << InputFileName << " is not one.\n");
+		LOG("Reference: \n" << GetReference());
+		return 1;
+	}
+
+	System::PlatformFile output;
+
+	if (!output.OpenWrite(OutputFileName.c_str()))
+	{
+		LOG("Cannot open " << OutputFileName << " file. Something went wrong.\n");
+		LOG("Reference: \n" << GetReference());
+		return 1;
+	}
+
+	System::WorkerPool pool(worker_count);
+
+	if (!ASN1_Codec::EncodeFileParallel(input, output, pool, segment_size))
+	{
+		LOG("Cannot encode " << InputFileName << " file to " << OutputFileName << ". Something went wrong.\n");
+		return 1;
+	}
+
+	return 0;
+}
+
+/// Encodes memory mapped input file to output file, options are hints for the mapping. Returns process exit code.
+static int32 EncodeMappedFile(const std::string& InputFileName, const std::string& OutputFileName, Real::System::EMapOptions options)
+{
+	using namespace Real;
+	using namespace Real::Codecs;
+	using namespace Real::Codecs::ASN1CodecOptions;
+
+	System::MemoryMappedFile input;
+
+	if (!input.Open(InputFileName.c_str(), options))
+	{
+		LOG("Cannot open " << InputFileName << " file. Something went wrong.\n");
+		LOG("Reference: \n" << GetReference());
+		return 1;
+	}
+
+	System::PlatformFile output;
+
+	if (!output.OpenWrite(OutputFileName.c_str()))
+	{
+		LOG("Cannot open " << OutputFileName << " file. Something went wrong.\n");
+		LOG("Reference: \n" << GetReference());
+		return 1;
+	}
+
+	// the token views the page cache, no heap copy of the whole file, and its header lives on the stack
+	BYTE header_storage[ASN1_Codec::MaxHeaderSize];
+	System::MonotonicArena arena(header_storage);
+
+	auto token = ASN1_Codec::EncodeOctetStringView(EASN1ClassTagType::UNIVERSAL, input.GetData(), input.GetSize(), &arena);
+
+	// header and content go out with one writev
+	if (!token.WriteTo(output))
+	{
+		LOG("Cannot write to " << OutputFileName << " file. Something went wrong.\n");
+		return 1;
+	}
+
+	return 0;
+}
+
+
+/**
+ * Collects files of batch mode: pairs of input and output names, or two directories,
+ * then every regular file of the first one is encoded into the file of the same name in the second one.
+ *
+ * \param names		positional arguments
+ * \param[out] files	files to encode
+ *
+ * \return false if the arguments are neither
+ */
+static bool CollectBatchFiles(const std::vector<std::string>& names, std::vector<BatchFile>& files)
+{
+	namespace fs = std::filesystem;
+
+	std::error_code error;
+
+	if (names.size() == 2 && fs::is_directory(names[0], error))
+	{
+		const fs::path output_directory(names[1]);
+
+		if (!fs::is_directory(output_directory, error) && !fs::create_directories(output_directory, error))
+			return false;
+
+		for (const fs::directory_entry& entry : fs::directory_iterator(names[0], error))
+		{
+			if (entry.is_regular_file(error))
+				files.push_back({ entry.path().string(), (output_directory / entry.path().filename()).string() });
+		}
+
+		return !error;
+	}
+
+	if (names.empty() || names.size() % 2 != 0)
+		return false;
+
+	for (SIZE_T i = 0; i < names.size(); i += 2)
+		files.push_back({ names[i], names[i + 1] });
+
+	return true;
+}
+
+/**
+ * Checks no file of the batch is written while it is read: an output that is an input is truncated before it is encoded,
+ * and workers writing the same output race. Every conflict is reported as a failure.
+ *
+ * \param names	positional arguments
+ * \param files	files to encode
+ *
+ * \return false if the directories are the same one, or an output is an input or repeats another output
+ */
+static bool CheckBatchOutputs(const std::vector<std::string>& names, const std::vector<BatchFile>& files)
+{
+	namespace fs = std::filesystem;
+
+	std::error_code error;
+
+	if (names.size() == 2 && fs::is_directory(names[0], error) && fs::equivalent(names[0], names[1], error))
+	{
+		LOG(names[0] << " -> " << names[1] << ": failed, the input and the output directory are the same");
+		return false;
+	}
+
+	// outputs that do not exist yet have no file to compare, so names are compared in the canonical form as well
+	const auto canonical = [](const std::string& name)
+	{
+		std::error_code canonical_error;
+		const fs::path path = fs::weakly_canonical(name, canonical_error);
+
+		return canonical_error ? fs::absolute(name, canonical_error).lexically_normal().string() : path.string();
+	};
+
+	std::unordered_set<std::string> inputs;
+	std::unordered_set<std::string> outputs;
+
+	for (const BatchFile& file : files)
+		inputs.insert(canonical(file.InputFileName));
+
+	uint64 conflicting_files = 0;
+
+	for (const BatchFile& file : files)
+	{
+		const std::string output = canonical(file.OutputFileName);
+		const TCHAR* conflict = nullptr;
+
+		if (inputs.count(output) != 0 || fs::equivalent(file.InputFileName, file.OutputFileName, error))
+			conflict = "the output is an input";
+		else if (!outputs.insert(output).second)
+			conflict = "the output repeats another output";
+
+		if (conflict)
+		{
+			LOG(file.InputFileName << " -> " << file.OutputFileName << ": failed, " << conflict);
+			++conflicting_files;
+		}
+	}
+
+	if (conflicting_files)
+		LOG("Total: 0 of " << files.size() << " files, " << conflicting_files << " conflicting outputs, nothing is encoded");
+
+	return conflicting_files == 0;
+}
+
+/**
+ * Encodes every file on a pool of workers, each with its own buffer, and prints throughput of every file and of the batch.
+ * Returns process exit code.
+ */
+static int32 EncodeBatch(std::vector<BatchFile>& files, uint32 worker_count)
+{
+	using namespace Real;
+	using namespace Real::Codecs;
+
+	typedef std::chrono::steady_clock Clock;
+
+	System::WorkerPool pool(worker_count);
+	std::vector<std::unique_ptr<BYTE[]>> buffers(pool.GetWorkerCount());
+
+	for (auto& buffer : buffers)
+		buffer.reset(new BYTE[BatchBufferSize]);
+
+	const Clock::time_point batch_start = Clock::now();
+
+	pool.Run(files.size(), [&files, &buffers](uint32 worker_index, uint64 job_index)
+	{
+		BatchFile& file = files[job_index];
+		const Clock::time_point start = Clock::now();
+
+		System::PlatformFile input;
+		System::PlatformFile output;
+
+		if (input.OpenRead(file.InputFileName.c_str()) && output.OpenWrite(file.OutputFileName.c_str()))
+		{
+			file.Bytes = std::max<int64>(input.Size(), 0);
+			file.bSucceeded = ASN1_Codec::EncodeFile(input, output, Span<BYTE>(buffers[worker_index].get(), BatchBufferSize));
+		}
+
+		file.Seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	});
+
+	const double batch_seconds = std::chrono::duration<double>(Clock::now() - batch_start).count();
+
+	uint64 total_bytes = 0;
+	uint64 failed_files = 0;
+
+	std::ostringstream report;
+	report << std::fixed << std::setprecision(1);
+
+	for (const BatchFile& file : files)
+	{
+		report << file.InputFileName << " -> " << file.OutputFileName << ": ";
+
+		if (file.bSucceeded)
+			report << file.Bytes << " bytes, " << file.Seconds * 1e3 << " ms, " << (file.Seconds > 0 ? file.Bytes / file.Seconds / 1e6 : 0.0) << " MB/s\n";
+		else
+			report << "failed\n";
+
+		total_bytes += file.Bytes;
+		failed_files += !file.bSucceeded;
+	}
+
+	report << "Total: " << files.size() - failed_files << " of " << files.size() << " files, " << total_bytes << " bytes in " << batch_seconds << " s on "
+		<< pool.GetWorkerCount() << " workers, " << (batch_seconds > 0 ? total_bytes / batch_seconds / 1e6 : 0.0) << " MB/s, "
+		<< (batch_seconds > 0 ? files.size() / batch_seconds : 0.0) << " files/s";
+
+	LOG(report.str());
+
+	return failed_files ? 1 : 0;
+}
+
+
+/**
+ * Encodes the whole input as one octet string of definite length: the input is decoded from input_format,
+ * the encoded token is written in output_format. Raw input of a regular file is not buffered.
+ * Returns false if reading, decoding or writing failed.
+ */
+static bool EncodeDefinite(Real::System::PlatformFile& input, Real::System::PlatformFile& output, Real::ETextFormat input_format, Real::ETextFormat output_format)
+{
+	using namespace Real;
+	using namespace Real::Codecs;
+
+	TextWriter writer(output, output_format);
+	const ASN1_Codec::SINK_TYPE sink = [&writer](const BYTE* bytes, ASN1_Codec::SIZE_TYPE count) { return writer.Write(bytes, count); };
+
+	if (input_format == ETextFormat::RAW)
+		return ASN1_Codec::EncodeStreamDefinite(input, sink) && writer.Finish();
+
+	TextReader reader(input, input_format);
+	return ASN1_Codec::EncodeStreamDefinite([&reader](BYTE* destination, ASN1_Codec::SIZE_TYPE count) { return reader.Read(destination, count); }, sink) && writer.Finish();
+}
+
+/// Encodes input file to output file converting input and output formats. Returns process exit code.
+static int32 EncodeFileText(const std::string& InputFileName, const std::string& OutputFileName, Real::ETextFormat input_format, Real::ETextFormat output_format)
+{
+	using namespace Real;
+
+	System::PlatformFile input;
+
+	if (!input.OpenRead(InputFileName.c_str()))
+	{
+		LOG("Cannot open " << InputFileName << " file. Something went wrong.\n");
+		LOG("Reference: \n" << GetReference());
+		return 1;
+	}
+
+	System::PlatformFile output;
+
+	if (!output.OpenWrite(OutputFileName.c_str()))
+	{
+		LOG("Cannot open " << OutputFileName << " file. Something went wrong.\n");
+		LOG("Reference: \n" << GetReference());
+		return 1;
+	}
+
+	if (!EncodeDefinite(input, output, input_format, output_format))
+	{
+		LOG("Cannot encode " << InputFileName << " file to " << OutputFileName << ". Something went wrong.\n");
+		return 1;
+	}
+
+	return 0;
+}
+
+/// Encodes the whole standard input as one octet string and prints it in output format (hex by default). Returns process exit code.
+static int32 EncodeStdin(Real::ETextFormat input_format, Real::ETextFormat output_format)
+{
+	using namespace Real;
+
+	System::PlatformFile input = System::PlatformFile::StdIn();
+	System::PlatformFile output = System::PlatformFile::StdOut();
+
+	if (!EncodeDefinite(input, output, input_format, output_format))
+	{
+		LOG("\nCannot encode standard input. Something went wrong.\n");
+		return 1;
+	}
+
+	return 0;
+}
+
+/// Encodes standard input of unknown size as indefinite length octet string. Returns process exit code.
+static int32 EncodeStdinStream(uint64 chunk_size, Real::ETextFormat input_format, Real::ETextFormat output_format)
+{
+	using namespace Real;
+	using namespace Real::Codecs;
+
+	System::PlatformFile input = System::PlatformFile::StdIn();
+	System::PlatformFile output = System::PlatformFile::StdOut();
+	TextReader reader(input, input_format);
+	TextWriter writer(output, output_format);
+
+	// every segment reaches the reader as soon as it is read
+	const bool bSucceeded = ASN1_Codec::EncodeStream(
+		[&reader](BYTE* destination, ASN1_Codec::SIZE_TYPE count) { return reader.Read(destination, count); }, chunk_size,
+		[&writer](const BYTE* bytes, ASN1_Codec::SIZE_TYPE count) { return writer.Write(bytes, count); });
+
+	if (!bSucceeded || !writer.Finish())
+	{
+		LOG("\nCannot encode standard input. Something went wrong.\n");
+		return 1;
+	}
+
+	return 0;
+}
+
 
 int main(int32 argc, TCHAR** argv)
 {
@@ -22,68 +447,158 @@ int main(int32 argc, TCHAR** argv)
 
 	ParsedArguments parsed = CommandLine::Parse(CommandLine::GetOriginal(), Real::EOptionType::ALL);
 
-	if (parsed.Count() == 2)
+	const auto& files = parsed.GetPositional();
+
+	// "--input=mmap" maps the input file and encodes the token from the mapped view, "--input=mmap-populate" prefaults it as well
+	const uint32 bHasInputOption = parsed.Exists("--input");
+	const std::string input_mode = bHasInputOption ? parsed.Get("--input").Get() : "";
+	const bool bMapInput = input_mode == "mmap" || input_mode == "mmap-populate";
+	const System::EMapOptions map_options = (input_mode == "mmap-populate") ? System::EMapOptions::SEQUENTIAL | System::EMapOptions::POPULATE : System::EMapOptions::SEQUENTIAL;
+
+	// "--input-format=raw|hex|base64|pem" and "--output-format=der|hex|base64|pem" convert text on the way
+	const uint32 bHasInputFormat = parsed.Exists("--input-format");
+	const uint32 bHasOutputFormat = parsed.Exists("--output-format");
+	const uint32 format_option_count = bHasInputFormat + bHasOutputFormat;
+
+	ETextFormat input_format = ETextFormat::RAW;
+	ETextFormat output_format = ETextFormat::RAW;
+
+	if (bHasInputFormat && !ParseTextFormat(parsed.Get("--input-format").Get(), input_format))
+	{
+		LOG("Unknown input format " << parsed.Get("--input-format").Get() << ".\n");
+		LOG("Reference: \n" << GetReference());
+		return 1;
+	}
+
+	if (bHasOutputFormat && !ParseTextFormat(parsed.Get("--output-format").Get(), output_format))
 	{
-		const auto& [InputFileName, Value1] = *parsed.GetVariableMap().begin();
-		const auto& [OutputFileName, Value2] = *(++parsed.GetVariableMap().begin());
+		LOG("Unknown output format " << parsed.Get("--output-format").Get() << ".\n");
+		LOG("Reference: \n" << GetReference());
+		return 1;
+	}
 
-		std::ifstream ifs(InputFileName, std::ios::in | std::ios::binary);
-		
-		if (!ifs.good())
+	// standard output shows hex pairs unless another format is asked for
+	const ETextFormat stdout_format = bHasOutputFormat ? output_format : ETextFormat::HEX;
+
+	// "--batch[=workers]" encodes many files at once, see CollectBatchFiles
+	if (parsed.Exists("--batch"))
+	{
+		// positional names are keys of the map as well, anything else is an unknown option
+		const std::unordered_set<std::string> positional(files.begin(), files.end());
+
+		for (const auto& [Command, Value] : parsed.GetVariableMap())
 		{
-			LOG("Cannot open " << InputFileName << " file. Something went wrong.\n");
-			LOG("Reference: \n" << GetReference());
-			return 1;
+			if (Command != "--batch" && positional.count(Command) == 0)
+			{
+				LOG("You did not enter allowed options.\nSee reference:\n" << GetReference());
+				return 1;
+			}
 		}
 
-		std::ofstream ofs(OutputFileName, std::ios::out | std::ios::binary);
+		// "--batch name" is parsed as an option with a value, so a value that is not a number is the first name
+		const std::string value = parsed.Get("--batch").Get();
+		const bool bHasWorkerCount = !value.empty() && value.find_first_not_of("0123456789") == std::string::npos;
+
+		std::vector<std::string> names;
+
+		if (!value.empty() && !bHasWorkerCount)
+			names.push_back(value);
 
-		if (!ofs.good())
+		names.insert(names.end(), files.begin(), files.end());
+
+		std::vector<BatchFile> batch;
+
+		if (!CollectBatchFiles(names, batch))
 		{
-			LOG("Cannot open " << OutputFileName << " file. Something went wrong.\n");
+			LOG("Batch mode takes pairs of input and output files or an input and an output directory.\n");
 			LOG("Reference: \n" << GetReference());
 			return 1;
 		}
 
+		if (!CheckBatchOutputs(names, batch))
+			return 1;
+
+		return EncodeBatch(batch, bHasWorkerCount ? static_cast<uint32>(std::strtoul(value.c_str(), nullptr, 10)) : 0);
+	}
+
+	// "--parallel[=workers] [--segment=size] input output" encodes one large file on a pool of workers
+	else if (parsed.Exists("--parallel"))
+	{
+		const uint32 bHasSegmentOption = parsed.Exists("--segment");
+
+		// same as in batch mode, "--parallel input" is parsed as an option with a value
+		const std::string value = parsed.Get("--parallel").Get();
+		const bool bHasWorkerCount = !value.empty() && value.find_first_not_of("0123456789") == std::string::npos;
 
-		std::string sequence((std::istreambuf_iterator<TCHAR>(ifs)),
-								std::istreambuf_iterator<TCHAR>());
+		std::vector<std::string> names;
 
+		if (!value.empty() && !bHasWorkerCount)
+			names.push_back(value);
 
-		auto token = ASN1_Codec::EncodeToken(EASN1ValueType::OctetString, EASN1ClassTagType::UNIVERSAL, EASN1PCType::PRIMITIVE, sequence.c_str(), sequence.size());
+		names.insert(names.end(), files.begin(), files.end());
 
-		ofs << token;
+		const std::string segment_value = bHasSegmentOption ? parsed.Get("--segment").Get() : "";
+		const uint64 segment_size = std::strtoull(segment_value.c_str(), nullptr, 10);
 
-		ifs.close();
-		ofs.close();
+		if (names.size() != 2 || parsed.Count() != 1u + bHasSegmentOption + files.size() || (bHasSegmentOption && segment_size == 0))
+		{
+			LOG("You did not enter allowed options.\nSee reference:\n" << GetReference());
+			return 1;
+		}
 
+		return EncodeFileParallel(names[0], names[1], bHasWorkerCount ? static_cast<uint32>(std::strtoul(value.c_str(), nullptr, 10)) : 0, segment_size);
 	}
 
-	else if (parsed.Count() == 1)
+	else if (files.size() == 2 && parsed.Count() == 2u + bHasInputOption + format_option_count)
 	{
-		const auto& [Command, Value] = *parsed.GetVariableMap().begin();
+		if (bHasInputOption && !bMapInput)
+		{
+			LOG("Unknown input mode " << parsed.Get("--input").Get() << ".\n");
+			LOG("Reference: \n" << GetReference());
+			return 1;
+		}
+
+		const bool bConvertsText = input_format != ETextFormat::RAW || output_format != ETextFormat::RAW;
 
-		if (Command != "-")
+		if (bMapInput && bConvertsText)
 		{
-			LOG("This is not '-' sign.\n");
+			LOG("Memory mapped input is encoded from raw bytes to DER only.\n");
 			LOG("Reference: \n" << GetReference());
 			return 1;
 		}
 
-		std::string input_sequence; 
-		std::getline(std::cin, input_sequence);
-		
-		auto token = ASN1_Codec::EncodeToken(EASN1ValueType::OctetString, EASN1ClassTagType::UNIVERSAL, EASN1PCType::PRIMITIVE, input_sequence.c_str(), input_sequence.size());
+		if (bConvertsText)
+			return EncodeFileText(files[0], files[1], input_format, output_format);
+
+		return bMapInput ? EncodeMappedFile(files[0], files[1], map_options) : EncodeFileInKernel(files[0], files[1]);
+	}
 
-		std::stringstream output;
-		output << token;
+	// "--stream[=chunk_size] -" encodes standard input of unknown size chunk by chunk
+	else if (parsed.Exists("--stream") && parsed.Exists("-") && parsed.Count() == 2u + format_option_count)
+	{
+		const std::string value = parsed.Get("--stream").Get();
+		const uint64 chunk_size = value.empty() ? DefaultStreamChunkSize : std::strtoull(value.c_str(), nullptr, 10);
 
-		BYTE c;
-		while (output.get(c))
+		if (chunk_size == 0)
 		{
-			std::cout << std::setw(2) << std::setfill('0') << std::hex << (int)c << " ";
+			LOG("Wrong chunk size " << value << ".\n");
+			LOG("Reference: \n" << GetReference());
+			return 1;
+		}
+
+		return EncodeStdinStream(chunk_size, input_format, stdout_format);
+	}
+
+	else if (parsed.Count() == 1u + format_option_count)
+	{
+		if (!parsed.Exists("-"))
+		{
+			LOG("This is not '-' sign.\n");
+			LOG("Reference: \n" << GetReference());
+			return 1;
 		}
 
+		return EncodeStdin(input_format, stdout_format);
 	}
 
 	else
@@ -103,6 +618,24 @@ const TCHAR* GetReference()
 		"You can enter 2 file names or '-' sign.\n"
 		"Examples:\n"
 		"\"input.txt output.txt\" - original sequence of bytes will be taken from input.txt and encoded sequence will be written to output.txt\n"
-		"\"-\" - original sequence of bytes is taken from standard input and encoded sequence will be written to standard output."
+		"\"-\" - original sequence of bytes (any binary data up to the end of input) is taken from standard input and encoded sequence\n"
+		"    will be written to standard output as hex pairs.\n"
+		"Options:\n"
+		"\"--input=mmap input.txt output.txt\" - input file is memory mapped instead of being copied by the kernel.\n"
+		"\"--input=mmap-populate input.txt output.txt\" - the same, but the whole mapping is prefaulted at once (Linux).\n"
+		"\"--stream[=chunk_size] -\" - standard input of any size is encoded as constructed octet string with indefinite length,\n"
+		"    every chunk (64 KiB by default) becomes a primitive segment and is written as soon as it is full.\n"
+		"\"--batch[=workers] in1.txt out1.txt in2.txt out2.txt ...\" - every input file is encoded to the output file after it\n"
+		"    by a pool of workers (one per hardware thread by default), throughput of every file and of the batch is printed.\n"
+		"\"--batch[=workers] input_directory output_directory\" - every regular file of the input directory is encoded\n"
+		"    to the file of the same name in the output directory.\n"
+		"\"--parallel[=workers] input.txt output.txt\" - one large input file is split into slices encoded by a pool of workers,\n"
+		"    every slice is written at its final offset of the output file.\n"
+		"\"--parallel[=workers] --segment=size input.txt output.txt\" - the same, but the output is a constructed octet string\n"
+		"    of definite length made of primitive segments of given size.\n"
+		"\"--input-format=raw|hex|base64|pem\" - input (a file or '-') is text decoded before encoding: hex digits with any whitespace,\n"
+		"    Base64 with or without padding and line breaks, or PEM whose BEGIN and END lines are skipped.\n"
+		"\"--output-format=der|hex|base64|pem\" - encoded sequence is written as raw DER (files by default), hex pairs (standard output\n"
+		"    by default), one line of Base64 or PEM with lines of 64 characters. Both options also apply to \"--stream -\"."
 		;
 }
\ No newline at end of file
@@ -0,0 +1,357 @@
+#ifndef __REAL_BASE64__
+#define __REAL_BASE64__
+
+#include "../Core.h"
+#include "Simd.hpp"
+#include <algorithm>
+#include <array>
+
+
+/**
+ * Real::Base64 classes turn bytes into Base64 text (RFC 4648) and back a whole block at a time.
+ * Both keep the state between calls, so a stream can be converted in pieces of any size.
+ */
+namespace Real { namespace Base64 {
+
+	/// Line length of PEM text (RFC 7468).
+	constexpr SIZE_T PemLineLength = 64;
+
+	/// Marks of DigitValues entries that are not digits.
+	constexpr uint8 PaddingValue = 0x40;
+	constexpr uint8 WhitespaceValue = 0x41;
+	constexpr uint8 InvalidValue = 0xFF;
+
+	constexpr std::array<uint8, 256> BuildDigitValues()
+	{
+		std::array<uint8, 256> values{};
+
+		for (uint32 c = 0; c < 256; ++c)
+		{
+			const uint8 value = Simd::Base64Value(static_cast<uint8>(c));
+			values[c] = (value != 0xFF) ? value : (c == '=') ? PaddingValue : (c == ' ' || (c >= '\t' && c <= '\r')) ? WhitespaceValue : InvalidValue;
+		}
+
+		return values;
+	}
+
+	/// Value of every character: 6-bit value, PaddingValue, WhitespaceValue or InvalidValue.
+	constexpr std::array<uint8, 256> DigitValues = BuildDigitValues();
+
+
+	/**
+	 * Streaming Base64 encoder, optionally breaking lines after line_length characters.
+	 * Up to 2 bytes are kept between calls, Finish writes them with padding.
+	 */
+	class Encoder
+	{
+	public:
+
+		/**
+		 * \param line_length characters per line (a multiple of 4), 0 writes one line without a line feed
+		 */
+		explicit Encoder(SIZE_T line_length = 0) : LineLength(line_length), Column(0), CarrySize(0) { }
+
+		/// Returns maximum number of characters Encode and Finish write for count bytes in total.
+		FORCEINLINE static constexpr SIZE_T GetMaxEncodedSize(SIZE_T count, SIZE_T line_length) NOEXCEPT
+		{
+			const SIZE_T characters = (count + 2) / 3 * 4;
+			return characters + (line_length ? characters / line_length + 1 : 0);
+		}
+
+		/**
+		 * Encodes bytes. Whole groups of 3 bytes are written right away, 12 bytes at a time by Simd::Base64Encode12.
+		 *
+		 * \param destination	buffer of at least GetMaxEncodedSize(count + 2, line length) characters
+		 * \param bytes			bytes to encode
+		 * \param count			number of bytes
+		 *
+		 * \return number of written characters
+		 */
+		SIZE_T Encode(BYTE* destination, const BYTE* bytes, SIZE_T count) NOEXCEPT
+		{
+			BYTE* current = destination;
+
+			// group started by the previous call
+			if (CarrySize > 0)
+			{
+				while (CarrySize < 3 && count > 0)
+				{
+					Carry[CarrySize++] = *bytes++;
+					--count;
+				}
+
+				if (CarrySize < 3)
+					return 0;
+
+				current += EncodeGroups(current, Carry, 1);
+				CarrySize = 0;
+			}
+
+			const SIZE_T groups = count / 3;
+			current += EncodeGroups(current, bytes, groups);
+
+			for (SIZE_T i = groups * 3; i < count; ++i)
+				Carry[CarrySize++] = bytes[i];
+
+			return current - destination;
+		}
+
+		/**
+		 * Writes the kept bytes with padding and ends the last line.
+		 *
+		 * \param destination buffer of at least 5 characters
+		 *
+		 * \return number of written characters
+		 */
+		SIZE_T Finish(BYTE* destination) NOEXCEPT
+		{
+			BYTE* current = destination;
+
+			if (CarrySize > 0)
+			{
+				const uint32 group = (static_cast<uint8>(Carry[0]) << 16) | ((CarrySize > 1) ? static_cast<uint8>(Carry[1]) << 8 : 0);
+
+				current[0] = Simd::Base64Digit(group >> 18);
+				current[1] = Simd::Base64Digit((group >> 12) & 0x3F);
+				current[2] = (CarrySize > 1) ? Simd::Base64Digit((group >> 6) & 0x3F) : '=';
+				current[3] = '=';
+
+				current += 4;
+				Column += 4;
+				CarrySize = 0;
+			}
+
+			if (LineLength && Column > 0)
+				*current++ = '\n';
+
+			Column = 0;
+			return current - destination;
+		}
+
+	private:
+
+		/// Encodes whole groups of 3 bytes, breaking lines on the way. Returns number of written characters.
+		SIZE_T EncodeGroups(BYTE* destination, const BYTE* bytes, SIZE_T groups) NOEXCEPT
+		{
+			BYTE* current = destination;
+
+			while (groups > 0)
+			{
+				const SIZE_T line_groups = LineLength ? std::min(groups, (LineLength - Column) / 4) : groups;
+				SIZE_T i = 0;
+
+				for (; i + 4 <= line_groups; i += 4)
+					Simd::Base64Encode12(current + 4 * i, bytes + 3 * i);
+
+				for (; i < line_groups; ++i)
+				{
+					const uint32 group = (static_cast<uint8>(bytes[3 * i]) << 16) | (static_cast<uint8>(bytes[3 * i + 1]) << 8) | static_cast<uint8>(bytes[3 * i + 2]);
+
+					current[4 * i] = Simd::Base64Digit(group >> 18);
+					current[4 * i + 1] = Simd::Base64Digit((group >> 12) & 0x3F);
+					current[4 * i + 2] = Simd::Base64Digit((group >> 6) & 0x3F);
+					current[4 * i + 3] = Simd::Base64Digit(group & 0x3F);
+				}
+
+				current += 4 * line_groups;
+				bytes += 3 * line_groups;
+				groups -= line_groups;
+
+				if (LineLength && (Column += 4 * line_groups) == LineLength)
+				{
+					*current++ = '\n';
+					Column = 0;
+				}
+			}
+
+			return current - destination;
+		}
+
+	private:
+
+		SIZE_T LineLength;
+
+		/// Characters already written to the current line
+		SIZE_T Column;
+
+		BYTE Carry[3];
+
+		uint8 CarrySize;
+
+	};
+
+
+	/**
+	 * Streaming Base64 decoder. Whitespace is skipped, lines starting with '-' (PEM armor such as
+	 * "-----BEGIN ...-----") are skipped as a whole, padding is optional. Text may be split anywhere between calls.
+	 */
+	class Decoder
+	{
+	public:
+
+		Decoder() : Bits(0), Pending(0), Padding(0), bIsAtLineStart(true), bIsInArmor(false), bHasEnded(false) { }
+
+		/**
+		 * Decodes a piece of text. Runs of 16 alphabet characters go through Simd::Base64Decode16,
+		 * anything else is decoded one character at a time.
+		 *
+		 * \param destination	buffer of at least count bytes
+		 * \param text			text to decode
+		 * \param count			number of characters
+		 * \param[out] written	number of decoded bytes
+		 *
+		 * \return false if the text has a character outside the alphabet or misplaced padding
+		 */
+		bool Decode(BYTE* destination, const BYTE* text, SIZE_T count, SIZE_T& written) NOEXCEPT
+		{
+			const BYTE* const end = text + count;
+			BYTE* current = destination;
+
+			while (text < end)
+			{
+				if (Pending == 0 && Padding == 0 && !bIsInArmor && !bHasEnded)
+				{
+					const BYTE* const start = text;
+
+					while (end - text >= 16 && Simd::Base64Decode16(current, text))
+					{
+						text += 16;
+						current += 12;
+					}
+
+					if (text != start)
+						bIsAtLineStart = false;
+				}
+
+				// characters the kernel did not take are decoded here, it is tried again as soon as a group is complete
+				const BYTE* const block_end = text + std::min<SIZE_T>(end - text, 16);
+
+				while (text < block_end)
+				{
+					if (!DecodeCharacter(current, static_cast<uint8>(*text++)))
+					{
+						written = current - destination;
+						return false;
+					}
+
+					if (Pending == 0)
+						break;
+				}
+			}
+
+			written = current - destination;
+			return true;
+		}
+
+		/**
+		 * Writes the bytes of an unpadded last group.
+		 *
+		 * \param destination	buffer of at least 2 bytes
+		 * \param[out] written	number of decoded bytes
+		 *
+		 * \return false if the text ended in the middle of a group that cannot be completed
+		 */
+		bool Finish(BYTE* destination, SIZE_T& written) NOEXCEPT
+		{
+			written = 0;
+
+			if (Padding > 0 || Pending == 1)
+				return false;
+
+			if (Pending > 1)
+				written = WriteGroup(destination);
+
+			return true;
+		}
+
+	private:
+
+		/// Writes bytes of the pending sextets (2, 3 or 4 of them). Returns number of written bytes.
+		FORCEINLINE SIZE_T WriteGroup(BYTE* destination) NOEXCEPT
+		{
+			const SIZE_T size = Pending - 1;
+			const uint32 group = Bits << (6 * (4 - Pending));
+
+			for (SIZE_T i = 0; i < size; ++i)
+				destination[i] = static_cast<BYTE>(group >> (16 - 8 * i));
+
+			Bits = 0;
+			Pending = 0;
+			return size;
+		}
+
+		FORCEINLINE bool DecodeCharacter(BYTE*& current, uint8 c) NOEXCEPT
+		{
+			if (bIsInArmor)
+			{
+				bIsInArmor = (c != '\n');
+				bIsAtLineStart = !bIsInArmor;
+				return true;
+			}
+
+			const uint8 value = DigitValues[c];
+
+			if (value == WhitespaceValue)
+			{
+				bIsAtLineStart = bIsAtLineStart || c == '\n';
+				return true;
+			}
+
+			if (c == '-' && bIsAtLineStart)
+			{
+				bIsInArmor = true;
+				return true;
+			}
+
+			bIsAtLineStart = false;
+
+			if (value == PaddingValue)
+			{
+				// "xx==" or "xxx=" only
+				if (Pending < 2 || Pending + ++Padding > 4)
+					return false;
+
+				if (Pending + Padding == 4)
+				{
+					current += WriteGroup(current);
+					Padding = 0;
+					bHasEnded = true;
+				}
+
+				return true;
+			}
+
+			if (value == InvalidValue || Padding > 0 || bHasEnded)
+				return false;
+
+			Bits = (Bits << 6) | value;
+
+			if (++Pending == 4)
+				current += WriteGroup(current);
+
+			return true;
+		}
+
+	private:
+
+		/// Pending sextets, the last one in the low bits
+		uint32 Bits;
+
+		uint8 Pending;
+
+		/// '=' characters of the current group
+		uint8 Padding;
+
+		bool bIsAtLineStart;
+
+		bool bIsInArmor;
+
+		/// Padding has closed the data, only whitespace and armor may follow
+		bool bHasEnded;
+
+	};
+
+} }
+
+
+#endif
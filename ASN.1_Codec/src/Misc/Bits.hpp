@@ -0,0 +1,89 @@
+#ifndef __REAL_BITS__
+#define __REAL_BITS__
+
+#include "../Core.h"
+
+#if defined(REAL_MSVC_COMPILER)
+#include <intrin.h>
+#endif
+
+// pdep/pext, every CPU with AVX2 has them
+#if defined(__BMI2__) || defined(__AVX2__)
+#define REAL_BITS_BMI2
+#include <immintrin.h>
+#endif
+
+
+/**
+ * Real::Bits functions wrap compiler intrinsics for bit scanning.
+ */
+namespace Real { namespace Bits {
+
+	/// Returns number of leading zero bits. x must not be 0.
+	FORCEINLINE uint32 CountLeadingZeros(uint64 x) NOEXCEPT
+	{
+#if defined(REAL_MSVC_COMPILER)
+		unsigned long index;
+		_BitScanReverse64(&index, x);
+		return 63 - index;
+#else
+		return __builtin_clzll(x);
+#endif
+	}
+
+	/// Returns number of trailing zero bits. x must not be 0.
+	FORCEINLINE uint32 CountTrailingZeros(uint64 x) NOEXCEPT
+	{
+#if defined(REAL_MSVC_COMPILER)
+		unsigned long index;
+		_BitScanForward64(&index, x);
+		return index;
+#else
+		return __builtin_ctzll(x);
+#endif
+	}
+
+	/// Returns number of significant bits (0 for 0).
+	FORCEINLINE uint32 BitWidth(uint64 x) NOEXCEPT
+	{
+		return x ? 64 - CountLeadingZeros(x) : 0;
+	}
+
+	/// Moves bits 7k..7k+6 of the low 56 bits to bits 0..6 of byte k. High bit of every byte is 0.
+	FORCEINLINE uint64 SpreadBase128(uint64 x) NOEXCEPT
+	{
+#if defined(REAL_BITS_BMI2)
+		return _pdep_u64(x, 0x7F7F7F7F7F7F7F7Full);
+#else
+		// 28-bit halves to 32-bit lanes, 14-bit quarters to 16-bit lanes, 7-bit groups to bytes
+		x = (x & 0x000000000FFFFFFFull) | ((x & 0x00FFFFFFF0000000ull) << 4);
+		x = (x & 0x00003FFF00003FFFull) | ((x & 0x0FFFC0000FFFC000ull) << 2);
+		return (x & 0x007F007F007F007Full) | ((x & 0x3F803F803F803F80ull) << 1);
+#endif
+	}
+
+	/// Inverse of SpreadBase128: concatenates bits 0..6 of every byte, byte 0 is the lowest group.
+	FORCEINLINE uint64 GatherBase128(uint64 x) NOEXCEPT
+	{
+#if defined(REAL_BITS_BMI2)
+		return _pext_u64(x, 0x7F7F7F7F7F7F7F7Full);
+#else
+		x &= 0x7F7F7F7F7F7F7F7Full;
+		x = (x & 0x007F007F007F007Full) | ((x & 0x7F007F007F007F00ull) >> 1);
+		x = (x & 0x00003FFF00003FFFull) | ((x & 0x3FFF00003FFF0000ull) >> 2);
+		return (x & 0x000000000FFFFFFFull) | ((x & 0x0FFFFFFF00000000ull) >> 4);
+#endif
+	}
+
+	/// Reverses order of bits inside every byte, bytes stay in place.
+	FORCEINLINE uint64 ReverseBitsInBytes(uint64 x) NOEXCEPT
+	{
+		x = ((x >> 1) & 0x5555555555555555ull) | ((x & 0x5555555555555555ull) << 1);
+		x = ((x >> 2) & 0x3333333333333333ull) | ((x & 0x3333333333333333ull) << 2);
+		return ((x >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((x & 0x0F0F0F0F0F0F0F0Full) << 4);
+	}
+
+} }
+
+
+#endif
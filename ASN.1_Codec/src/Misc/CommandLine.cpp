@@ -247,7 +247,10 @@ namespace Real {
 				// if we don't have an option, but have a value, then
 				// we can store it as an option without option signs (to easily find it in ParsedArguments object).
 				if (curr.type == EOptionType::SPACE)
+				{
 					std::swap(curr.name, curr.value);
+					args.AddPositional(curr.name);
+				}
 				
 				curr.name = Char::ConstructOption(curr.type, curr.name);
 
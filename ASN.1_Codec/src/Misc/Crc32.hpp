@@ -0,0 +1,96 @@
+#ifndef __REAL_CRC32__
+#define __REAL_CRC32__
+
+#include "../Core.h"
+#include "Simd.hpp"
+#include <array>
+#include <cstring>
+
+
+/**
+ * Real::Crc32 functions compute CRC-32C (Castagnoli polynomial, as in iSCSI and ext4), the checksum SSE4.2 computes in hardware.
+ * Other platforms use slicing-by-8 tables, both give the same results.
+ */
+namespace Real { namespace Crc32 {
+
+	/// Reflected Castagnoli polynomial.
+	constexpr uint32 Polynomial = 0x82F63B78;
+
+	/// State of a CRC before the first byte.
+	constexpr uint32 InitialState = 0xFFFFFFFF;
+
+	constexpr std::array<std::array<uint32, 256>, 8> BuildTables()
+	{
+		std::array<std::array<uint32, 256>, 8> tables{};
+
+		for (uint32 b = 0; b < 256; ++b)
+		{
+			uint32 crc = b;
+
+			for (int32 bit = 0; bit < 8; ++bit)
+				crc = (crc >> 1) ^ ((crc & 1) ? Polynomial : 0);
+
+			tables[0][b] = crc;
+		}
+
+		for (SIZE_T k = 1; k < 8; ++k)
+		{
+			for (uint32 b = 0; b < 256; ++b)
+				tables[k][b] = (tables[k - 1][b] >> 8) ^ tables[0][tables[k - 1][b] & 0xFF];
+		}
+
+		return tables;
+	}
+
+	/// Tables[k][b] is the CRC of byte b followed by k zero bytes.
+	constexpr std::array<std::array<uint32, 256>, 8> Tables = BuildTables();
+
+	/**
+	 * Continues a CRC over more bytes, so a stream can be checked in pieces of any size.
+	 *
+	 * \param state	InitialState or the result of the previous call
+	 * \param bytes	bytes to add
+	 * \param count	number of bytes
+	 *
+	 * \return new state, GetChecksum turns it into the CRC
+	 */
+	inline uint32 Update(uint32 state, const BYTE* bytes, SIZE_T count) NOEXCEPT
+	{
+#if defined(REAL_SIMD_SSE42)
+		for (; count >= 8; count -= 8, bytes += 8)
+		{
+			uint64 word;
+			std::memcpy(&word, bytes, sizeof(word));
+			state = static_cast<uint32>(_mm_crc32_u64(state, word));
+		}
+
+		for (; count > 0; --count)
+			state = _mm_crc32_u8(state, static_cast<uint8>(*bytes++));
+#else
+		const uint8* current = reinterpret_cast<const uint8*>(bytes);
+
+		for (; count >= 8; count -= 8, current += 8)
+		{
+			const uint32 low = state ^ (current[0] | (current[1] << 8) | (current[2] << 16) | (static_cast<uint32>(current[3]) << 24));
+
+			state = Tables[7][low & 0xFF] ^ Tables[6][(low >> 8) & 0xFF] ^ Tables[5][(low >> 16) & 0xFF] ^ Tables[4][low >> 24]
+				  ^ Tables[3][current[4]] ^ Tables[2][current[5]] ^ Tables[1][current[6]] ^ Tables[0][current[7]];
+		}
+
+		for (; count > 0; --count)
+			state = (state >> 8) ^ Tables[0][(state ^ *current++) & 0xFF];
+#endif
+
+		return state;
+	}
+
+	/// Returns the CRC of all the bytes given to Update.
+	FORCEINLINE constexpr uint32 GetChecksum(uint32 state) NOEXCEPT { return ~state; }
+
+	/// Returns the CRC of bytes.
+	FORCEINLINE uint32 Compute(const BYTE* bytes, SIZE_T count) NOEXCEPT { return GetChecksum(Update(InitialState, bytes, count)); }
+
+} }
+
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef __REAL_HEX__
+#define __REAL_HEX__
+
+#include "../Core.h"
+#include "Simd.hpp"
+#include <algorithm>
+#include <array>
+
+
+/**
+ * Real::Hex functions turn bytes into hex text and back a whole block at a time.
+ */
+namespace Real { namespace Hex {
+
+	/// Characters one byte takes in spaced form: two digits and a space.
+	constexpr SIZE_T SpacedCharsPerByte = 3;
+
+	constexpr ANSICHAR LowerDigits[] = "0123456789abcdef";
+
+	/**
+	 * Writes bytes as lowercase hex pairs each followed by a space ("04 03 0a ").
+	 * 16 bytes at a time are converted by Simd::HexSpaced16.
+	 *
+	 * \param destination	buffer of at least SpacedCharsPerByte * count characters
+	 * \param source		bytes to convert
+	 * \param count			number of bytes
+	 *
+	 * \return number of written characters
+	 */
+	inline SIZE_T EncodeSpaced(BYTE* destination, const BYTE* source, SIZE_T count) NOEXCEPT
+	{
+		SIZE_T i = 0;
+
+		for (; i + 16 <= count; i += 16)
+			Simd::HexSpaced16(destination + SpacedCharsPerByte * i, source + i);
+
+		for (; i < count; ++i)
+		{
+			const uint8 byte = static_cast<uint8>(source[i]);
+
+			destination[SpacedCharsPerByte * i] = LowerDigits[byte >> 4];
+			destination[SpacedCharsPerByte * i + 1] = LowerDigits[byte & 0x0F];
+			destination[SpacedCharsPerByte * i + 2] = ' ';
+		}
+
+		return SpacedCharsPerByte * count;
+	}
+
+	/// Marks of DigitValues entries that are not digits.
+	constexpr uint8 WhitespaceValue = 0x40;
+	constexpr uint8 InvalidValue = 0xFF;
+
+	/// Space, tab, line feed, vertical tab, form feed and carriage return.
+	constexpr bool IsWhitespace(uint8 c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+	constexpr std::array<uint8, 256> BuildDigitValues()
+	{
+		std::array<uint8, 256> values{};
+
+		for (uint32 c = 0; c < 256; ++c)
+		{
+			const uint8 value = Simd::HexDigitValue(static_cast<uint8>(c));
+			values[c] = (value != 0xFF) ? value : IsWhitespace(static_cast<uint8>(c)) ? WhitespaceValue : InvalidValue;
+		}
+
+		return values;
+	}
+
+	/// Value of every character: digit value, WhitespaceValue or InvalidValue.
+	constexpr std::array<uint8, 256> DigitValues = BuildDigitValues();
+
+
+	/**
+	 * Streaming decoder of hex text. Digits of any case, whitespace between them is skipped
+	 * (so both EncodeSpaced output and plain digit runs are accepted). Text may be split anywhere between calls.
+	 */
+	class Decoder
+	{
+	public:
+
+		Decoder() : HighDigit(0), bHasHighDigit(false) { }
+
+		/**
+		 * Decodes a piece of text. Blocks of 48 characters in EncodeSpaced form and of 16 plain digits
+		 * go through the vector kernels, anything else is decoded one character at a time.
+		 *
+		 * \param destination	buffer of at least (count + 1) / 2 bytes
+		 * \param text			text to decode
+		 * \param count			number of characters
+		 * \param[out] written	number of decoded bytes
+		 *
+		 * \return false if the text has a character that is neither a digit nor whitespace
+		 */
+		bool Decode(BYTE* destination, const BYTE* text, SIZE_T count, SIZE_T& written) NOEXCEPT
+		{
+			const BYTE* const end = text + count;
+			BYTE* current = destination;
+
+			while (text < end)
+			{
+				if (!bHasHighDigit)
+				{
+					while (end - text >= 48 && Simd::HexDecodeSpaced48(current, text))
+					{
+						text += 48;
+						current += 16;
+					}
+
+					while (end - text >= 16 && Simd::HexDecode16(current, text))
+					{
+						text += 16;
+						current += 8;
+					}
+				}
+
+				// a block the kernels did not take is decoded here before they are tried again
+				const BYTE* const block_end = text + std::min<SIZE_T>(end - text, 16);
+
+				for (; text < block_end; ++text)
+				{
+					const uint8 value = DigitValues[static_cast<uint8>(*text)];
+
+					if (value < 16)
+					{
+						if (bHasHighDigit)
+							*current++ = static_cast<BYTE>((HighDigit << 4) | value);
+						else
+							HighDigit = value;
+
+						bHasHighDigit = !bHasHighDigit;
+					}
+					else if (value == InvalidValue)
+					{
+						written = current - destination;
+						return false;
+					}
+				}
+			}
+
+			written = current - destination;
+			return true;
+		}
+
+		/// Checks that every digit has got its pair, so the text ended on a byte boundary.
+		FORCEINLINE bool IsComplete() const { return !bHasHighDigit; }
+
+	private:
+
+		uint8 HighDigit;
+
+		bool bHasHighDigit;
+
+	};
+
+} }
+
+
+#endif
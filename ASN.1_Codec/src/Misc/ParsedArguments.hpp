@@ -6,6 +6,7 @@
 #include "Any.hpp"
 #include <unordered_map>
 #include <map>
+#include <vector>
 
 
 namespace Real {
@@ -49,10 +50,18 @@ namespace Real {
 		/// Returns internal variable map
 		FORCEINLINE var_map_type& GetVariableMap() { return VariableMap; }
 
+		/// Remembers a value passed without an option sign (keeps command line order)
+		FORCEINLINE void AddPositional(const std::string& value) { Positional.push_back(value); }
+
+		/// Returns values passed without option signs in command line order
+		FORCEINLINE const std::vector<std::string>& GetPositional() const { return Positional; }
+
 	private:
 
 		var_map_type VariableMap;
 
+		std::vector<std::string> Positional;
+
 	};
 
 
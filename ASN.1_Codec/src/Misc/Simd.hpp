@@ -0,0 +1,451 @@
+#ifndef __REAL_SIMD__
+#define __REAL_SIMD__
+
+#include "../Core.h"
+#include "Endian.hpp"
+#include <array>
+#include <cstring>
+
+// SSE2 is a part of every x86-64 CPU
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define REAL_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+// byte shuffles, /arch:AVX on MSVC implies them
+#if defined(__SSSE3__) || defined(__AVX__)
+#define REAL_SIMD_SSSE3
+#include <tmmintrin.h>
+#endif
+
+// crc32 instruction, 64-bit form only on x86-64
+#if (defined(__SSE4_2__) || defined(__AVX__)) && (defined(__x86_64__) || defined(_M_X64))
+#define REAL_SIMD_SSE42
+#include <nmmintrin.h>
+#endif
+
+
+/**
+ * Real::Simd functions are small vector kernels with a portable SWAR fallback,
+ * so every platform gets the same results and x86-64 gets them from SSE2.
+ */
+namespace Real { namespace Simd {
+
+	/// Returns high bits of 8 bytes: bit i is the high bit of data[i].
+	FORCEINLINE uint32 MoveMask8(const void* data) NOEXCEPT
+	{
+		uint64 x;
+		std::memcpy(&x, data, sizeof(x));
+		x = Endian::little_to_native(x);
+
+		// every high bit lands in its own position of the top byte, no carries in between
+		return static_cast<uint32>((((x & 0x8080808080808080ull) >> 7) * 0x0102040810204080ull) >> 56);
+	}
+
+	/// Returns high bits of 16 bytes: bit i is the high bit of data[i].
+	FORCEINLINE uint32 MoveMask16(const void* data) NOEXCEPT
+	{
+#if defined(REAL_SIMD_SSE2)
+		return static_cast<uint32>(_mm_movemask_epi8(_mm_loadu_si128(static_cast<const __m128i*>(data))));
+#else
+		return MoveMask8(data) | (MoveMask8(static_cast<const BYTE*>(data) + 8) << 8);
+#endif
+	}
+
+	/// Packs 8 flags (any non-zero byte is set) into a byte, the first flag becomes the high bit.
+	FORCEINLINE uint8 PackFlags8(const void* flags) NOEXCEPT
+	{
+		uint64 x;
+		std::memcpy(&x, flags, sizeof(x));
+		x = Endian::little_to_native(x);
+
+		// high bit of every non-zero byte
+		x = (((x & 0x7F7F7F7F7F7F7F7Full) + 0x7F7F7F7F7F7F7F7Full) | x) & 0x8080808080808080ull;
+
+		// flag i lands in bit 63 - i, no carries reach the top byte
+		return static_cast<uint8>(((x >> 7) * 0x8040201008040201ull) >> 56);
+	}
+
+	/// Packs 16 flags into 2 bytes, the first flag becomes the high bit of the first byte.
+	FORCEINLINE void PackFlags16(BYTE* destination, const void* flags) NOEXCEPT
+	{
+#if defined(REAL_SIMD_SSE2)
+		__m128i set = _mm_cmpeq_epi8(_mm_loadu_si128(static_cast<const __m128i*>(flags)), _mm_setzero_si128());
+
+		// reverse bytes inside both 8-byte halves, so movemask puts the first flag of every half to the high bit
+		set = _mm_shufflehi_epi16(_mm_shufflelo_epi16(set, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+		set = _mm_or_si128(_mm_slli_epi16(set, 8), _mm_srli_epi16(set, 8));
+
+		const uint32 mask = ~static_cast<uint32>(_mm_movemask_epi8(set));
+		destination[0] = static_cast<BYTE>(mask);
+		destination[1] = static_cast<BYTE>(mask >> 8);
+#else
+		destination[0] = static_cast<BYTE>(PackFlags8(flags));
+		destination[1] = static_cast<BYTE>(PackFlags8(static_cast<const BYTE*>(flags) + 8));
+#endif
+	}
+
+	/// Expands a byte into 8 flags of 0 or 1, the high bit becomes the first flag.
+	FORCEINLINE void UnpackFlags8(void* flags, uint8 bits) NOEXCEPT
+	{
+		// byte i keeps bit 7 - i of the broadcast byte
+		const uint64 selected = (bits * 0x0101010101010101ull) & 0x0102040810204080ull;
+
+		// + 0x7F carries into the high bit of non-zero bytes only
+		const uint64 x = Endian::native_to_little<uint64>(((selected + 0x7F7F7F7F7F7F7F7Full) >> 7) & 0x0101010101010101ull);
+		std::memcpy(flags, &x, sizeof(x));
+	}
+
+	/// Expands 2 bytes into 16 flags of 0 or 1, the high bit of the first byte becomes the first flag.
+	FORCEINLINE void UnpackFlags16(void* flags, const BYTE* bits) NOEXCEPT
+	{
+#if defined(REAL_SIMD_SSE2)
+		const __m128i select = _mm_setr_epi8(-128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1);
+
+		// first byte to the low 8 lanes, second one to the high 8 lanes
+		__m128i x = _mm_cvtsi32_si128(static_cast<uint8>(bits[0]) | (static_cast<uint8>(bits[1]) << 8));
+		x = _mm_unpacklo_epi8(x, x);
+		x = _mm_unpacklo_epi16(x, x);
+		x = _mm_unpacklo_epi32(x, x);
+
+		x = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(x, select), select), _mm_set1_epi8(1));
+		_mm_storeu_si128(static_cast<__m128i*>(flags), x);
+#else
+		UnpackFlags8(flags, static_cast<uint8>(bits[0]));
+		UnpackFlags8(static_cast<BYTE*>(flags) + 8, static_cast<uint8>(bits[1]));
+#endif
+	}
+
+	/// Turns every byte holding a nibble (0 to 15) into its lowercase hex digit.
+	FORCEINLINE uint64 NibblesToHexDigits8(uint64 nibbles) NOEXCEPT
+	{
+		// bit 4 of nibble + 6 is set for 10 to 15 only, those get 'a' - '0' - 10 more, no carries between bytes
+		const uint64 letters = ((nibbles + 0x0606060606060606ull) >> 4) & 0x0101010101010101ull;
+		return nibbles + 0x3030303030303030ull + letters * 0x27;
+	}
+
+	/// Writes 8 bytes as lowercase hex pairs each followed by a space (24 characters).
+	FORCEINLINE void HexSpaced8(BYTE* destination, const void* bytes) NOEXCEPT
+	{
+		uint64 x;
+		std::memcpy(&x, bytes, sizeof(x));
+		x = Endian::little_to_native(x);
+
+		const uint64 high = NibblesToHexDigits8((x >> 4) & 0x0F0F0F0F0F0F0F0Full);
+		const uint64 low = NibblesToHexDigits8(x & 0x0F0F0F0F0F0F0F0Full);
+
+		for (uint32 i = 0; i < 8; ++i)
+		{
+			destination[3 * i] = static_cast<BYTE>(high >> (8 * i));
+			destination[3 * i + 1] = static_cast<BYTE>(low >> (8 * i));
+			destination[3 * i + 2] = ' ';
+		}
+	}
+
+	/// Writes 16 bytes as lowercase hex pairs each followed by a space (48 characters).
+	FORCEINLINE void HexSpaced16(BYTE* destination, const void* bytes) NOEXCEPT
+	{
+#if defined(REAL_SIMD_SSSE3)
+		const __m128i x = _mm_loadu_si128(static_cast<const __m128i*>(bytes));
+		const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+		const __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+
+		const __m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(x, 4), nibble_mask));
+		const __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(x, nibble_mask));
+
+		// digit pairs of bytes 0-7 and 8-15
+		const __m128i first = _mm_unpacklo_epi8(high, low);
+		const __m128i second = _mm_unpackhi_epi8(high, low);
+
+		// every 16 output characters take their pairs from one or both halves, -128 lanes become spaces
+		const __m128i space = _mm_set1_epi8(' ');
+		const __m128i gap = _mm_set1_epi8(-128);
+
+		const __m128i index0 = _mm_setr_epi8(0, 1, -128, 2, 3, -128, 4, 5, -128, 6, 7, -128, 8, 9, -128, 10);
+		const __m128i index1_first = _mm_setr_epi8(11, -128, 12, 13, -128, 14, 15, -128, -128, -128, -128, -128, -128, -128, -128, -128);
+		const __m128i index1_second = _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128, 0, 1, -128, 2, 3, -128, 4, 5);
+		const __m128i index2 = _mm_setr_epi8(-128, 6, 7, -128, 8, 9, -128, 10, 11, -128, 12, 13, -128, 14, 15, -128);
+
+		const __m128i out0 = _mm_or_si128(_mm_shuffle_epi8(first, index0), _mm_and_si128(_mm_cmpeq_epi8(index0, gap), space));
+		const __m128i index1 = _mm_and_si128(index1_first, index1_second);
+		const __m128i out1 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(first, index1_first), _mm_shuffle_epi8(second, index1_second)), _mm_and_si128(_mm_cmpeq_epi8(index1, gap), space));
+		const __m128i out2 = _mm_or_si128(_mm_shuffle_epi8(second, index2), _mm_and_si128(_mm_cmpeq_epi8(index2, gap), space));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination), out0);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + 16), out1);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + 32), out2);
+#elif defined(REAL_SIMD_SSE2)
+		const __m128i x = _mm_loadu_si128(static_cast<const __m128i*>(bytes));
+		const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+
+		// no byte shuffles: digits are computed and paired for all 16 bytes, then every pair is stored with its space
+		const auto to_digits = [](__m128i nibbles)
+		{
+			const __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8(0x27));
+			return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+		};
+
+		const __m128i high = to_digits(_mm_and_si128(_mm_srli_epi16(x, 4), nibble_mask));
+		const __m128i low = to_digits(_mm_and_si128(x, nibble_mask));
+
+		// x86 is little endian: the high digit is the low byte of a pair
+		alignas(16) uint16 pairs[16];
+		_mm_store_si128(reinterpret_cast<__m128i*>(pairs), _mm_unpacklo_epi8(high, low));
+		_mm_store_si128(reinterpret_cast<__m128i*>(pairs + 8), _mm_unpackhi_epi8(high, low));
+
+		// 4 byte stores overlap by one, the last pair must not write past the 48 characters
+		for (uint32 i = 0; i < 15; ++i)
+		{
+			const uint32 spaced = pairs[i] | (static_cast<uint32>(' ') << 16);
+			std::memcpy(destination + 3 * i, &spaced, sizeof(spaced));
+		}
+
+		std::memcpy(destination + 45, &pairs[15], sizeof(uint16));
+		destination[47] = ' ';
+#else
+		HexSpaced8(destination, bytes);
+		HexSpaced8(destination + 24, static_cast<const BYTE*>(bytes) + 8);
+#endif
+	}
+
+	/// Scalar lane of the hex decoding kernels: value of a hex digit of any case or 0xFF.
+	FORCEINLINE constexpr uint8 HexDigitValue(uint8 c) NOEXCEPT
+	{
+		const uint8 digit = static_cast<uint8>(c - '0');
+		const uint8 letter = static_cast<uint8>((c | 0x20) - 'a');
+
+		return (digit <= 9) ? digit : (letter <= 5) ? static_cast<uint8>(letter + 10) : 0xFF;
+	}
+
+	constexpr ANSICHAR Base64Digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+	constexpr std::array<uint8, 256> BuildBase64Values()
+	{
+		std::array<uint8, 256> values{};
+
+		for (uint32 c = 0; c < 256; ++c)
+			values[c] = 0xFF;
+
+		for (uint32 value = 0; value < 64; ++value)
+			values[static_cast<uint8>(Base64Digits[value])] = static_cast<uint8>(value);
+
+		return values;
+	}
+
+	/// 6-bit value of every character or 0xFF. Tables keep the scalar lanes free of branches on random data.
+	constexpr std::array<uint8, 256> Base64Values = BuildBase64Values();
+
+	/// Scalar lane of the Base64 encoding kernel: character of a 6-bit value.
+	FORCEINLINE constexpr BYTE Base64Digit(uint32 value) NOEXCEPT
+	{
+		return Base64Digits[value];
+	}
+
+	/// Scalar lane of the Base64 decoding kernel: 6-bit value of a character or 0xFF.
+	FORCEINLINE constexpr uint8 Base64Value(uint8 c) NOEXCEPT
+	{
+		return Base64Values[c];
+	}
+
+#if defined(REAL_SIMD_SSE2)
+	/**
+	 * Turns 16 hex digits of any case into 8 bytes in the low half of the result.
+	 * Returns false if any character is not a hex digit.
+	 */
+	FORCEINLINE bool HexDigitsToBytes(__m128i text, __m128i& bytes) NOEXCEPT
+	{
+		const __m128i digit = _mm_sub_epi8(text, _mm_set1_epi8('0'));
+		const __m128i letter = _mm_sub_epi8(_mm_or_si128(text, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+
+		// unsigned x <= n is min(x, n) == x
+		const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+		const __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+
+		if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) != 0xFFFF)
+			return false;
+
+		const __m128i values = _mm_or_si128(_mm_and_si128(is_digit, digit), _mm_andnot_si128(is_digit, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+
+		// every 16-bit lane holds high digit in the low byte and low digit in the high byte
+		const __m128i pairs = _mm_and_si128(_mm_or_si128(_mm_slli_epi16(values, 4), _mm_srli_epi16(values, 8)), _mm_set1_epi16(0x00FF));
+		bytes = _mm_packus_epi16(pairs, pairs);
+		return true;
+	}
+#endif
+
+	/**
+	 * Decodes 16 hex digits of any case into 8 bytes.
+	 * Returns false if any character is not a hex digit, the destination is then left in unspecified state.
+	 */
+	FORCEINLINE bool HexDecode16(BYTE* destination, const BYTE* text) NOEXCEPT
+	{
+#if defined(REAL_SIMD_SSE2)
+		__m128i bytes;
+		if (!HexDigitsToBytes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(text)), bytes))
+			return false;
+
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(destination), bytes);
+		return true;
+#else
+		for (uint32 i = 0; i < 8; ++i)
+		{
+			const uint8 high = HexDigitValue(static_cast<uint8>(text[2 * i]));
+			const uint8 low = HexDigitValue(static_cast<uint8>(text[2 * i + 1]));
+
+			if ((high | low) == 0xFF)
+				return false;
+
+			destination[i] = static_cast<BYTE>((high << 4) | low);
+		}
+		return true;
+#endif
+	}
+
+	/**
+	 * Decodes 48 characters of HexSpaced16 form (16 pairs, every one followed by a space) into 16 bytes.
+	 * Returns false if the text has any other layout, the destination is then left in unspecified state.
+	 */
+	FORCEINLINE bool HexDecodeSpaced48(BYTE* destination, const BYTE* text) NOEXCEPT
+	{
+#if defined(REAL_SIMD_SSSE3)
+		const __m128i text0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text));
+		const __m128i text1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + 16));
+		const __m128i text2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + 32));
+
+		// spaces after every pair: lanes 2, 5, ... of the first vector, 1, 4, ... of the second one, 0, 3, ... of the third one
+		const __m128i space = _mm_set1_epi8(' ');
+		if ((_mm_movemask_epi8(_mm_cmpeq_epi8(text0, space)) & 0x4924) != 0x4924 ||
+			(_mm_movemask_epi8(_mm_cmpeq_epi8(text1, space)) & 0x2492) != 0x2492 ||
+			(_mm_movemask_epi8(_mm_cmpeq_epi8(text2, space)) & 0x9249) != 0x9249)
+			return false;
+
+		// inverse of the HexSpaced16 shuffles: digits of bytes 0-7 and 8-15
+		const __m128i first = _mm_or_si128(
+			_mm_shuffle_epi8(text0, _mm_setr_epi8(0, 1, 3, 4, 6, 7, 9, 10, 12, 13, 15, -128, -128, -128, -128, -128)),
+			_mm_shuffle_epi8(text1, _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, 0, 2, 3, 5, 6)));
+		const __m128i second = _mm_or_si128(
+			_mm_shuffle_epi8(text1, _mm_setr_epi8(8, 9, 11, 12, 14, 15, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128)),
+			_mm_shuffle_epi8(text2, _mm_setr_epi8(-128, -128, -128, -128, -128, -128, 1, 2, 4, 5, 7, 8, 10, 11, 13, 14)));
+
+		__m128i low_bytes, high_bytes;
+		if (!HexDigitsToBytes(first, low_bytes) || !HexDigitsToBytes(second, high_bytes))
+			return false;
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination), _mm_unpacklo_epi64(low_bytes, high_bytes));
+		return true;
+#else
+		for (uint32 i = 0; i < 16; ++i)
+		{
+			const uint8 high = HexDigitValue(static_cast<uint8>(text[3 * i]));
+			const uint8 low = HexDigitValue(static_cast<uint8>(text[3 * i + 1]));
+
+			if ((high | low) == 0xFF || text[3 * i + 2] != ' ')
+				return false;
+
+			destination[i] = static_cast<BYTE>((high << 4) | low);
+		}
+		return true;
+#endif
+	}
+
+	/**
+	 * Encodes 12 bytes into 16 Base64 characters.
+	 * SSSE3 path spreads 4 groups of 3 bytes into 16 sextets with multiplies and maps them with one byte shuffle.
+	 */
+	FORCEINLINE void Base64Encode12(BYTE* destination, const BYTE* bytes) NOEXCEPT
+	{
+#if defined(REAL_SIMD_SSSE3)
+		uint32 tail;
+		std::memcpy(&tail, bytes + 8, sizeof(tail));
+
+		// no read past the 12 bytes
+		__m128i x = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(bytes)), _mm_cvtsi32_si128(static_cast<int32>(tail)));
+
+		// every 32-bit lane gets bytes b1 b0 b2 b1 of its group, so each sextet can be moved in place by a 16-bit multiply
+		x = _mm_shuffle_epi8(x, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+		const __m128i sextets_ac = _mm_mulhi_epu16(_mm_and_si128(x, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+		const __m128i sextets_bd = _mm_mullo_epi16(_mm_and_si128(x, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+		const __m128i sextets = _mm_or_si128(sextets_ac, sextets_bd);
+
+		// range of every sextet selects the offset to its character: 0-25 'A', 26-51 'a', 52-61 '0', 62 '+', 63 '/'
+		__m128i range = _mm_subs_epu8(sextets, _mm_set1_epi8(51));
+		range = _mm_or_si128(range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), sextets), _mm_set1_epi8(13)));
+
+		const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination), _mm_add_epi8(_mm_shuffle_epi8(offsets, range), sextets));
+#else
+		for (uint32 i = 0; i < 4; ++i)
+		{
+			const uint32 group = (static_cast<uint8>(bytes[3 * i]) << 16) | (static_cast<uint8>(bytes[3 * i + 1]) << 8) | static_cast<uint8>(bytes[3 * i + 2]);
+
+			destination[4 * i] = Base64Digit(group >> 18);
+			destination[4 * i + 1] = Base64Digit((group >> 12) & 0x3F);
+			destination[4 * i + 2] = Base64Digit((group >> 6) & 0x3F);
+			destination[4 * i + 3] = Base64Digit(group & 0x3F);
+		}
+#endif
+	}
+
+	/**
+	 * Decodes 16 Base64 characters (no padding) into 12 bytes.
+	 * Returns false if any character is outside the alphabet, the destination is then left in unspecified state.
+	 */
+	FORCEINLINE bool Base64Decode16(BYTE* destination, const BYTE* text) NOEXCEPT
+	{
+#if defined(REAL_SIMD_SSSE3)
+		const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text));
+		const __m128i high_nibbles = _mm_and_si128(_mm_srli_epi32(x, 4), _mm_set1_epi8(0x0F));
+		const __m128i low_nibbles = _mm_and_si128(x, _mm_set1_epi8(0x0F));
+
+		// bit h of the entry for low nibble l is set if character 0xhl belongs to the alphabet
+		const __m128i valid_high_nibbles = _mm_setr_epi8(
+			static_cast<int8>(0xA8), static_cast<int8>(0xF8), static_cast<int8>(0xF8), static_cast<int8>(0xF8), static_cast<int8>(0xF8),
+			static_cast<int8>(0xF8), static_cast<int8>(0xF8), static_cast<int8>(0xF8), static_cast<int8>(0xF8), static_cast<int8>(0xF8),
+			static_cast<int8>(0xF0), 0x54, 0x50, 0x50, 0x50, 0x54);
+		const __m128i high_nibble_bits = _mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+
+		const __m128i invalid = _mm_cmpeq_epi8(_mm_and_si128(_mm_shuffle_epi8(valid_high_nibbles, low_nibbles), _mm_shuffle_epi8(high_nibble_bits, high_nibbles)), _mm_setzero_si128());
+
+		if (_mm_movemask_epi8(invalid) != 0)
+			return false;
+
+		// offset by the high nibble, '/' shares it with '+' and gets its own
+		const __m128i offsets = _mm_shuffle_epi8(_mm_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0), high_nibbles);
+		const __m128i is_slash = _mm_cmpeq_epi8(x, _mm_set1_epi8('/'));
+		const __m128i sextets = _mm_add_epi8(x, _mm_or_si128(_mm_andnot_si128(is_slash, offsets), _mm_and_si128(is_slash, _mm_set1_epi8(16))));
+
+		// 4 sextets -> 24 bits in every 32-bit lane, then 3 bytes of every lane in big endian order
+		const __m128i pairs = _mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140));
+		const __m128i groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+		const __m128i bytes = _mm_shuffle_epi8(groups, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -128, -128, -128, -128));
+
+		const uint32 tail = static_cast<uint32>(_mm_cvtsi128_si32(_mm_srli_si128(bytes, 8)));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(destination), bytes);
+		std::memcpy(destination + 8, &tail, sizeof(tail));
+		return true;
+#else
+		for (uint32 i = 0; i < 4; ++i)
+		{
+			const uint8 a = Base64Value(static_cast<uint8>(text[4 * i]));
+			const uint8 b = Base64Value(static_cast<uint8>(text[4 * i + 1]));
+			const uint8 c = Base64Value(static_cast<uint8>(text[4 * i + 2]));
+			const uint8 d = Base64Value(static_cast<uint8>(text[4 * i + 3]));
+
+			if ((a | b | c | d) == 0xFF)
+				return false;
+
+			const uint32 group = (a << 18) | (b << 12) | (c << 6) | d;
+			destination[3 * i] = static_cast<BYTE>(group >> 16);
+			destination[3 * i + 1] = static_cast<BYTE>(group >> 8);
+			destination[3 * i + 2] = static_cast<BYTE>(group);
+		}
+		return true;
+#endif
+	}
+
+} }
+
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef __REAL_SPAN__
+#define __REAL_SPAN__
+
+#include "../Core.h"
+#include <vector>
+#include <type_traits>
+
+
+/**
+ * Project requires C++17, so std::span is not available everywhere.
+ * Real::Span is a minimal non-owning view over a contiguous sequence.
+ */
+namespace Real {
+
+	template<typename _Ty>
+	class Span
+	{
+	public:
+
+		typedef _Ty element_type;
+		typedef std::remove_cv_t<_Ty> value_type;
+		typedef _Ty* iterator;
+
+	public:
+
+		constexpr Span() NOEXCEPT : Pointer(nullptr), Count(0) { }
+
+		constexpr Span(_Ty* pointer, SIZE_T count) NOEXCEPT : Pointer(pointer), Count(count) { }
+
+		template<SIZE_T _Size>
+		constexpr Span(_Ty (&array)[_Size]) NOEXCEPT : Pointer(array), Count(_Size) { }
+
+		template<typename _Allocator>
+		Span(std::vector<value_type, _Allocator>& vector) NOEXCEPT : Pointer(vector.data()), Count(vector.size()) { }
+
+		template<typename _Allocator, typename _Other = _Ty, std::enable_if_t<std::is_const<_Other>::value, bool> = true>
+		Span(const std::vector<value_type, _Allocator>& vector) NOEXCEPT : Pointer(vector.data()), Count(vector.size()) { }
+
+		/// Allows Span<T> -> Span<const T> conversion
+		template<typename _Other, std::enable_if_t<std::is_convertible<_Other(*)[], _Ty(*)[]>::value, bool> = true>
+		constexpr Span(const Span<_Other>& other) NOEXCEPT : Pointer(other.Data()), Count(other.Size()) { }
+
+		FORCEINLINE constexpr _Ty* Data() const { return Pointer; }
+		FORCEINLINE constexpr SIZE_T Size() const { return Count; }
+		FORCEINLINE constexpr bool Empty() const { return Count == 0; }
+
+		FORCEINLINE constexpr _Ty& operator [] (SIZE_T index) const { return Pointer[index]; }
+
+		/// Returns count elements starting from offset.
+		FORCEINLINE constexpr Span Subspan(SIZE_T offset, SIZE_T count) const { return Span(Pointer + offset, count); }
+
+		FORCEINLINE constexpr iterator begin() const { return Pointer; }
+		FORCEINLINE constexpr iterator end() const { return Pointer + Count; }
+
+	private:
+
+		_Ty* Pointer;
+
+		SIZE_T Count;
+
+	};
+
+}
+
+
+#endif
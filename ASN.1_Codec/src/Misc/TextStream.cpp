@@ -0,0 +1,221 @@
+#include "TextStream.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace Real {
+
+	namespace Private
+	{
+		/// Armor lines of PEM output. The label names the content, an encoded octet string.
+		constexpr ANSICHAR PemBegin[] = "-----BEGIN OCTET STRING-----\n";
+		constexpr ANSICHAR PemEnd[] = "-----END OCTET STRING-----\n";
+
+		/// Output buffer takes the widest conversion of a block (hex) and the BEGIN line in front of it.
+		constexpr SIZE_T TextBufferSize = TextBlockSize * Hex::SpacedCharsPerByte + sizeof(PemBegin);
+
+		static_assert(Base64::Encoder::GetMaxEncodedSize(TextBlockSize + 2, Base64::PemLineLength) <= TextBlockSize * Hex::SpacedCharsPerByte);
+	}
+
+
+	/**
+	 * Parses a format name: der or raw, hex, base64, pem.
+	 *
+	 * \param[in]  name		format name
+	 * \param[out] format	parsed format
+	 *
+	 * \return false if the name is unknown
+	 */
+	bool ParseTextFormat(const std::string& name, ETextFormat& format)
+	{
+		if (name == "der" || name == "raw")
+			format = ETextFormat::RAW;
+		else if (name == "hex")
+			format = ETextFormat::HEX;
+		else if (name == "base64")
+			format = ETextFormat::BASE64;
+		else if (name == "pem")
+			format = ETextFormat::PEM;
+		else
+			return false;
+
+		return true;
+	}
+
+
+	TextWriter::TextWriter(System::PlatformFile& output, ETextFormat format)
+		: Output(output),
+		  Format(format),
+		  Encoder(format == ETextFormat::PEM ? Base64::PemLineLength : 0),
+		  Buffer(format != ETextFormat::RAW ? new BYTE[Private::TextBufferSize] : nullptr),
+		  bHasStarted(false)
+	{ }
+
+	/**
+	 * Converts and writes bytes.
+	 *
+	 * \param bytes	bytes to write
+	 * \param count	number of bytes
+	 *
+	 * \return false if the output failed
+	 */
+	bool TextWriter::Write(const BYTE* bytes, uint64 count)
+	{
+		if (Format == ETextFormat::RAW)
+			return Output.WriteAll(bytes, count);
+
+		while (count > 0)
+		{
+			const SIZE_T block = static_cast<SIZE_T>(std::min<uint64>(count, TextBlockSize));
+			SIZE_T size = WritePrologue(Buffer.get());
+
+			if (Format == ETextFormat::HEX)
+				size += Hex::EncodeSpaced(Buffer.get() + size, bytes, block);
+			else
+				size += Encoder.Encode(Buffer.get() + size, bytes, block);
+
+			if (size > 0 && !Output.WriteAll(Buffer.get(), size))
+				return false;
+
+			bytes += block;
+			count -= block;
+		}
+
+		return true;
+	}
+
+	/**
+	 * Writes the end of the text: last Base64 group and the END line of PEM.
+	 *
+	 * \return false if the output failed
+	 */
+	bool TextWriter::Finish()
+	{
+		if (Format == ETextFormat::RAW || Format == ETextFormat::HEX)
+			return true;
+
+		SIZE_T size = WritePrologue(Buffer.get());
+		size += Encoder.Finish(Buffer.get() + size);
+
+		if (Format == ETextFormat::PEM)
+		{
+			std::memcpy(Buffer.get() + size, Private::PemEnd, sizeof(Private::PemEnd) - 1);
+			size += sizeof(Private::PemEnd) - 1;
+		}
+
+		return size == 0 || Output.WriteAll(Buffer.get(), size);
+	}
+
+	/// Writes the BEGIN line of PEM to the buffer once. Returns number of written characters.
+	SIZE_T TextWriter::WritePrologue(BYTE* destination)
+	{
+		if (bHasStarted || Format != ETextFormat::PEM)
+			return 0;
+
+		bHasStarted = true;
+		std::memcpy(destination, Private::PemBegin, sizeof(Private::PemBegin) - 1);
+
+		return sizeof(Private::PemBegin) - 1;
+	}
+
+
+	TextReader::TextReader(System::PlatformFile& input, ETextFormat format)
+		: Input(input),
+		  Format(format),
+		  Text(format != ETextFormat::RAW ? new BYTE[TextBlockSize] : nullptr),
+		  SpillSize(0),
+		  SpillOffset(0),
+		  bHasEnded(false)
+	{ }
+
+	/**
+	 * Reads and decodes bytes. Digits left over from the previous block complete their byte or group with the
+	 * first characters of the next one, so count - 3 characters are read at most and the bytes always fit
+	 * the destination. Small reads and the end of the text are decoded into the spill buffer.
+	 *
+	 * \param destination	buffer of count bytes
+	 * \param count			maximum number of bytes to read
+	 *
+	 * \return number of read bytes, 0 at the end of input, -1 if reading failed or the text is malformed
+	 */
+	int64 TextReader::Read(BYTE* destination, uint64 count)
+	{
+		if (Format == ETextFormat::RAW)
+			return Input.Read(destination, count);
+
+		while (count > 0)
+		{
+			if (SpillOffset < SpillSize)
+			{
+				const SIZE_T size = std::min<SIZE_T>(SpillSize - SpillOffset, count);
+
+				std::memcpy(destination, Spill + SpillOffset, size);
+				SpillOffset += static_cast<uint8>(size);
+
+				return size;
+			}
+
+			if (bHasEnded)
+				return 0;
+
+			const bool bUsesSpill = count < sizeof(Spill);
+			BYTE* const target = bUsesSpill ? Spill : destination;
+			const uint64 capacity = bUsesSpill ? sizeof(Spill) : count;
+
+			const int64 received = Input.Read(Text.get(), std::min<uint64>(capacity - 3, TextBlockSize));
+
+			if (received < 0)
+				return -1;
+
+			SIZE_T written = 0;
+
+			if (received == 0)
+			{
+				bHasEnded = true;
+
+				if (!Finish(Spill, written))
+					return -1;
+			}
+			else
+			{
+				const bool bIsDecoded = (Format == ETextFormat::HEX)
+					? HexDecoder.Decode(target, Text.get(), received, written)
+					: Base64Decoder.Decode(target, Text.get(), received, written);
+
+				if (!bIsDecoded)
+					return -1;
+			}
+
+			// whitespace and armor lines give nothing, the next block is read then
+			if (bUsesSpill || received == 0)
+			{
+				SpillSize = static_cast<uint8>(written);
+				SpillOffset = 0;
+			}
+			else if (written > 0)
+				return written;
+		}
+
+		return 0;
+	}
+
+	/**
+	 * Decodes the end of the text.
+	 *
+	 * \param destination	buffer of at least 2 bytes
+	 * \param[out] written	number of decoded bytes
+	 *
+	 * \return false if the text is incomplete
+	 */
+	bool TextReader::Finish(BYTE* destination, SIZE_T& written)
+	{
+		written = 0;
+
+		if (Format == ETextFormat::HEX)
+			return HexDecoder.IsComplete();
+
+		return Base64Decoder.Finish(destination, written);
+	}
+
+}
@@ -0,0 +1,145 @@
+#ifndef __REAL_TEXT_STREAM__
+#define __REAL_TEXT_STREAM__
+
+#include "../Core.h"
+#include "../Platform/PlatformFile.h"
+#include "Hex.hpp"
+#include "Base64.hpp"
+#include <memory>
+#include <string>
+
+
+namespace Real {
+
+	/**
+	 * Representation of bytes in a file.
+	 */
+	enum class ETextFormat : uint8
+	{
+		RAW,		///< bytes as they are (DER output)
+		HEX,		///< space separated hex pairs, any hex digits and whitespace on input
+		BASE64,		///< Base64 in one line
+		PEM,		///< Base64 in lines of 64 characters between BEGIN and END lines
+	};
+
+	/**
+	 * Parses a format name: der or raw, hex, base64, pem.
+	 *
+	 * \param[in]  name		format name
+	 * \param[out] format	parsed format
+	 *
+	 * \return false if the name is unknown
+	 */
+	bool ParseTextFormat(const std::string& name, ETextFormat& format);
+
+	/// Bytes converted per block of text output, characters read per block of text input.
+	constexpr SIZE_T TextBlockSize = 64 * 1024;
+
+
+	/**
+	 * Writes bytes to a file in given format. Bytes are converted a block at a time into one reused buffer,
+	 * every block goes out with a single write right away, so output of any size takes fixed memory.
+	 */
+	class TextWriter
+	{
+	public:
+
+		TextWriter(System::PlatformFile& output, ETextFormat format);
+
+		/**
+		 * Converts and writes bytes.
+		 *
+		 * \param bytes	bytes to write
+		 * \param count	number of bytes
+		 *
+		 * \return false if the output failed
+		 */
+		bool Write(const BYTE* bytes, uint64 count);
+
+		/**
+		 * Writes the end of the text: last Base64 group and the END line of PEM.
+		 *
+		 * \return false if the output failed
+		 */
+		bool Finish();
+
+	private:
+
+		/// Writes the BEGIN line of PEM to the buffer once. Returns number of written characters.
+		SIZE_T WritePrologue(BYTE* destination);
+
+	private:
+
+		System::PlatformFile& Output;
+
+		ETextFormat Format;
+
+		Base64::Encoder Encoder;
+
+		std::unique_ptr<BYTE[]> Buffer;
+
+		bool bHasStarted;
+
+	};
+
+
+	/**
+	 * Reads bytes from a file in given format. Text is read a block at a time and decoded straight
+	 * into the destination of the caller, only small reads and the end of the text go through a spill buffer.
+	 * PEM input is read as Base64, BEGIN and END lines are skipped.
+	 */
+	class TextReader
+	{
+	public:
+
+		TextReader(System::PlatformFile& input, ETextFormat format);
+
+		/**
+		 * Reads and decodes bytes.
+		 *
+		 * \param destination	buffer of count bytes
+		 * \param count			maximum number of bytes to read
+		 *
+		 * \return number of read bytes, 0 at the end of input, -1 if reading failed or the text is malformed
+		 */
+		int64 Read(BYTE* destination, uint64 count);
+
+	private:
+
+		/**
+		 * Decodes the end of the text.
+		 *
+		 * \param destination	buffer of at least 2 bytes
+		 * \param[out] written	number of decoded bytes
+		 *
+		 * \return false if the text is incomplete
+		 */
+		bool Finish(BYTE* destination, SIZE_T& written);
+
+	private:
+
+		System::PlatformFile& Input;
+
+		ETextFormat Format;
+
+		Hex::Decoder HexDecoder;
+
+		Base64::Decoder Base64Decoder;
+
+		std::unique_ptr<BYTE[]> Text;
+
+		/// Bytes of small reads and of the end of the text that are not taken yet
+		BYTE Spill[16];
+
+		uint8 SpillSize;
+
+		uint8 SpillOffset;
+
+		bool bHasEnded;
+
+	};
+
+}
+
+
+#endif
@@ -0,0 +1,117 @@
+#include "MappedFile.h"
+
+#if defined(REAL_PLATFORM_WINDOWS)
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+
+
+
+namespace Real { namespace System {
+
+
+	/**
+	 * Maps the whole regular file for reading.
+	 *
+	 * \param path		file name
+	 * \param options	kernel hints
+	 *
+	 * \return false if the file cannot be opened or mapped
+	 */
+	bool MemoryMappedFile::Open(const TCHAR* path, EMapOptions options)
+	{
+		Close();
+
+#if defined(REAL_PLATFORM_WINDOWS)
+		const DWORD flags = any(options & EMapOptions::SEQUENTIAL) ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL;
+		HANDLE file = ::CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER file_size;
+		if (!::GetFileSizeEx(file, &file_size))
+		{
+			::CloseHandle(file);
+			return false;
+		}
+
+		Size = static_cast<uint64>(file_size.QuadPart);
+
+		if (Size > 0)
+		{
+			// the view keeps the mapping object alive, so both handles can be closed right away
+			HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			Data = mapping ? ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+			if (mapping) ::CloseHandle(mapping);
+		}
+
+		::CloseHandle(file);
+#else
+		const int descriptor = ::open(path, O_RDONLY | O_CLOEXEC);
+
+		if (descriptor < 0)
+			return false;
+
+		struct stat info;
+		if (::fstat(descriptor, &info) != 0 || !S_ISREG(info.st_mode))
+		{
+			::close(descriptor);
+			return false;
+		}
+
+		Size = static_cast<uint64>(info.st_size);
+
+		if (Size > 0)
+		{
+			int flags = MAP_PRIVATE;
+#if defined(REAL_PLATFORM_LINUX)
+			if (any(options & EMapOptions::POPULATE)) flags |= MAP_POPULATE;
+#endif
+			Data = ::mmap(nullptr, Size, PROT_READ, flags, descriptor, 0);
+
+			if (Data == MAP_FAILED)
+				Data = nullptr;
+			else if (any(options & EMapOptions::SEQUENTIAL))
+				::posix_madvise(Data, Size, POSIX_MADV_SEQUENTIAL);
+		}
+
+		// the mapping stays valid after the descriptor is closed
+		::close(descriptor);
+#endif
+
+		if (Size > 0 && Data == nullptr)
+		{
+			Size = 0;
+			return false;
+		}
+
+		bIsOpen = true;
+		return true;
+	}
+
+	/// Unmaps the file.
+	void MemoryMappedFile::Close()
+	{
+		if (Data)
+		{
+#if defined(REAL_PLATFORM_WINDOWS)
+			::UnmapViewOfFile(Data);
+#else
+			::munmap(Data, Size);
+#endif
+		}
+
+		Data = nullptr;
+		Size = 0;
+		bIsOpen = false;
+	}
+
+
+} }
@@ -0,0 +1,93 @@
+#ifndef __REAL_MAPPED_FILE__
+#define __REAL_MAPPED_FILE__
+
+#include "../Core.h"
+
+
+namespace Real { namespace System {
+
+
+	/**
+	 * Hints passed to the kernel when the file is mapped.
+	 */
+	enum class EMapOptions : uint8
+	{
+		NONE		= 0x0,			///< no hints
+		SEQUENTIAL	= BIT8(0),		///< pages will be read once from the beginning to the end (MADV_SEQUENTIAL)
+		POPULATE	= BIT8(1),		///< prefault the whole mapping at once (MAP_POPULATE), trades startup time for fewer page faults
+	};
+
+	DECLARE_ENUM_FLAG_OPERATIONS(EMapOptions, uint8)
+
+
+	/**
+	 * Read-only view of a whole file mapped to memory.
+	 * Content is served straight from the page cache, so no heap copy of the file is ever made.
+	 */
+	class MemoryMappedFile
+	{
+	public:
+
+		MemoryMappedFile() : Data(nullptr), Size(0), bIsOpen(false) { }
+
+		MemoryMappedFile(const MemoryMappedFile&) = delete;
+		MemoryMappedFile& operator = (const MemoryMappedFile&) = delete;
+
+		MemoryMappedFile(MemoryMappedFile&& other) NOEXCEPT : Data(other.Data), Size(other.Size), bIsOpen(other.bIsOpen)
+		{
+			other.Data = nullptr;
+			other.Size = 0;
+			other.bIsOpen = false;
+		}
+
+		MemoryMappedFile& operator = (MemoryMappedFile&& other) NOEXCEPT
+		{
+			if (this != &other)
+			{
+				Close();
+				std::swap(Data, other.Data);
+				std::swap(Size, other.Size);
+				std::swap(bIsOpen, other.bIsOpen);
+			}
+			return *this;
+		}
+
+		~MemoryMappedFile() { Close(); }
+
+		/**
+		 * Maps the whole regular file for reading.
+		 *
+		 * \param path		file name
+		 * \param options	kernel hints
+		 *
+		 * \return false if the file cannot be opened or mapped
+		 */
+		bool Open(const TCHAR* path, EMapOptions options = EMapOptions::SEQUENTIAL);
+
+		/// Unmaps the file.
+		void Close();
+
+		/// Checks if the file is mapped. Empty files are open but have no data.
+		FORCEINLINE bool IsOpen() const { return bIsOpen; }
+
+		/// Returns pointer to the first byte of the file (nullptr for empty files).
+		FORCEINLINE const BYTE* GetData() const { return static_cast<const BYTE*>(Data); }
+
+		/// Returns size of the mapped file.
+		FORCEINLINE uint64 GetSize() const { return Size; }
+
+	private:
+
+		void* Data;
+
+		uint64 Size;
+
+		bool bIsOpen;
+
+	};
+
+
+} }
+
+
+#endif
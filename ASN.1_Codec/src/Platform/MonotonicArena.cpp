@@ -0,0 +1,85 @@
+#include "MonotonicArena.h"
+
+#include <algorithm>
+#include <new>
+
+
+namespace Real { namespace System {
+
+
+	MonotonicArena::MonotonicArena(SIZE_T block_size)
+		: MonotonicArena(Span<BYTE>(), block_size)
+	{ }
+
+	MonotonicArena::MonotonicArena(Span<BYTE> buffer, SIZE_T block_size)
+		: InitialBuffer(buffer), BlockSize(std::max<SIZE_T>(block_size, 1)), NextBlock(0),
+		  Current(buffer.Data()), End(buffer.Data() + buffer.Size()), UsedSize(0)
+	{ }
+
+	MonotonicArena::~MonotonicArena()
+	{
+		Release();
+	}
+
+	/// Makes all the memory reusable. Blocks are kept, pointers given before become invalid.
+	void MonotonicArena::Reset()
+	{
+		NextBlock = 0;
+		Current = InitialBuffer.Data();
+		End = InitialBuffer.Data() + InitialBuffer.Size();
+		UsedSize = 0;
+	}
+
+	/// Resets the arena and returns its blocks to the heap.
+	void MonotonicArena::Release()
+	{
+		for (const Block& block : Blocks)
+			::operator delete(block.Data);
+
+		Blocks.clear();
+		Reset();
+	}
+
+	/// Returns number of bytes of all the blocks and of the initial buffer.
+	SIZE_T MonotonicArena::GetReservedSize() const
+	{
+		SIZE_T size = InitialBuffer.Size();
+
+		for (const Block& block : Blocks)
+			size += block.Size;
+
+		return size;
+	}
+
+	/**
+	 * Moves to the next kept block that fits the allocation or takes a new one from the heap.
+	 * Kept blocks that are too small are skipped until the next reset.
+	 *
+	 * \param size		number of bytes
+	 * \param alignment	power of two
+	 *
+	 * \return pointer to the memory
+	 */
+	void* MonotonicArena::AllocateInNextBlock(SIZE_T size, SIZE_T alignment)
+	{
+		// blocks come from operator new, so they are aligned to max_align_t already
+		const SIZE_T required = size + (alignment > alignof(std::max_align_t) ? alignment : 0);
+
+		while (NextBlock < Blocks.size() && Blocks[NextBlock].Size < required)
+			++NextBlock;
+
+		if (NextBlock == Blocks.size())
+		{
+			const SIZE_T block_size = std::max(BlockSize, required);
+			Blocks.push_back({ static_cast<BYTE*>(::operator new(block_size)), block_size });
+		}
+
+		const Block& block = Blocks[NextBlock++];
+
+		Current = block.Data;
+		End = block.Data + block.Size;
+
+		return Allocate(size, alignment);
+	}
+
+} }
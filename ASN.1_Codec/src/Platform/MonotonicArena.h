@@ -0,0 +1,124 @@
+#ifndef __REAL_MONOTONIC_ARENA__
+#define __REAL_MONOTONIC_ARENA__
+
+#include "../Core.h"
+#include "../Misc/Span.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace Real { namespace System {
+
+
+	/**
+	 * Monotonic allocator: allocations move a cursor through large blocks and are never freed one by one,
+	 * Reset makes all the memory reusable at once. Blocks are kept between resets, so a worker that resets
+	 * its arena after every request or batch stops calling the heap once it has seen its largest request.
+	 * Not thread safe, every worker owns its arena.
+	 */
+	class MonotonicArena
+	{
+	public:
+
+		/// Size of blocks allocated by the arena if it is not given.
+		static constexpr SIZE_T DefaultBlockSize = 64 * 1024;
+
+	public:
+
+		/**
+		 * \param block_size size of blocks taken from the heap, larger allocations get a block of their own
+		 */
+		explicit MonotonicArena(SIZE_T block_size = DefaultBlockSize);
+
+		/**
+		 * Arena that serves allocations from the caller's buffer (e.g. a stack buffer of one request) first,
+		 * then from blocks of its own.
+		 *
+		 * \param buffer		initial buffer, must outlive the arena
+		 * \param block_size	size of blocks taken from the heap when the buffer is full
+		 */
+		explicit MonotonicArena(Span<BYTE> buffer, SIZE_T block_size = DefaultBlockSize);
+
+		MonotonicArena(const MonotonicArena&) = delete;
+		MonotonicArena& operator = (const MonotonicArena&) = delete;
+
+		/// Frees all the blocks.
+		~MonotonicArena();
+
+		/**
+		 * Allocates memory that stays valid until the next Reset or Release.
+		 *
+		 * \param size		number of bytes
+		 * \param alignment	power of two
+		 *
+		 * \return pointer to the memory, never nullptr (throws std::bad_alloc as new does)
+		 */
+		FORCEINLINE void* Allocate(SIZE_T size, SIZE_T alignment = alignof(std::max_align_t))
+		{
+			const uintptr_t aligned = (reinterpret_cast<uintptr_t>(Current) + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+
+			if (aligned + size > reinterpret_cast<uintptr_t>(End) || Current == nullptr)
+				return AllocateInNextBlock(size, alignment);
+
+			Current = reinterpret_cast<BYTE*>(aligned + size);
+			UsedSize += size;
+
+			return reinterpret_cast<void*>(aligned);
+		}
+
+		/// Allocates an uninitialized array of count elements.
+		template<typename _Ty>
+		FORCEINLINE _Ty* AllocateArray(SIZE_T count)
+		{
+			return static_cast<_Ty*>(Allocate(count * sizeof(_Ty), alignof(_Ty)));
+		}
+
+		/// Makes all the memory reusable. Blocks are kept, pointers given before become invalid.
+		void Reset();
+
+		/// Resets the arena and returns its blocks to the heap.
+		void Release();
+
+		/// Returns number of bytes allocated since the last reset (without alignment padding).
+		FORCEINLINE SIZE_T GetUsedSize() const { return UsedSize; }
+
+		/// Returns number of bytes of all the blocks and of the initial buffer.
+		SIZE_T GetReservedSize() const;
+
+	private:
+
+		/// Moves to the next kept block that fits the allocation or takes a new one from the heap.
+		void* AllocateInNextBlock(SIZE_T size, SIZE_T alignment);
+
+	private:
+
+		struct Block
+		{
+			BYTE*	Data;
+			SIZE_T	Size;
+		};
+
+		/// Blocks taken from the heap, in order of use
+		std::vector<Block> Blocks;
+
+		Span<BYTE> InitialBuffer;
+
+		SIZE_T BlockSize;
+
+		/// Index of the first block that has not been used since the last reset
+		SIZE_T NextBlock;
+
+		/// Free part of the current block
+		BYTE* Current;
+
+		BYTE* End;
+
+		SIZE_T UsedSize;
+
+	};
+
+} }
+
+
+#endif
@@ -0,0 +1,412 @@
+#include "PlatformFile.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <cerrno>
+
+#if defined(REAL_PLATFORM_WINDOWS)
+#include <io.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(REAL_PLATFORM_LINUX)
+#include <sys/sendfile.h>
+#endif
+
+
+
+namespace Real { namespace System {
+
+	namespace Private
+	{
+
+		/// Upper bound for a single system call (CRT functions on Windows take unsigned int counts)
+		constexpr uint64 MaxSingleIOSize = 1u << 30;
+
+#if defined(REAL_PLATFORM_WINDOWS)
+		/// CRT has no positional io, a seek and the following call must not be split by another thread
+		std::mutex PositionalIOMutex;
+#endif
+
+		/// Plain user space copying loop. Used when kernel-side copying is not supported.
+		uint64 TransferWithBuffer(PlatformFile& from, PlatformFile& to, uint64 count, BYTE* buffer, SIZE_T buffer_size)
+		{
+			uint64 transferred = 0;
+
+			while (transferred < count)
+			{
+				const uint64 chunk = std::min<uint64>(count - transferred, buffer_size);
+				const int64 received = from.Read(buffer, chunk);
+
+				if (received <= 0 || !to.WriteAll(buffer, received))
+					break;
+
+				transferred += received;
+			}
+
+			return transferred;
+		}
+
+#if defined(REAL_PLATFORM_LINUX)
+
+		/// Checks if the error only means that this kind of kernel copying cannot be used for given descriptors
+		FORCEINLINE bool IsUnsupportedTransfer(int error)
+		{
+			return error == EINVAL || error == EXDEV || error == ENOSYS || error == EOPNOTSUPP || error == EBADF || error == ESPIPE;
+		}
+
+		/**
+		 * Tries to move the content with one of the kernel-side primitives.
+		 * Stops at the first primitive that managed to move anything. bIsUnsupported is set only if none of them
+		 * can move this pair of files, end of file and hard errors (ENOSPC, EIO) leave it false.
+		 */
+		uint64 TransferInKernel(PlatformFile& from, PlatformFile& to, uint64 count, bool& bIsUnsupported)
+		{
+			uint64 transferred = 0;
+			ssize_t moved = 0;
+
+			bIsUnsupported = false;
+
+			// file -> file, may even be served by reflinks / server-side copy
+			while (transferred < count && (moved = ::copy_file_range(from.GetHandle(), nullptr, to.GetHandle(), nullptr, std::min(count - transferred, MaxSingleIOSize), 0)) > 0)
+				transferred += moved;
+
+			if (transferred == count || moved == 0 || !IsUnsupportedTransfer(errno))
+				return transferred;
+
+			// file -> anything (sockets, pipes since 5.12, regular files since 2.6.33)
+			while (transferred < count && (moved = ::sendfile(to.GetHandle(), from.GetHandle(), nullptr, std::min(count - transferred, MaxSingleIOSize))) > 0)
+				transferred += moved;
+
+			if (transferred == count || moved == 0 || !IsUnsupportedTransfer(errno))
+				return transferred;
+
+			// pipe on one of the sides (e.g. output redirected to another process)
+			while (transferred < count && (moved = ::splice(from.GetHandle(), nullptr, to.GetHandle(), nullptr, std::min(count - transferred, MaxSingleIOSize), SPLICE_F_MOVE | SPLICE_F_MORE)) > 0)
+				transferred += moved;
+
+			bIsUnsupported = transferred < count && moved < 0 && IsUnsupportedTransfer(errno);
+			return transferred;
+		}
+
+#endif
+
+	}
+
+
+	/// Opens an existing file for reading. Returns false on failure.
+	bool PlatformFile::OpenRead(const TCHAR* path)
+	{
+		Close();
+#if defined(REAL_PLATFORM_WINDOWS)
+		Handle = ::_open(path, _O_RDONLY | _O_BINARY | _O_SEQUENTIAL);
+#else
+		Handle = ::open(path, O_RDONLY | O_CLOEXEC);
+#endif
+		bOwnsHandle = IsOpen();
+		return IsOpen();
+	}
+
+	/// Creates (or truncates) a file for writing. Returns false on failure.
+	bool PlatformFile::OpenWrite(const TCHAR* path)
+	{
+		Close();
+#if defined(REAL_PLATFORM_WINDOWS)
+		Handle = ::_open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY | _O_SEQUENTIAL, _S_IREAD | _S_IWRITE);
+#else
+		Handle = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif
+		bOwnsHandle = IsOpen();
+		return IsOpen();
+	}
+
+	/// Closes owned descriptor.
+	void PlatformFile::Close()
+	{
+		if (IsOpen() && bOwnsHandle)
+		{
+#if defined(REAL_PLATFORM_WINDOWS)
+			::_close(Handle);
+#else
+			::close(Handle);
+#endif
+		}
+
+		Handle = INVALID_HANDLE;
+		bOwnsHandle = false;
+	}
+
+	/// Returns size of a regular file (taken from fstat) or -1 if the size is unknown.
+	int64 PlatformFile::Size() const
+	{
+#if defined(REAL_PLATFORM_WINDOWS)
+		struct _stat64 info;
+		if (::_fstat64(Handle, &info) != 0 || (info.st_mode & _S_IFREG) == 0)
+			return -1;
+#else
+		struct stat info;
+		if (::fstat(Handle, &info) != 0 || !S_ISREG(info.st_mode))
+			return -1;
+#endif
+		return static_cast<int64>(info.st_size);
+	}
+
+	/**
+	 * Reads up to count bytes. Interrupted calls are restarted.
+	 *
+	 * \return number of bytes read, 0 at the end of file, -1 on failure
+	 */
+	int64 PlatformFile::Read(void* destination, uint64 count)
+	{
+		count = std::min(count, Private::MaxSingleIOSize);
+
+		for (;;)
+		{
+#if defined(REAL_PLATFORM_WINDOWS)
+			const int64 received = ::_read(Handle, destination, static_cast<uint32>(count));
+#else
+			const int64 received = ::read(Handle, destination, count);
+#endif
+			if (received >= 0 || errno != EINTR)
+				return received;
+		}
+	}
+
+	/**
+	 * Same as Read, but reads at the given offset without moving file position (pread).
+	 * Allows several threads to read different parts of one file.
+	 *
+	 * \return number of bytes read, 0 at the end of file, -1 on failure
+	 */
+	int64 PlatformFile::ReadAt(void* destination, uint64 count, uint64 offset)
+	{
+		count = std::min(count, Private::MaxSingleIOSize);
+
+#if defined(REAL_PLATFORM_WINDOWS)
+		std::lock_guard<std::mutex> lock(Private::PositionalIOMutex);
+
+		if (::_lseeki64(Handle, offset, SEEK_SET) < 0)
+			return -1;
+#endif
+
+		for (;;)
+		{
+#if defined(REAL_PLATFORM_WINDOWS)
+			const int64 received = ::_read(Handle, destination, static_cast<uint32>(count));
+#else
+			const int64 received = ::pread(Handle, destination, count, offset);
+#endif
+			if (received >= 0 || errno != EINTR)
+				return received;
+		}
+	}
+
+	/**
+	 * Writes exactly count bytes.
+	 *
+	 * \return false if not all the bytes could be written
+	 */
+	bool PlatformFile::WriteAll(const void* source, uint64 count)
+	{
+		const BYTE* current = static_cast<const BYTE*>(source);
+
+		while (count > 0)
+		{
+			const uint64 chunk = std::min(count, Private::MaxSingleIOSize);
+#if defined(REAL_PLATFORM_WINDOWS)
+			const int64 written = ::_write(Handle, current, static_cast<uint32>(chunk));
+#else
+			const int64 written = ::write(Handle, current, chunk);
+#endif
+			if (written < 0)
+			{
+				if (errno == EINTR) continue;
+				return false;
+			}
+
+			current += written;
+			count -= written;
+		}
+
+		return true;
+	}
+
+	namespace Private
+	{
+		/// Skips fully written vectors and shrinks the partially written one. Returns number of vectors left.
+		int32 AdvanceVectors(IOVector*& vectors, int32 count, uint64 written)
+		{
+			while (count > 0 && written >= vectors->iov_len)
+			{
+				written -= vectors->iov_len;
+				++vectors;
+				--count;
+			}
+
+			if (count > 0)
+			{
+				vectors->iov_base = static_cast<BYTE*>(vectors->iov_base) + written;
+				vectors->iov_len -= written;
+			}
+
+			return count;
+		}
+	}
+
+	/**
+	 * Writes all the buffers one after another with as few system calls as possible (writev).
+	 * Partial writes are continued, vectors array is modified in the process.
+	 *
+	 * \param vectors	buffers to write
+	 * \param count		number of buffers
+	 *
+	 * \return false if not all the bytes could be written
+	 */
+	bool PlatformFile::WriteVectors(IOVector* vectors, int32 count)
+	{
+#if defined(REAL_PLATFORM_WINDOWS)
+		for (int32 i = 0; i < count; ++i)
+		{
+			if (!WriteAll(vectors[i].iov_base, vectors[i].iov_len))
+				return false;
+		}
+		return true;
+#else
+		count = Private::AdvanceVectors(vectors, count, 0);
+
+		while (count > 0)
+		{
+			const ssize_t written = ::writev(Handle, vectors, count);
+
+			if (written < 0)
+			{
+				if (errno == EINTR) continue;
+				return false;
+			}
+
+			count = Private::AdvanceVectors(vectors, count, written);
+		}
+
+		return true;
+#endif
+	}
+
+	/**
+	 * Same as WriteVectors, but writes at the given offset without moving file position (pwritev).
+	 * Allows several threads to write different parts of one file (emulated with a seek under a lock on Windows).
+	 */
+	bool PlatformFile::WriteVectorsAt(IOVector* vectors, int32 count, uint64 offset)
+	{
+#if defined(REAL_PLATFORM_WINDOWS)
+		std::lock_guard<std::mutex> lock(Private::PositionalIOMutex);
+
+		if (::_lseeki64(Handle, offset, SEEK_SET) < 0)
+			return false;
+		return WriteVectors(vectors, count);
+#else
+		count = Private::AdvanceVectors(vectors, count, 0);
+
+		while (count > 0)
+		{
+			const ssize_t written = ::pwritev(Handle, vectors, count, offset);
+
+			if (written < 0)
+			{
+				if (errno == EINTR) continue;
+				return false;
+			}
+
+			offset += written;
+			count = Private::AdvanceVectors(vectors, count, written);
+		}
+
+		return true;
+#endif
+	}
+
+	/// Returns non-owning object referring to the standard input.
+	PlatformFile PlatformFile::StdIn()
+	{
+#if defined(REAL_PLATFORM_WINDOWS)
+		::_setmode(0, _O_BINARY);
+#endif
+		return PlatformFile(0);
+	}
+
+	/// Returns non-owning object referring to the standard output.
+	PlatformFile PlatformFile::StdOut()
+	{
+#if defined(REAL_PLATFORM_WINDOWS)
+		::_setmode(1, _O_BINARY);
+#endif
+		return PlatformFile(1);
+	}
+
+
+	/**
+	 * Moves count bytes from the current position of one file to the current position of another.
+	 * Tries kernel-side copying first (copy_file_range, sendfile, splice) so that the content never
+	 * reaches user space and falls back to a large buffer read/write loop only if none of them is supported.
+	 *
+	 * \param from	source file
+	 * \param to	destination file
+	 * \param count	number of bytes to move
+	 *
+	 * \return number of bytes moved, less than count on failure or unexpected end of file
+	 */
+	uint64 TransferFileContent(PlatformFile& from, PlatformFile& to, uint64 count)
+	{
+		uint64 transferred = 0;
+		bool bIsUnsupported = true;
+
+#if defined(REAL_PLATFORM_LINUX)
+		transferred = Private::TransferInKernel(from, to, count, bIsUnsupported);
+#endif
+
+		// end of file and write errors of the kernel path are final, the buffer loop would only repeat them
+		if (transferred < count && bIsUnsupported)
+		{
+			std::unique_ptr<BYTE[]> buffer(new BYTE[PlatformFile::CopyBufferSize]);
+			transferred += Private::TransferWithBuffer(from, to, count - transferred, buffer.get(), PlatformFile::CopyBufferSize);
+		}
+
+		return transferred;
+	}
+
+	/**
+	 * Same as TransferFileContent, but the fallback loop copies through the caller's buffer instead of allocating one,
+	 * so a thread moving many files reuses the same memory.
+	 *
+	 * \param from			source file
+	 * \param to			destination file
+	 * \param count			number of bytes to move
+	 * \param buffer		buffer for user space copying
+	 * \param buffer_size	size of the buffer
+	 *
+	 * \return number of bytes moved, less than count on failure or unexpected end of file
+	 */
+	uint64 TransferFileContent(PlatformFile& from, PlatformFile& to, uint64 count, BYTE* buffer, SIZE_T buffer_size)
+	{
+		uint64 transferred = 0;
+		bool bIsUnsupported = true;
+
+#if defined(REAL_PLATFORM_LINUX)
+		transferred = Private::TransferInKernel(from, to, count, bIsUnsupported);
+#endif
+
+		if (transferred < count && bIsUnsupported)
+			transferred += Private::TransferWithBuffer(from, to, count - transferred, buffer, buffer_size);
+
+		return transferred;
+	}
+
+
+} }
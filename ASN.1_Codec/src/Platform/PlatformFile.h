@@ -0,0 +1,180 @@
+#ifndef __REAL_PLATFORM_FILE__
+#define __REAL_PLATFORM_FILE__
+
+#include "../Core.h"
+
+#if !defined(REAL_PLATFORM_WINDOWS)
+#include <sys/uio.h>
+#endif
+
+
+namespace Real { namespace System {
+
+
+#if defined(REAL_PLATFORM_WINDOWS)
+	/// Buffer description for scatter-gather output. Same layout as POSIX iovec.
+	struct IOVector
+	{
+		void*	iov_base;
+		SIZE_T	iov_len;
+	};
+#else
+	/// Buffer description for scatter-gather output.
+	typedef ::iovec IOVector;
+#endif
+
+
+	/**
+	 * Thin wrapper around a native file descriptor.
+	 * Used where iostreams are too slow or hide the descriptor (kernel-side copying, scatter-gather output, etc).
+	 */
+	class PlatformFile
+	{
+	public:
+
+		typedef int32 HANDLE_TYPE;
+
+		/// Value of a handle that does not refer to any file
+		static constexpr HANDLE_TYPE INVALID_HANDLE = -1;
+
+		/// Size of a buffer used by user space copying loops
+		static constexpr SIZE_T CopyBufferSize = 1 << 20;
+
+	public:
+
+		PlatformFile() : Handle(INVALID_HANDLE), bOwnsHandle(false) { }
+
+		/**
+		 * Wraps an already opened descriptor.
+		 *
+		 * \param handle		native descriptor
+		 * \param bTakeOwnership	if true the descriptor will be closed in destructor
+		 */
+		explicit PlatformFile(HANDLE_TYPE handle, bool bTakeOwnership = false) : Handle(handle), bOwnsHandle(bTakeOwnership) { }
+
+		PlatformFile(const PlatformFile&) = delete;
+		PlatformFile& operator = (const PlatformFile&) = delete;
+
+		PlatformFile(PlatformFile&& other) NOEXCEPT : Handle(other.Handle), bOwnsHandle(other.bOwnsHandle)
+		{
+			other.Handle = INVALID_HANDLE;
+			other.bOwnsHandle = false;
+		}
+
+		PlatformFile& operator = (PlatformFile&& other) NOEXCEPT
+		{
+			if (this != &other)
+			{
+				Close();
+				std::swap(Handle, other.Handle);
+				std::swap(bOwnsHandle, other.bOwnsHandle);
+			}
+			return *this;
+		}
+
+		~PlatformFile() { Close(); }
+
+		/// Opens an existing file for reading. Returns false on failure.
+		bool OpenRead(const TCHAR* path);
+
+		/// Creates (or truncates) a file for writing. Returns false on failure.
+		bool OpenWrite(const TCHAR* path);
+
+		/// Closes owned descriptor.
+		void Close();
+
+		/// Checks if this object refers to a valid descriptor.
+		FORCEINLINE bool IsOpen() const { return Handle != INVALID_HANDLE; }
+
+		/// Returns native descriptor.
+		FORCEINLINE HANDLE_TYPE GetHandle() const { return Handle; }
+
+		/// Returns size of a regular file (taken from fstat) or -1 if the size is unknown.
+		int64 Size() const;
+
+		/**
+		 * Reads up to count bytes. Interrupted calls are restarted.
+		 *
+		 * \return number of bytes read, 0 at the end of file, -1 on failure
+		 */
+		int64 Read(void* destination, uint64 count);
+
+		/**
+		 * Same as Read, but reads at the given offset without moving file position (pread).
+		 * Allows several threads to read different parts of one file.
+		 *
+		 * \return number of bytes read, 0 at the end of file, -1 on failure
+		 */
+		int64 ReadAt(void* destination, uint64 count, uint64 offset);
+
+		/**
+		 * Writes exactly count bytes.
+		 *
+		 * \return false if not all the bytes could be written
+		 */
+		bool WriteAll(const void* source, uint64 count);
+
+		/**
+		 * Writes all the buffers one after another with as few system calls as possible (writev).
+		 * Partial writes are continued, vectors array is modified in the process.
+		 *
+		 * \param vectors	buffers to write
+		 * \param count		number of buffers
+		 *
+		 * \return false if not all the bytes could be written
+		 */
+		bool WriteVectors(IOVector* vectors, int32 count);
+
+		/**
+		 * Same as WriteVectors, but writes at the given offset without moving file position (pwritev).
+		 * Allows several threads to write different parts of one file (emulated with a seek under a lock on Windows).
+		 */
+		bool WriteVectorsAt(IOVector* vectors, int32 count, uint64 offset);
+
+		/// Returns non-owning object referring to the standard input.
+		static PlatformFile StdIn();
+
+		/// Returns non-owning object referring to the standard output.
+		static PlatformFile StdOut();
+
+	private:
+
+		HANDLE_TYPE Handle;
+
+		bool bOwnsHandle;
+
+	};
+
+
+	/**
+	 * Moves count bytes from the current position of one file to the current position of another.
+	 * Tries kernel-side copying first (copy_file_range, sendfile, splice) so that the content never
+	 * reaches user space and falls back to a large buffer read/write loop if none of them is supported.
+	 *
+	 * \param from	source file
+	 * \param to	destination file
+	 * \param count	number of bytes to move
+	 *
+	 * \return number of bytes moved, less than count on failure or unexpected end of file
+	 */
+	uint64 TransferFileContent(PlatformFile& from, PlatformFile& to, uint64 count);
+
+	/**
+	 * Same as TransferFileContent, but the fallback loop copies through the caller's buffer instead of allocating one,
+	 * so a thread moving many files reuses the same memory.
+	 *
+	 * \param from			source file
+	 * \param to			destination file
+	 * \param count			number of bytes to move
+	 * \param buffer		buffer for user space copying
+	 * \param buffer_size	size of the buffer
+	 *
+	 * \return number of bytes moved, less than count on failure or unexpected end of file
+	 */
+	uint64 TransferFileContent(PlatformFile& from, PlatformFile& to, uint64 count, BYTE* buffer, SIZE_T buffer_size);
+
+
+} }
+
+
+#endif
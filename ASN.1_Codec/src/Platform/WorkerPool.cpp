@@ -0,0 +1,93 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+
+
+namespace Real { namespace System {
+
+
+	/**
+	 * Starts the workers.
+	 *
+	 * \param worker_count number of threads, 0 means one per hardware thread
+	 */
+	WorkerPool::WorkerPool(uint32 worker_count)
+		: Job(nullptr), JobCount(0), NextJob(0), Batch(0), BusyWorkers(0), bIsStopping(false)
+	{
+		if (worker_count == 0)
+			worker_count = std::max(1u, std::thread::hardware_concurrency());
+
+		Workers.reserve(worker_count);
+
+		for (uint32 i = 0; i < worker_count; ++i)
+			Workers.emplace_back(&WorkerPool::WorkerLoop, this, i);
+	}
+
+	/// Stops and joins the workers.
+	WorkerPool::~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			bIsStopping = true;
+		}
+
+		BatchStarted.notify_all();
+
+		for (std::thread& worker : Workers)
+			worker.join();
+	}
+
+	/**
+	 * Runs job for every index from 0 to job_count - 1 and waits until all of them are done.
+	 * The job must not throw, every worker index is used by one thread at a time, so per-worker state needs no locks.
+	 *
+	 * \param job_count	number of jobs
+	 * \param job		job body
+	 */
+	void WorkerPool::Run(uint64 job_count, const JOB_FUNCTION& job)
+	{
+		std::unique_lock<std::mutex> lock(Mutex);
+
+		Job = &job;
+		JobCount = job_count;
+		NextJob.store(0, std::memory_order_relaxed);
+		BusyWorkers = GetWorkerCount();
+		++Batch;
+
+		BatchStarted.notify_all();
+		BatchFinished.wait(lock, [this] { return BusyWorkers == 0; });
+
+		Job = nullptr;
+	}
+
+	void WorkerPool::WorkerLoop(uint32 worker_index)
+	{
+		uint64 last_batch = 0;
+
+		for (;;)
+		{
+			std::unique_lock<std::mutex> lock(Mutex);
+			BatchStarted.wait(lock, [this, last_batch] { return bIsStopping || Batch != last_batch; });
+
+			if (bIsStopping)
+				return;
+
+			last_batch = Batch;
+			const JOB_FUNCTION& job = *Job;
+			const uint64 job_count = JobCount;
+
+			lock.unlock();
+
+			for (uint64 index = NextJob.fetch_add(1, std::memory_order_relaxed); index < job_count; index = NextJob.fetch_add(1, std::memory_order_relaxed))
+				job(worker_index, index);
+
+			lock.lock();
+
+			if (--BusyWorkers == 0)
+				BatchFinished.notify_one();
+		}
+	}
+
+
+} }
@@ -0,0 +1,91 @@
+#ifndef __REAL_WORKER_POOL__
+#define __REAL_WORKER_POOL__
+
+#include "../Core.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace Real { namespace System {
+
+
+	/**
+	 * Fixed number of threads started once and reused for every batch of jobs.
+	 * Jobs of a batch are numbered, idle workers take the next number from a shared counter,
+	 * so there is no queue to lock and long jobs do not hold back the short ones.
+	 */
+	class WorkerPool
+	{
+	public:
+
+		/// Job body: index of the worker running it (0 to GetWorkerCount() - 1) and index of the job.
+		typedef std::function<void(uint32 worker_index, uint64 job_index)> JOB_FUNCTION;
+
+	public:
+
+		/**
+		 * Starts the workers.
+		 *
+		 * \param worker_count number of threads, 0 means one per hardware thread
+		 */
+		explicit WorkerPool(uint32 worker_count = 0);
+
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator = (const WorkerPool&) = delete;
+
+		/// Stops and joins the workers.
+		~WorkerPool();
+
+		/// Returns number of threads.
+		FORCEINLINE uint32 GetWorkerCount() const { return static_cast<uint32>(Workers.size()); }
+
+		/**
+		 * Runs job for every index from 0 to job_count - 1 and waits until all of them are done.
+		 * The job must not throw, every worker index is used by one thread at a time, so per-worker state needs no locks.
+		 *
+		 * \param job_count	number of jobs
+		 * \param job		job body
+		 */
+		void Run(uint64 job_count, const JOB_FUNCTION& job);
+
+	private:
+
+		void WorkerLoop(uint32 worker_index);
+
+	private:
+
+		std::vector<std::thread> Workers;
+
+		std::mutex Mutex;
+
+		/// Signals a new batch or stopping to the workers
+		std::condition_variable BatchStarted;
+
+		/// Signals the end of a batch to Run
+		std::condition_variable BatchFinished;
+
+		const JOB_FUNCTION* Job;
+
+		uint64 JobCount;
+
+		std::atomic<uint64> NextJob;
+
+		/// Number of the current batch, workers compare it with the last one they ran
+		uint64 Batch;
+
+		/// Workers that have not finished the current batch yet
+		uint32 BusyWorkers;
+
+		bool bIsStopping;
+
+	};
+
+
+} }
+
+
+#endif
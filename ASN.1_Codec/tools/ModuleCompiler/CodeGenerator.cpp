@@ -0,0 +1,531 @@
+#include "CodeGenerator.h"
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <set>
+
+
+
+namespace Real { namespace Tools {
+
+	using namespace Codecs::ASN1CodecOptions;
+
+	namespace Private
+	{
+		const std::set<std::string> CppKeywords =
+		{
+			"alignas", "alignof", "and", "asm", "auto", "bool", "break", "case", "catch", "char", "class", "const",
+			"constexpr", "continue", "decltype", "default", "delete", "do", "double", "else", "enum", "explicit",
+			"export", "extern", "false", "float", "for", "friend", "goto", "if", "inline", "int", "long", "mutable",
+			"namespace", "new", "noexcept", "not", "nullptr", "operator", "or", "private", "protected", "public",
+			"register", "return", "short", "signed", "sizeof", "static", "struct", "switch", "template", "this",
+			"throw", "true", "try", "typedef", "typeid", "typename", "union", "unsigned", "using", "virtual", "void",
+			"volatile", "while", "xor",
+		};
+
+		const TCHAR* GetClassName(EASN1ClassTagType class_type)
+		{
+			switch (class_type)
+			{
+			case EASN1ClassTagType::UNIVERSAL:
+				return "ASN1Class::UNIVERSAL";
+			case EASN1ClassTagType::APPLICATION:
+				return "ASN1Class::APPLICATION";
+			case EASN1ClassTagType::PRIVATE:
+				return "ASN1Class::PRIVATE";
+			default:
+				return "ASN1Class::CONTEXT_SPECIFIC";
+			}
+		}
+	}
+
+	/**
+	 * Generates the header. Throws generation_error.
+	 *
+	 * \param module		parsed module
+	 * \param name_space	namespace of the generated code
+	 * \param include_path	path the header uses to include Codecs/ASN1_Generated.hpp
+	 *
+	 * \return header text
+	 */
+	std::string CodeGenerator::Generate(ASN1Module module, const std::string& name_space, const std::string& include_path)
+	{
+		CodeGenerator generator(std::move(module));
+
+		generator.HoistInlineTypes();
+		generator.ResolveTags();
+		generator.SortAssignments();
+
+		std::string guard = "__GENERATED_" + MakeIdentifier(generator.Module.Name) + "__";
+		std::transform(guard.begin(), guard.end(), guard.begin(), [](char c) { return static_cast<char>(std::toupper(static_cast<unsigned char>(c))); });
+
+		std::ostringstream& out = generator.Output;
+
+		out << "// Generated by ModuleCompiler from ASN.1 module " << generator.Module.Name << ". Do not edit.\n";
+		out << "#ifndef " << guard << "\n";
+		out << "#define " << guard << "\n\n";
+		out << "#include \"" << include_path << "\"\n\n\n";
+		out << "namespace " << name_space << " {\n\n";
+		out << "\tnamespace ASN1Runtime = ::Real::Codecs::ASN1Generated;\n";
+		out << "\ttypedef ::Real::Codecs::ASN1CodecOptions::EASN1ClassTagType ASN1Class;\n\n";
+
+		for (const ASN1Assignment& assignment : generator.Module.Assignments)
+			generator.EmitAssignment(assignment);
+
+		out << "\n}\n\n\n";
+		out << "#endif\n";
+
+		return out.str();
+	}
+
+	/// Turns an ASN.1 name into a C++ identifier.
+	std::string CodeGenerator::MakeIdentifier(const std::string& name)
+	{
+		std::string identifier = name;
+		std::replace(identifier.begin(), identifier.end(), '-', '_');
+
+		if (Private::CppKeywords.count(identifier))
+			identifier += '_';
+
+		return identifier;
+	}
+
+	/// Moves inline SEQUENCE, CHOICE and ENUMERATED types into their own assignments.
+	void CodeGenerator::HoistInlineTypes()
+	{
+		std::vector<ASN1Assignment> assignments;
+
+		for (ASN1Assignment& assignment : Module.Assignments)
+		{
+			std::vector<ASN1Assignment> hoisted;
+			ASN1Type& type = *assignment.Type;
+
+			for (ASN1Component& component : type.Components)
+				Hoist(component.Type, assignment.Name + "_" + component.Name, hoisted);
+
+			if (type.Kind == EASN1TypeKind::SequenceOf)
+				Hoist(type.Element, assignment.Name + "_Item", hoisted);
+
+			// hoisted types go first, their own inline types were hoisted in front of them
+			for (ASN1Assignment& inner : hoisted)
+				assignments.push_back(std::move(inner));
+
+			assignments.push_back(std::move(assignment));
+		}
+
+		Module.Assignments = std::move(assignments);
+	}
+
+	/// Replaces an inline type with a reference to a new assignment named name.
+	void CodeGenerator::Hoist(std::shared_ptr<ASN1Type>& type, const std::string& name, std::vector<ASN1Assignment>& hoisted)
+	{
+		if (type->Kind == EASN1TypeKind::SequenceOf)
+		{
+			if (type->Element->Tag.bIsPresent)
+				throw generation_error(name + ": tagged SEQUENCE OF elements are not supported");
+
+			Hoist(type->Element, name + "_Item", hoisted);
+			return;
+		}
+
+		if (type->Kind != EASN1TypeKind::Sequence && type->Kind != EASN1TypeKind::Choice && type->Kind != EASN1TypeKind::Enumerated)
+			return;
+
+		auto reference = std::make_shared<ASN1Type>();
+		reference->Kind = EASN1TypeKind::Reference;
+		reference->Reference = name;
+
+		// the tag belongs to the component, not to the new type
+		std::swap(reference->Tag, type->Tag);
+
+		ASN1Assignment assignment{ name, type };
+
+		for (ASN1Component& component : assignment.Type->Components)
+			Hoist(component.Type, name + "_" + component.Name, hoisted);
+
+		hoisted.push_back(std::move(assignment));
+		type = reference;
+	}
+
+	/// Applies the tagging mode of the module to every tag and checks tags the runtime cannot express.
+	void CodeGenerator::ResolveTags()
+	{
+		const bool bIsExplicitByDefault = Module.TaggingMode == EASN1TaggingMode::EXPLICIT;
+
+		for (ASN1Assignment& assignment : Module.Assignments)
+		{
+			ASN1Type& type = *assignment.Type;
+
+			if (type.Tag.bIsPresent)
+			{
+				if (type.Kind != EASN1TypeKind::Sequence)
+					throw generation_error(assignment.Name + ": tags on assignments are supported for SEQUENCE only");
+
+				if (type.Tag.bHasMode ? type.Tag.bIsExplicit : bIsExplicitByDefault)
+					throw generation_error(assignment.Name + ": EXPLICIT tags on assignments are not supported, use IMPLICIT");
+			}
+
+			if (type.Kind == EASN1TypeKind::Reference && !FindAssignment(type.Reference))
+				throw generation_error(assignment.Name + ": unknown type " + type.Reference);
+
+			for (const ASN1Type* element = type.Element.get(); element; element = element->Element.get())
+			{
+				if (element->Tag.bIsPresent)
+					throw generation_error(assignment.Name + ": tagged SEQUENCE OF elements are not supported");
+
+				if (element->Kind == EASN1TypeKind::Reference && !FindAssignment(element->Reference))
+					throw generation_error(assignment.Name + ": unknown type " + element->Reference);
+			}
+
+			const bool bHasTaggedComponent = std::any_of(type.Components.begin(), type.Components.end(), [](const ASN1Component& component) { return component.Type->Tag.bIsPresent; });
+			uint64 automatic_tag = 0;
+
+			for (ASN1Component& component : type.Components)
+			{
+				ASN1Tag& tag = component.Type->Tag;
+
+				for (const ASN1Type* inner = component.Type.get(); inner; inner = inner->Element.get())
+				{
+					if (inner != component.Type.get() && inner->Tag.bIsPresent)
+						throw generation_error(assignment.Name + "." + component.Name + ": tagged SEQUENCE OF elements are not supported");
+
+					if (inner->Kind == EASN1TypeKind::Reference && !FindAssignment(inner->Reference))
+						throw generation_error(assignment.Name + "." + component.Name + ": unknown type " + inner->Reference);
+				}
+
+				if (Module.TaggingMode == EASN1TaggingMode::AUTOMATIC && !bHasTaggedComponent)
+				{
+					tag.bIsPresent = true;
+					tag.Class = EASN1ClassTagType::CONTEXT_SPECIFIC;
+					tag.Number = automatic_tag++;
+				}
+
+				if (!tag.bIsPresent)
+					continue;
+
+				if (!tag.bHasMode)
+					tag.bIsExplicit = bIsExplicitByDefault;
+
+				if (tag.bHasMode && !tag.bIsExplicit && IsChoice(*component.Type))
+					throw generation_error(assignment.Name + "." + component.Name + ": CHOICE cannot be tagged IMPLICIT");
+			}
+		}
+	}
+
+	/// Orders assignments so that every type is defined before it is used.
+	void CodeGenerator::SortAssignments()
+	{
+		std::vector<ASN1Assignment> sorted;
+		std::map<std::string, uint8> states;	// 1 - being visited, 2 - emitted
+
+		std::function<void(const ASN1Assignment&)> visit = [&](const ASN1Assignment& assignment)
+		{
+			uint8& state = states[assignment.Name];
+
+			if (state == 2)
+				return;
+
+			if (state == 1)
+				throw generation_error(assignment.Name + ": recursive types are not supported");
+
+			state = 1;
+
+			std::vector<const ASN1Type*> used = { assignment.Type.get() };
+
+			for (const ASN1Component& component : assignment.Type->Components)
+				used.push_back(component.Type.get());
+
+			for (const ASN1Type* type : used)
+			{
+				for (; type; type = type->Element.get())
+				{
+					if (type->Kind == EASN1TypeKind::Reference)
+						visit(*FindAssignment(type->Reference));
+				}
+			}
+
+			states[assignment.Name] = 2;
+			sorted.push_back(assignment);
+		};
+
+		for (const ASN1Assignment& assignment : Module.Assignments)
+			visit(assignment);
+
+		Module.Assignments = std::move(sorted);
+	}
+
+	void CodeGenerator::EmitAssignment(const ASN1Assignment& assignment)
+	{
+		const std::string name = MakeIdentifier(assignment.Name);
+		const ASN1Type& type = *assignment.Type;
+
+		switch (type.Kind)
+		{
+		case EASN1TypeKind::Sequence:
+			EmitSequence(name, type);
+			break;
+
+		case EASN1TypeKind::Choice:
+			EmitChoice(name, type);
+			break;
+
+		case EASN1TypeKind::Enumerated:
+		{
+			Output << "\t/// " << assignment.Name << " ::= ENUMERATED\n";
+			Output << "\tenum class " << name << " : int64\n\t{\n";
+
+			for (const ASN1EnumItem& item : type.Items)
+				Output << "\t\t" << MakeIdentifier(item.Name) << " = " << item.Value << ",\n";
+
+			Output << "\t};\n\n";
+			break;
+		}
+
+		default:
+			Output << "\t/// " << assignment.Name << "\n";
+			Output << "\ttypedef " << GetCppType(type) << " " << name << ";\n\n";
+			break;
+		}
+	}
+
+	void CodeGenerator::EmitSequence(const std::string& name, const ASN1Type& type)
+	{
+		const std::string class_name = type.Tag.bIsPresent ? Private::GetClassName(type.Tag.Class) : "ASN1Class::UNIVERSAL";
+		const uint64 tag_number = type.Tag.bIsPresent ? type.Tag.Number : static_cast<uint64>(EASN1ValueType::Sequence);
+
+		Output << "\t/// " << name << " ::= SEQUENCE\n";
+		Output << "\tstruct " << name << "\n\t{\n";
+		Output << "\t\tstatic constexpr ASN1Class Class = " << class_name << ";\n";
+		Output << "\t\tstatic constexpr uint64 Tag = " << tag_number << ";\n";
+		Output << "\t\tstatic constexpr bool bIsChoice = false;\n\n";
+
+		for (const ASN1Component& component : type.Components)
+		{
+			const std::string cpp_type = GetCppType(*component.Type);
+
+			if (component.bIsOptional)
+				Output << "\t\tstd::optional<" << cpp_type << "> " << MakeIdentifier(component.Name) << ";\n";
+			else
+				Output << "\t\t" << cpp_type << " " << MakeIdentifier(component.Name) << "{};\n";
+		}
+
+		// size
+		Output << "\n\t\tASN1Runtime::SIZE_TYPE GetContentSize() const\n\t\t{\n";
+		Output << "\t\t\tASN1Runtime::SIZE_TYPE size = 0;\n";
+
+		for (const ASN1Component& component : type.Components)
+		{
+			const std::string field = MakeIdentifier(component.Name);
+
+			if (component.bIsOptional)
+				Output << "\t\t\tif (" << field << ")\n\t\t\t\tsize += ASN1Runtime::GetEncodedSize<" << GetTagArguments(*component.Type) << ">(*" << field << ");\n";
+			else
+				Output << "\t\t\tsize += ASN1Runtime::GetEncodedSize<" << GetTagArguments(*component.Type) << ">(" << field << ");\n";
+		}
+
+		Output << "\t\t\treturn size;\n\t\t}\n";
+
+		// encoding, components are prepended last to first
+		Output << "\n\t\tvoid PrependContent(::Real::Codecs::ASN1ReverseWriter& writer) const\n\t\t{\n";
+
+		for (auto it = type.Components.rbegin(); it != type.Components.rend(); ++it)
+		{
+			const std::string field = MakeIdentifier(it->Name);
+
+			if (it->bIsOptional)
+				Output << "\t\t\tif (" << field << ")\n\t\t\t\tASN1Runtime::Prepend<" << GetTagArguments(*it->Type) << ">(writer, *" << field << ");\n";
+			else
+				Output << "\t\t\tASN1Runtime::Prepend<" << GetTagArguments(*it->Type) << ">(writer, " << field << ");\n";
+		}
+
+		Output << "\t\t}\n";
+
+		// decoding, components come in order, an optional one is present if the next token matches it
+		Output << "\n\t\tbool ReadContent(const ::Real::Codecs::ASN1DecodedToken& token)\n\t\t{\n";
+		Output << "\t\t\t::Real::Codecs::ASN1Reader reader(token, ASN1Runtime::Rules);\n";
+		Output << "\t\t\t::Real::Codecs::ASN1DecodedToken field;\n";
+		Output << "\t\t\tbool bHasField = reader.Next(field);\n";
+
+		for (const ASN1Component& component : type.Components)
+		{
+			const std::string field = MakeIdentifier(component.Name);
+			const std::string tag_arguments = GetTagArguments(*component.Type);
+			const std::string match_arguments = GetMatchArguments(*component.Type);
+
+			Output << "\n\t\t\t// " << component.Name << (component.bIsOptional ? " OPTIONAL" : "") << "\n";
+
+			if (component.bIsOptional)
+			{
+				Output << "\t\t\t" << field << ".reset();\n";
+				Output << "\t\t\tif (bHasField && ASN1Runtime::Matches<" << match_arguments << ">(field))\n\t\t\t{\n";
+				Output << "\t\t\t\tif (!ASN1Runtime::Read<" << tag_arguments << ">(field, " << field << ".emplace()))\n";
+				Output << "\t\t\t\t\treturn false;\n\n";
+				Output << "\t\t\t\tbHasField = reader.Next(field);\n";
+				Output << "\t\t\t}\n";
+			}
+			else
+			{
+				Output << "\t\t\tif (!bHasField || !ASN1Runtime::Matches<" << match_arguments << ">(field) || !ASN1Runtime::Read<" << tag_arguments << ">(field, " << field << "))\n";
+				Output << "\t\t\t\treturn false;\n\n";
+				Output << "\t\t\tbHasField = reader.Next(field);\n";
+			}
+		}
+
+		Output << "\n\t\t\treturn !bHasField && reader.GetStatus() == ::Real::Codecs::EASN1DecodeStatus::END;\n\t\t}\n";
+
+		Output << "\n\t\t/// Encodes the value into a buffer of the exact size.\n";
+		Output << "\t\tvoid Encode(std::vector<BYTE>& output) const { ASN1Runtime::Encode(*this, output); }\n";
+		Output << "\n\t\t/// Decodes a value. Returns false if the encoding is malformed.\n";
+		Output << "\t\tbool Decode(const void* data, ASN1Runtime::SIZE_TYPE size) { return ASN1Runtime::Decode(data, size, *this); }\n";
+		Output << "\t};\n\n";
+	}
+
+	void CodeGenerator::EmitChoice(const std::string& name, const ASN1Type& type)
+	{
+		Output << "\t/// " << name << " ::= CHOICE\n";
+		Output << "\tstruct " << name << "\n\t{\n";
+		Output << "\t\tstatic constexpr ASN1Class Class = ASN1Class::UNIVERSAL;\n";
+		Output << "\t\tstatic constexpr uint64 Tag = 0;\n";
+		Output << "\t\tstatic constexpr bool bIsChoice = true;\n\n";
+
+		Output << "\t\tenum class EChoice : uint8\n\t\t{\n\t\t\tNONE,\n";
+		for (const ASN1Component& component : type.Components)
+			Output << "\t\t\t" << MakeIdentifier(component.Name) << ",\n";
+		Output << "\t\t};\n\n";
+
+		Output << "\t\t/// Selected alternative\n";
+		Output << "\t\tEChoice Choice = EChoice::NONE;\n\n";
+
+		for (const ASN1Component& component : type.Components)
+			Output << "\t\t" << GetCppType(*component.Type) << " " << MakeIdentifier(component.Name) << "{};\n";
+
+		// size of the selected alternative with its header
+		Output << "\n\t\tASN1Runtime::SIZE_TYPE GetContentSize() const\n\t\t{\n\t\t\tswitch (Choice)\n\t\t\t{\n";
+
+		for (const ASN1Component& component : type.Components)
+		{
+			const std::string field = MakeIdentifier(component.Name);
+			Output << "\t\t\tcase EChoice::" << field << ":\n\t\t\t\treturn ASN1Runtime::GetEncodedSize<" << GetTagArguments(*component.Type) << ">(" << field << ");\n";
+		}
+
+		Output << "\t\t\tdefault:\n\t\t\t\treturn 0;\n\t\t\t}\n\t\t}\n";
+
+		// encoding of the selected alternative
+		Output << "\n\t\tvoid PrependContent(::Real::Codecs::ASN1ReverseWriter& writer) const\n\t\t{\n\t\t\tswitch (Choice)\n\t\t\t{\n";
+
+		for (const ASN1Component& component : type.Components)
+		{
+			const std::string field = MakeIdentifier(component.Name);
+			Output << "\t\t\tcase EChoice::" << field << ":\n\t\t\t\tASN1Runtime::Prepend<" << GetTagArguments(*component.Type) << ">(writer, " << field << ");\n\t\t\t\tbreak;\n";
+		}
+
+		Output << "\t\t\tdefault:\n\t\t\t\tthrow ::Real::Codecs::Codec::bad_sequence{};\n\t\t\t}\n\t\t}\n";
+
+		// matching of any alternative
+		Output << "\n\t\tstatic bool Matches(const ::Real::Codecs::ASN1DecodedToken& token)\n\t\t{\n\t\t\treturn";
+
+		for (SIZE_T i = 0; i < type.Components.size(); ++i)
+			Output << (i ? "\n\t\t\t\t|| " : " ") << "ASN1Runtime::Matches<" << GetMatchArguments(*type.Components[i].Type) << ">(token)";
+
+		Output << ";\n\t\t}\n";
+
+		// decoding of the alternative the token matches
+		Output << "\n\t\tbool ReadContent(const ::Real::Codecs::ASN1DecodedToken& token)\n\t\t{\n";
+
+		for (const ASN1Component& component : type.Components)
+		{
+			const std::string field = MakeIdentifier(component.Name);
+
+			Output << "\t\t\tif (ASN1Runtime::Matches<" << GetMatchArguments(*component.Type) << ">(token))\n\t\t\t{\n";
+			Output << "\t\t\t\tChoice = EChoice::" << field << ";\n";
+			Output << "\t\t\t\treturn ASN1Runtime::Read<" << GetTagArguments(*component.Type) << ">(token, " << field << ");\n";
+			Output << "\t\t\t}\n\n";
+		}
+
+		Output << "\t\t\treturn false;\n\t\t}\n";
+
+		Output << "\n\t\t/// Encodes the value into a buffer of the exact size.\n";
+		Output << "\t\tvoid Encode(std::vector<BYTE>& output) const { ASN1Runtime::Encode(*this, output); }\n";
+		Output << "\n\t\t/// Decodes a value. Returns false if the encoding is malformed.\n";
+		Output << "\t\tbool Decode(const void* data, ASN1Runtime::SIZE_TYPE size) { return ASN1Runtime::Decode(data, size, *this); }\n";
+		Output << "\t};\n\n";
+	}
+
+	/// Returns C++ type of a (hoisted) type.
+	std::string CodeGenerator::GetCppType(const ASN1Type& type) const
+	{
+		switch (type.Kind)
+		{
+		case EASN1TypeKind::Boolean:
+			return "bool";
+		case EASN1TypeKind::Integer:
+			return "int64";
+		case EASN1TypeKind::Real:
+			return "double";
+		case EASN1TypeKind::OctetString:
+			return "std::vector<BYTE>";
+		case EASN1TypeKind::BitString:
+			return "ASN1Runtime::BitString";
+		case EASN1TypeKind::Null:
+			return "ASN1Runtime::Null";
+		case EASN1TypeKind::ObjectIdentifier:
+			return "ASN1Runtime::ObjectIdentifier";
+		case EASN1TypeKind::SequenceOf:
+			return "std::vector<" + GetCppType(*type.Element) + ">";
+		case EASN1TypeKind::Reference:
+			return MakeIdentifier(type.Reference);
+		default:
+			throw generation_error("inline SEQUENCE, CHOICE or ENUMERATED has not been hoisted");
+		}
+	}
+
+	/// Returns "Class, Tag, bIsExplicit" template arguments of a component.
+	std::string CodeGenerator::GetTagArguments(const ASN1Type& type) const
+	{
+		if (!type.Tag.bIsPresent)
+			return "ASN1Class::UNIVERSAL, ASN1Runtime::DefaultTag";
+
+		return std::string(Private::GetClassName(type.Tag.Class)) + ", " + std::to_string(type.Tag.Number) + (type.Tag.bIsExplicit ? ", true" : "");
+	}
+
+	/// Returns "Class, Tag, Type, bIsExplicit" template arguments for Matches.
+	std::string CodeGenerator::GetMatchArguments(const ASN1Type& type) const
+	{
+		if (!type.Tag.bIsPresent)
+			return "ASN1Class::UNIVERSAL, ASN1Runtime::DefaultTag, " + GetCppType(type);
+
+		return std::string(Private::GetClassName(type.Tag.Class)) + ", " + std::to_string(type.Tag.Number) + ", " + GetCppType(type) + (type.Tag.bIsExplicit ? ", true" : "");
+	}
+
+	const ASN1Assignment* CodeGenerator::FindAssignment(const std::string& name) const
+	{
+		for (const ASN1Assignment& assignment : Module.Assignments)
+		{
+			if (assignment.Name == name)
+				return &assignment;
+		}
+
+		return nullptr;
+	}
+
+	/// Checks if the type is a CHOICE or a reference to one.
+	bool CodeGenerator::IsChoice(const ASN1Type& type) const
+	{
+		const ASN1Type* current = &type;
+
+		// references may chain, a cycle of plain references is caught later by SortAssignments
+		for (SIZE_T hops = 0; current->Kind == EASN1TypeKind::Reference && hops <= Module.Assignments.size(); ++hops)
+		{
+			const ASN1Assignment* assignment = FindAssignment(current->Reference);
+
+			if (!assignment)
+				return false;
+
+			current = assignment->Type.get();
+		}
+
+		return current->Kind == EASN1TypeKind::Choice;
+	}
+
+
+} }
@@ -0,0 +1,97 @@
+#ifndef __REAL_ASN1_CODE_GENERATOR__
+#define __REAL_ASN1_CODE_GENERATOR__
+
+#include "ModuleParser.h"
+#include <map>
+#include <sstream>
+
+
+namespace Real { namespace Tools {
+
+
+	/**
+	 * Emits a C++ header with a struct per SEQUENCE/CHOICE, an enum per ENUMERATED and a typedef per other
+	 * assignment of a parsed module. Every struct gets encode and decode functions written out field by field
+	 * on top of Codecs::ASN1Generated, so tags are template arguments and nothing is dispatched at runtime.
+	 */
+	class CodeGenerator
+	{
+	public:
+
+		/**
+		 * Thrown if the module cannot be expressed in C++ (unknown or recursive references, unsupported tags).
+		 */
+		class generation_error : public std::runtime_error
+		{
+		public:
+
+			explicit generation_error(const std::string& message)
+				: std::runtime_error(message) { }
+
+		};
+
+	public:
+
+		/**
+		 * Generates the header. Throws generation_error.
+		 *
+		 * \param module		parsed module
+		 * \param name_space	namespace of the generated code
+		 * \param include_path	path the header uses to include Codecs/ASN1_Generated.hpp
+		 *
+		 * \return header text
+		 */
+		static std::string Generate(ASN1Module module, const std::string& name_space, const std::string& include_path);
+
+		/// Turns an ASN.1 name into a C++ identifier.
+		static std::string MakeIdentifier(const std::string& name);
+
+	private:
+
+		explicit CodeGenerator(ASN1Module&& module) : Module(std::move(module)) { }
+
+		/// Moves inline SEQUENCE, CHOICE and ENUMERATED types into their own assignments.
+		void HoistInlineTypes();
+
+		/// Replaces an inline type with a reference to a new assignment named name.
+		void Hoist(std::shared_ptr<ASN1Type>& type, const std::string& name, std::vector<ASN1Assignment>& hoisted);
+
+		/// Applies the tagging mode of the module to every tag and checks tags the runtime cannot express.
+		void ResolveTags();
+
+		/// Orders assignments so that every type is defined before it is used.
+		void SortAssignments();
+
+		void EmitAssignment(const ASN1Assignment& assignment);
+
+		void EmitSequence(const std::string& name, const ASN1Type& type);
+
+		void EmitChoice(const std::string& name, const ASN1Type& type);
+
+		/// Returns C++ type of a (hoisted) type.
+		std::string GetCppType(const ASN1Type& type) const;
+
+		/// Returns "Class, Tag, bIsExplicit" template arguments of a component.
+		std::string GetTagArguments(const ASN1Type& type) const;
+
+		/// Returns "Class, Tag, Type, bIsExplicit" template arguments for Matches.
+		std::string GetMatchArguments(const ASN1Type& type) const;
+
+		const ASN1Assignment* FindAssignment(const std::string& name) const;
+
+		/// Checks if the type is a CHOICE or a reference to one.
+		bool IsChoice(const ASN1Type& type) const;
+
+	private:
+
+		ASN1Module Module;
+
+		std::ostringstream Output;
+
+	};
+
+
+} }
+
+
+#endif
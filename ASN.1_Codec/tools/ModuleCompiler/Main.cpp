@@ -0,0 +1,86 @@
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "../../src/Misc/CommandLine.h"
+#include "ModuleParser.h"
+#include "CodeGenerator.h"
+
+
+/// Returns text with instructions.
+extern const TCHAR* GetReference();
+
+
+int main(int32 argc, TCHAR** argv)
+{
+	using namespace Real;
+	using namespace Real::Tools;
+
+	CommandLine::BuildFromArgc(argc, argv);
+
+	ParsedArguments parsed = CommandLine::Parse(CommandLine::GetOriginal(), Real::EOptionType::ALL);
+
+	const auto& files = parsed.GetPositional();
+
+	const uint32 bHasNamespace = parsed.Exists("--namespace");
+	const uint32 bHasInclude = parsed.Exists("--include");
+
+	if (files.size() != 2 || parsed.Count() != 2u + bHasNamespace + bHasInclude)
+	{
+		LOG("You did not enter allowed options.\nSee reference:\n" << GetReference());
+		return 1;
+	}
+
+	std::ifstream input(files[0], std::ios::binary);
+
+	if (!input)
+	{
+		LOG("Cannot open " << files[0] << " file. Something went wrong.\n");
+		return 1;
+	}
+
+	std::stringstream text;
+	text << input.rdbuf();
+
+	std::string header;
+
+	try
+	{
+		ASN1Module module = ModuleParser::Parse(text.str());
+
+		const std::string name_space = bHasNamespace ? std::string(parsed.Get("--namespace").Get()) : CodeGenerator::MakeIdentifier(module.Name);
+		const std::string include_path = bHasInclude ? std::string(parsed.Get("--include").Get()) : std::string("Codecs/ASN1_Generated.hpp");
+
+		header = CodeGenerator::Generate(std::move(module), name_space, include_path);
+	}
+	catch (const std::exception& error)
+	{
+		LOG(files[0] << ": " << error.what());
+		return 1;
+	}
+
+	std::ofstream output(files[1], std::ios::binary);
+
+	if (!(output << header))
+	{
+		LOG("Cannot write to " << files[1] << " file. Something went wrong.\n");
+		return 1;
+	}
+
+	return 0;
+}
+
+
+const TCHAR* GetReference()
+{
+	return
+		"This tool compiles an ASN.1 module into a C++ header with encoders and decoders specialized per type.\n"
+		"Examples:\n"
+		"\"Messages.asn Messages.h\" - types of Messages.asn are generated into Messages.h\n"
+		"Options:\n"
+		"\"--namespace=Name\" - namespace of the generated code, module name by default.\n"
+		"\"--include=Path\" - path used to include Codecs/ASN1_Generated.hpp, \"Codecs/ASN1_Generated.hpp\" by default.\n"
+		"Supported: BOOLEAN, INTEGER, ENUMERATED, REAL, OCTET STRING, BIT STRING, NULL, OBJECT IDENTIFIER, SEQUENCE, SEQUENCE OF, CHOICE, OPTIONAL,\n"
+		"tags with IMPLICIT/EXPLICIT and EXPLICIT/IMPLICIT/AUTOMATIC TAGS modules. Types cannot be recursive."
+		;
+}
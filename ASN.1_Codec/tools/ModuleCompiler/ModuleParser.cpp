@@ -0,0 +1,407 @@
+#include "ModuleParser.h"
+#include <cctype>
+#include <cstdlib>
+
+
+
+namespace Real { namespace Tools {
+
+	using namespace Codecs::ASN1CodecOptions;
+
+	/**
+	 * Parses module text. Throws syntax_error.
+	 *
+	 * \param text module source
+	 *
+	 * \return parsed module
+	 */
+	ASN1Module ModuleParser::Parse(const std::string& text)
+	{
+		ModuleParser parser(Tokenize(text));
+		return parser.ParseModule();
+	}
+
+	/// Splits text into tokens skipping comments.
+	std::vector<ModuleParser::Token> ModuleParser::Tokenize(const std::string& text)
+	{
+		std::vector<Token> tokens;
+		uint32 line = 1;
+
+		for (SIZE_T i = 0; i < text.size(); )
+		{
+			const char c = text[i];
+
+			if (c == '\n')
+			{
+				++line;
+				++i;
+			}
+			else if (std::isspace(static_cast<unsigned char>(c)))
+			{
+				++i;
+			}
+			// comment runs to the end of the line or to the next "--"
+			else if (text.compare(i, 2, "--") == 0)
+			{
+				for (i += 2; i < text.size() && text[i] != '\n' && text.compare(i, 2, "--") != 0; ++i) { }
+
+				if (i < text.size() && text[i] != '\n')
+					i += 2;
+			}
+			else if (text.compare(i, 3, "::=") == 0 || text.compare(i, 3, "...") == 0)
+			{
+				tokens.push_back({ text.substr(i, 3), line });
+				i += 3;
+			}
+			else if (text.compare(i, 2, "..") == 0)
+			{
+				tokens.push_back({ "..", line });
+				i += 2;
+			}
+			else if (std::isalnum(static_cast<unsigned char>(c)) || (c == '-' && i + 1 < text.size() && std::isdigit(static_cast<unsigned char>(text[i + 1]))))
+			{
+				// identifiers may contain hyphens but cannot end with one or contain two in a row
+				SIZE_T end = i + 1;
+				while (end < text.size() && (std::isalnum(static_cast<unsigned char>(text[end])) || (text[end] == '-' && end + 1 < text.size() && std::isalnum(static_cast<unsigned char>(text[end + 1])))))
+					++end;
+
+				tokens.push_back({ text.substr(i, end - i), line });
+				i = end;
+			}
+			else
+			{
+				tokens.push_back({ std::string(1, c), line });
+				++i;
+			}
+		}
+
+		return tokens;
+	}
+
+	ASN1Module ModuleParser::ParseModule()
+	{
+		ASN1Module module;
+		module.Name = ExpectIdentifier();
+
+		// module object identifier is not needed
+		if (Peek() == "{")
+			SkipGroup("{", "}");
+
+		Expect("DEFINITIONS");
+
+		if (Accept("IMPLICIT"))
+			module.TaggingMode = EASN1TaggingMode::IMPLICIT;
+		else if (Accept("AUTOMATIC"))
+			module.TaggingMode = EASN1TaggingMode::AUTOMATIC;
+		else
+			Accept("EXPLICIT");
+
+		if (module.TaggingMode != EASN1TaggingMode::EXPLICIT || Peek() == "TAGS")
+			Expect("TAGS");
+
+		Expect("::=");
+		Expect("BEGIN");
+
+		while (!Accept("END"))
+		{
+			if (Peek() == "IMPORTS" || Peek() == "EXPORTS")
+				Fail("IMPORTS and EXPORTS are not supported");
+
+			ASN1Assignment assignment;
+			assignment.Name = ExpectIdentifier();
+
+			if (!std::isupper(static_cast<unsigned char>(assignment.Name[0])))
+				Fail("only type assignments are supported, " + assignment.Name + " is not a type reference");
+
+			Expect("::=");
+			assignment.Type = ParseType();
+
+			module.Assignments.push_back(std::move(assignment));
+		}
+
+		if (Position != Tokens.size())
+			Fail("unexpected " + Peek() + " after END");
+
+		return module;
+	}
+
+	std::shared_ptr<ASN1Type> ModuleParser::ParseType()
+	{
+		auto type = std::make_shared<ASN1Type>();
+		type->Tag = ParseTag();
+
+		if (Accept("BOOLEAN"))
+		{
+			type->Kind = EASN1TypeKind::Boolean;
+		}
+		else if (Accept("INTEGER"))
+		{
+			type->Kind = EASN1TypeKind::Integer;
+
+			// named numbers do not change the encoding
+			if (Peek() == "{")
+				SkipGroup("{", "}");
+		}
+		else if (Accept("ENUMERATED"))
+		{
+			type->Kind = EASN1TypeKind::Enumerated;
+			type->Items = ParseEnumItems();
+		}
+		else if (Accept("OCTET"))
+		{
+			Expect("STRING");
+			type->Kind = EASN1TypeKind::OctetString;
+		}
+		else if (Accept("REAL"))
+		{
+			type->Kind = EASN1TypeKind::Real;
+		}
+		else if (Accept("BIT"))
+		{
+			Expect("STRING");
+			type->Kind = EASN1TypeKind::BitString;
+
+			// named bits do not change the encoding either
+			if (Peek() == "{")
+				SkipGroup("{", "}");
+		}
+		else if (Accept("NULL"))
+		{
+			type->Kind = EASN1TypeKind::Null;
+		}
+		else if (Accept("OBJECT"))
+		{
+			Expect("IDENTIFIER");
+			type->Kind = EASN1TypeKind::ObjectIdentifier;
+		}
+		else if (Accept("CHOICE"))
+		{
+			type->Kind = EASN1TypeKind::Choice;
+			type->Components = ParseComponents(false);
+		}
+		else if (Accept("SEQUENCE"))
+		{
+			SkipConstraints();
+
+			if (Accept("OF"))
+			{
+				type->Kind = EASN1TypeKind::SequenceOf;
+				type->Element = ParseType();
+			}
+			else
+			{
+				type->Kind = EASN1TypeKind::Sequence;
+				type->Components = ParseComponents(true);
+			}
+		}
+		else if (Peek() == "SET" || Peek() == "ANY")
+		{
+			Fail(Peek() + " is not supported");
+		}
+		else
+		{
+			type->Kind = EASN1TypeKind::Reference;
+			type->Reference = ExpectIdentifier();
+
+			if (!std::isupper(static_cast<unsigned char>(type->Reference[0])))
+				Fail("type expected, got " + type->Reference);
+		}
+
+		SkipConstraints();
+		return type;
+	}
+
+	ASN1Tag ModuleParser::ParseTag()
+	{
+		ASN1Tag tag;
+
+		if (!Accept("["))
+			return tag;
+
+		tag.bIsPresent = true;
+
+		if (Accept("APPLICATION"))
+			tag.Class = EASN1ClassTagType::APPLICATION;
+		else if (Accept("PRIVATE"))
+			tag.Class = EASN1ClassTagType::PRIVATE;
+		else if (Accept("UNIVERSAL"))
+			tag.Class = EASN1ClassTagType::UNIVERSAL;
+
+		tag.Number = ExpectNumber();
+		Expect("]");
+
+		// without a keyword the module tagging mode decides, resolved by the generator
+		if (Accept("EXPLICIT"))
+			tag.bIsExplicit = tag.bHasMode = true;
+		else if (Accept("IMPLICIT"))
+			tag.bHasMode = true;
+
+		return tag;
+	}
+
+	std::vector<ASN1Component> ModuleParser::ParseComponents(bool bAllowOptional)
+	{
+		std::vector<ASN1Component> components;
+
+		Expect("{");
+
+		while (!Accept("}"))
+		{
+			if (!components.empty() || Peek() == ",")
+				Expect(",");
+
+			// extension markers do not change the encoding of known components
+			if (Accept("..."))
+				continue;
+
+			ASN1Component component;
+			component.Name = ExpectIdentifier();
+
+			if (!std::islower(static_cast<unsigned char>(component.Name[0])))
+				Fail("component name expected, got " + component.Name);
+
+			component.Type = ParseType();
+
+			if (Peek() == "DEFAULT")
+				Fail("DEFAULT is not supported, use OPTIONAL");
+
+			if (Accept("OPTIONAL"))
+			{
+				if (!bAllowOptional)
+					Fail("OPTIONAL is not allowed in CHOICE");
+
+				component.bIsOptional = true;
+			}
+
+			components.push_back(std::move(component));
+		}
+
+		if (components.empty())
+			Fail("empty component list");
+
+		return components;
+	}
+
+	std::vector<ASN1EnumItem> ModuleParser::ParseEnumItems()
+	{
+		std::vector<ASN1EnumItem> items;
+		int64 next_value = 0;
+
+		Expect("{");
+
+		while (!Accept("}"))
+		{
+			if (!items.empty() || Peek() == ",")
+				Expect(",");
+
+			if (Accept("..."))
+				continue;
+
+			ASN1EnumItem item;
+			item.Name = ExpectIdentifier();
+			item.Value = next_value;
+
+			if (Accept("("))
+			{
+				const std::string& text = Peek();
+				item.Value = std::strtoll(text.c_str(), nullptr, 10);
+
+				if (text.empty() || !(std::isdigit(static_cast<unsigned char>(text[0])) || text[0] == '-'))
+					Fail("enumeration value expected, got " + text);
+
+				++Position;
+				Expect(")");
+			}
+
+			next_value = item.Value + 1;
+			items.push_back(std::move(item));
+		}
+
+		if (items.empty())
+			Fail("empty enumeration");
+
+		return items;
+	}
+
+	/// Skips constraints in parentheses and SIZE constraints.
+	void ModuleParser::SkipConstraints()
+	{
+		for (;;)
+		{
+			if (Peek() == "(")
+				SkipGroup("(", ")");
+			else if (Peek() == "SIZE" && Peek(1) == "(")
+				++Position, SkipGroup("(", ")");
+			else
+				return;
+		}
+	}
+
+	/// Skips a balanced group starting with the open bracket at the current position.
+	void ModuleParser::SkipGroup(const std::string& open, const std::string& close)
+	{
+		Expect(open);
+
+		for (uint32 depth = 1; depth > 0; ++Position)
+		{
+			if (Position == Tokens.size())
+				Fail("missing " + close);
+
+			if (Tokens[Position].Text == open)
+				++depth;
+			else if (Tokens[Position].Text == close)
+				--depth;
+		}
+	}
+
+	const std::string& ModuleParser::Peek(uint32 offset) const
+	{
+		static const std::string end_of_text;
+
+		return (Position + offset < Tokens.size()) ? Tokens[Position + offset].Text : end_of_text;
+	}
+
+	bool ModuleParser::Accept(const std::string& text)
+	{
+		if (Peek() != text)
+			return false;
+
+		++Position;
+		return true;
+	}
+
+	void ModuleParser::Expect(const std::string& text)
+	{
+		if (!Accept(text))
+			Fail("expected " + text + ", got " + (Peek().empty() ? std::string("end of text") : Peek()));
+	}
+
+	std::string ModuleParser::ExpectIdentifier()
+	{
+		const std::string& text = Peek();
+
+		if (text.empty() || !std::isalpha(static_cast<unsigned char>(text[0])))
+			Fail("identifier expected, got " + (text.empty() ? std::string("end of text") : text));
+
+		return Tokens[Position++].Text;
+	}
+
+	uint64 ModuleParser::ExpectNumber()
+	{
+		const std::string& text = Peek();
+
+		if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0])))
+			Fail("number expected, got " + (text.empty() ? std::string("end of text") : text));
+
+		return std::strtoull(Tokens[Position++].Text.c_str(), nullptr, 10);
+	}
+
+	void ModuleParser::Fail(const std::string& message) const
+	{
+		const uint32 line = Tokens.empty() ? 1 : Tokens[(Position < Tokens.size()) ? Position : Tokens.size() - 1].Line;
+
+		throw syntax_error(line, message);
+	}
+
+
+} }
@@ -0,0 +1,204 @@
+#ifndef __REAL_ASN1_MODULE_PARSER__
+#define __REAL_ASN1_MODULE_PARSER__
+
+#include "../../src/Codecs/ASN1_Codec.h"
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace Real { namespace Tools {
+
+
+	/**
+	 * Kinds of types the module compiler understands.
+	 */
+	enum class EASN1TypeKind : uint8
+	{
+		Boolean,
+		Integer,
+		Enumerated,
+		Real,
+		OctetString,
+		BitString,
+		Null,
+		ObjectIdentifier,
+		Sequence,
+		SequenceOf,
+		Choice,
+		Reference,	///< name of another assignment of the module
+	};
+
+	/**
+	 * How tags without IMPLICIT/EXPLICIT keyword are applied.
+	 */
+	enum class EASN1TaggingMode : uint8
+	{
+		EXPLICIT,	///< default of X.680
+		IMPLICIT,
+		AUTOMATIC,	///< untagged SEQUENCE/CHOICE components get [0], [1], ... IMPLICIT tags
+	};
+
+	/// Tag written in brackets before a type
+	struct ASN1Tag
+	{
+		bool bIsPresent = false;
+
+		/// true if IMPLICIT or EXPLICIT is written after the tag
+		bool bHasMode = false;
+
+		bool bIsExplicit = false;
+
+		Codecs::ASN1CodecOptions::EASN1ClassTagType Class = Codecs::ASN1CodecOptions::EASN1ClassTagType::CONTEXT_SPECIFIC;
+
+		uint64 Number = 0;
+	};
+
+	struct ASN1Type;
+
+	/// Component of a SEQUENCE or alternative of a CHOICE
+	struct ASN1Component
+	{
+		std::string Name;
+
+		std::shared_ptr<ASN1Type> Type;
+
+		bool bIsOptional = false;
+	};
+
+	/// Enumeration item of an ENUMERATED
+	struct ASN1EnumItem
+	{
+		std::string Name;
+
+		int64 Value;
+	};
+
+	/// Parsed type. Only the members of its kind are meaningful.
+	struct ASN1Type
+	{
+		EASN1TypeKind Kind = EASN1TypeKind::Null;
+
+		ASN1Tag Tag;
+
+		/// Referenced assignment (Reference)
+		std::string Reference;
+
+		/// Components (Sequence) or alternatives (Choice)
+		std::vector<ASN1Component> Components;
+
+		/// Items (Enumerated)
+		std::vector<ASN1EnumItem> Items;
+
+		/// Element type (SequenceOf)
+		std::shared_ptr<ASN1Type> Element;
+	};
+
+	/// Type assignment: Name ::= Type
+	struct ASN1Assignment
+	{
+		std::string Name;
+
+		std::shared_ptr<ASN1Type> Type;
+	};
+
+	/// Parsed module
+	struct ASN1Module
+	{
+		std::string Name;
+
+		EASN1TaggingMode TaggingMode = EASN1TaggingMode::EXPLICIT;
+
+		std::vector<ASN1Assignment> Assignments;
+	};
+
+
+	/**
+	 * Parses a subset of ASN.1 module syntax:
+	 * BOOLEAN, INTEGER, ENUMERATED, REAL, OCTET STRING, BIT STRING, NULL, OBJECT IDENTIFIER, SEQUENCE, SEQUENCE OF, CHOICE, OPTIONAL,
+	 * type references, tags ([n], [APPLICATION n], [PRIVATE n] with IMPLICIT/EXPLICIT) and
+	 * EXPLICIT/IMPLICIT/AUTOMATIC TAGS. Constraints, named numbers and bits and extension markers are skipped.
+	 */
+	class ModuleParser
+	{
+	public:
+
+		/**
+		 * Thrown on syntax errors and unsupported constructs, the message contains the line number.
+		 */
+		class syntax_error : public std::runtime_error
+		{
+		public:
+
+			syntax_error(uint32 line, const std::string& message)
+				: std::runtime_error("line " + std::to_string(line) + ": " + message) { }
+
+		};
+
+	public:
+
+		/**
+		 * Parses module text. Throws syntax_error.
+		 *
+		 * \param text module source
+		 *
+		 * \return parsed module
+		 */
+		static ASN1Module Parse(const std::string& text);
+
+	private:
+
+		struct Token
+		{
+			std::string Text;
+
+			uint32 Line;
+		};
+
+		explicit ModuleParser(std::vector<Token>&& tokens) : Tokens(std::move(tokens)), Position(0) { }
+
+		/// Splits text into tokens skipping comments.
+		static std::vector<Token> Tokenize(const std::string& text);
+
+		ASN1Module ParseModule();
+
+		std::shared_ptr<ASN1Type> ParseType();
+
+		ASN1Tag ParseTag();
+
+		std::vector<ASN1Component> ParseComponents(bool bAllowOptional);
+
+		std::vector<ASN1EnumItem> ParseEnumItems();
+
+		/// Skips constraints in parentheses and SIZE constraints.
+		void SkipConstraints();
+
+		/// Skips a balanced group starting with the open bracket at the current position.
+		void SkipGroup(const std::string& open, const std::string& close);
+
+		const std::string& Peek(uint32 offset = 0) const;
+
+		bool Accept(const std::string& text);
+
+		void Expect(const std::string& text);
+
+		std::string ExpectIdentifier();
+
+		uint64 ExpectNumber();
+
+		[[noreturn]] void Fail(const std::string& message) const;
+
+	private:
+
+		std::vector<Token> Tokens;
+
+		uint32 Position;
+
+	};
+
+
+} }
+
+
+#endif